@@ -0,0 +1,234 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == PROGRAM scanbench.cc ==
+
+/**
+ * \file Microbenchmark of the character scanning kernels
+ * used by the text input parsers (see multovl/io/charscan.hh).
+ * Scans a BED-like text buffer with each kernel the CPU supports
+ * and prints the throughput in GB/s.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdlib>
+
+#ifdef _WIN32
+#include "wgetopt.h"
+#else
+#include <getopt.h> // Linux, MacOS
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+// -- Own headers --
+
+#include "multovl/io/charscan.hh"
+using multovl::io::Charscan;
+
+// -- Prototypes --
+
+static std::ostream& print_help(std::ostream &out);
+static std::string make_text(unsigned int megabytes);
+template <typename Scan>
+static void measure(const std::string& what, const std::string& text, 
+    unsigned int repeats, Scan scan);
+
+// -- Default values --
+
+static const unsigned int MEGABYTES = 256, REPEATS = 5;
+
+// == MAIN ==
+
+int main(int argc, char *argv[])
+{
+    extern char* optarg;
+    extern int optind;
+    signed char optch;
+    unsigned int megabytes = MEGABYTES, repeats = REPEATS;
+    
+    static const char OPTCHARS[] = "s:r:h";
+    while((optch = getopt(argc, argv, OPTCHARS)) != -1)
+    {
+        switch(optch)
+        {
+            case 's':
+                megabytes = std::max(1, std::atoi(optarg));
+                break;
+            case 'r':
+                repeats = std::max(1, std::atoi(optarg));
+                break;
+            case 'h':
+            case '?':
+                print_help(std::cout);
+                std::exit(EXIT_FAILURE);
+        }
+    }
+    
+    // scan a file if specified, synthetic BED lines otherwise
+    std::string text;
+    if (optind < argc)
+    {
+        std::ifstream inf(argv[optind], std::ios::binary);
+        if (!inf)
+        {
+            std::cerr << "! Cannot open " << argv[optind] << std::endl;
+            return EXIT_FAILURE;
+        }
+        text.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+    }
+    else
+        text = make_text(megabytes);
+    std::cout << "Scanning " << text.size() / (1024.0 * 1024.0) << " MB, best of " 
+        << repeats << " runs" << std::endl;
+    
+    // the byte-by-byte baseline doing the same work as the kernels below
+    measure("bytewise lines+tabs", text, repeats, [](const char* first, const char* last) {
+        std::size_t cnt = 0;
+        std::uint32_t tabs[6];
+        while (first < last)
+        {
+            const char* p = first;
+            while (p < last && (*p == ' ' || *p == '\t' || *p == '\n')) ++p;
+            const char* ws = p;
+            std::size_t n = 0;
+            for (; p < last && *p != '\n'; ++p)
+            {
+                if (*p == '\t')
+                {
+                    if (n < 6) tabs[n] = p - ws;
+                    ++n;
+                }
+            }
+            cnt += n;
+            first = (p == last)? last: p + 1;
+        }
+        return cnt;
+    });
+    
+    for (auto kind : {Charscan::SCALAR, Charscan::SSE2, Charscan::AVX2})
+    {
+        if (!Charscan::select(kind))
+        {
+            std::cout << Charscan::to_string(kind) << ": not supported" << std::endl;
+            continue;
+        }
+        std::string name(Charscan::to_string(kind));
+        
+        // find the newlines only
+        measure(name + " newlines", text, repeats, [](const char* first, const char* last) {
+            std::size_t cnt = 0;
+            for (const char* nl; (nl = Charscan::find(first, last, '\n')) != last; first = nl + 1)
+                ++cnt;
+            return cnt;
+        });
+        
+        // what the BED parser does: split each line and locate its first 6 fields
+        measure(name + " lines+tabs", text, repeats, [](const char* first, const char* last) {
+            std::size_t cnt = 0;
+            std::uint32_t tabs[6];
+            while (first < last)
+            {
+                const char* nl = Charscan::find(first, last, '\n');
+                const char* ws = Charscan::skip_blanks(first, nl);
+                if (ws != nl)
+                    cnt += Charscan::find_all(ws, nl, '\t', tabs, 6);
+                first = (nl == last)? last: nl + 1;
+            }
+            return cnt;
+        });
+    }
+    return EXIT_SUCCESS;
+}
+
+// -- Functions --
+
+static std::ostream& print_help(std::ostream &out)
+{
+    out << "Microbenchmark of the character scanning kernels of the text parsers" << std::endl;
+    out << "Usage: scanbench [options] [file]" << std::endl;
+    out << "The file is scanned if specified, otherwise synthetic BED lines" << std::endl;
+    out << "Options:" << std::endl;
+    out << "-s <megabytes>: size of the synthetic input, default " << MEGABYTES << std::endl;
+    out << "-r <repeats>: number of runs per kernel, default " << REPEATS << std::endl;
+    out << "-h: print this help and exit" << std::endl;
+    return out;
+}
+
+// Generates BED lines of random coordinates
+static std::string make_text(unsigned int megabytes)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned int> posdistr(1, 250000000), lendistr(1, 1000);
+    std::string text;
+    std::size_t size = std::size_t(megabytes) * 1024 * 1024;
+    text.reserve(size + 128);
+    for (unsigned int i = 0; text.size() < size; ++i)
+    {
+        unsigned int first = posdistr(rng);
+        text += "chr" + std::to_string(i % 22 + 1) + '\t' + std::to_string(first) + '\t' 
+            + std::to_string(first + lendistr(rng)) + "\tpeak" + std::to_string(i) 
+            + "\t0\t+\n";
+    }
+    return text;
+}
+
+// Runs /scan/ on /text/ /repeats/ times and prints the best throughput
+template <typename Scan>
+static void measure(const std::string& what, const std::string& text, 
+    unsigned int repeats, Scan scan)
+{
+    double best = 0.0;
+    std::size_t result = 0;
+    for (unsigned int r = 0; r < repeats; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        result = scan(text.data(), text.data() + text.size());
+        std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+        best = std::max(best, text.size() / secs.count() / 1e9);
+    }
+    std::cout << std::setw(24) << std::left << what << ": " 
+        << std::fixed << std::setprecision(2) << best << " GB/s (" << result << ")" << std::endl;
+}
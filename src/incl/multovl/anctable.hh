@@ -0,0 +1,207 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_ANCTABLE_HEADER
+#define MULTOVL_ANCTABLE_HEADER
+
+// == Header anctable.hh ==
+
+/// \file 
+/// \brief Compact table of ancestor regions.
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Boost headers --
+
+#include "boost/serialization/access.hpp"
+#include "boost/serialization/vector.hpp"
+
+// -- Own headers --
+
+#include "multovl/regrecord.hh"
+#include "multovl/strpool.hh"
+#include "multovl/ancregion.hh"
+
+// == Classes ==
+
+namespace multovl {
+
+/**
+ * An AncestorTable stores ancestor regions as compact RegRecord-s
+ * plus a table of their names, e.g. the region table of a MultiOverlap object.
+ * The names are interned, repeated names are stored only once.
+ * Copies of a table share the name pool until one of them adds a new name.
+ * The overlap detection internals work with the records directly,
+ * AncestorRegion objects are made only on request.
+ * The entries are referred to by their indices.
+ */
+class AncestorTable
+{
+public:
+    
+    /// Init to empty
+    AncestorTable(): 
+        _records(), _names(std::make_shared<StringPool>()), 
+        _storage(), _extrecs(nullptr), _extcnt(0)
+    {}
+    
+    /**
+     * Inits a table that refers to records stored elsewhere, e.g. in a memory-mapped file.
+     * The records are used in place until the table is modified, then they are copied.
+     * \param storage keeps the external records alive as long as the table needs them
+     * \param records the external records
+     * \param count the number of external records
+     * \param names the pool the name handles of the records refer to
+     */
+    AncestorTable(std::shared_ptr<const void> storage, const RegRecord* records, 
+            unsigned int count, std::shared_ptr<StringPool> names):
+        _records(), _names(std::move(names)),
+        _storage(std::move(storage)), _extrecs(records), _extcnt(count)
+    {}
+    
+    /// Init with a range of AncestorRegion objects
+    template <typename InputIter>
+    AncestorTable(InputIter from, InputIter to):
+        AncestorTable()
+    {
+        for (; from != to; ++from)
+            push_back(*from);
+    }
+    
+    /// \return the number of entries
+    unsigned int size() const { return _extrecs == nullptr? _records.size(): _extcnt; }
+    
+    /// \return /true/ if there are no entries
+    bool empty() const { return size() == 0; }
+    
+    /// Reserves space for /n/ entries
+    void reserve(unsigned int n) { own_records().reserve(n); }
+    
+    /// Removes all entries
+    void clear();
+    
+    /// Appends an ancestor region
+    void push_back(const AncestorRegion& anc)
+    {
+        push_back(anc, anc.track_id(), anc.is_shuffleable());
+    }
+    
+    /// Appends a region with a track ID
+    /// \param reg the region
+    /// \param trackid the track ID of /reg/
+    /// \param shuffleable /true/ if /reg/ may be reshuffled
+    void push_back(const BaseRegion& reg, unsigned int trackid, bool shuffleable=true);
+    
+    /// Overwrites the /i/-th entry, no range checking.
+    /// The parameters are the same as for push_back().
+    /// The old name stays in the name pool until clear() or compact_names() is called.
+    void assign(unsigned int i, const BaseRegion& reg, unsigned int trackid, bool shuffleable=true);
+    
+    /// \return a copy of the /i/-th entry as an AncestorRegion, no range checking
+    AncestorRegion operator[](unsigned int i) const;
+    
+    /// \return the record of the /i/-th entry, no range checking
+    const RegRecord& record(unsigned int i) const { return records()[i]; }
+    
+    /// \return non-const access to the record of the /i/-th entry, no range checking.
+    /// Note that the name handle of the record must not be changed.
+    RegRecord& record(unsigned int i) { return own_records()[i]; }
+    
+    /// \return the name of the /i/-th entry, no range checking
+    std::string_view name(unsigned int i) const { return (*_names)[record(i).name_id()]; }
+    
+    /// \return the records as a contiguous array of size() elements
+    const RegRecord* records() const { return _extrecs == nullptr? _records.data(): _extrecs; }
+    
+    /// \return the name pool the name handles of the records refer to
+    const StringPool& names() const { return *_names; }
+    
+    /// \return /true/ if the /i/-th entry is less than the /j/-th entry
+    /// in the sense of AncestorRegion::operator<()
+    bool less(unsigned int i, unsigned int j) const
+    {
+        int cmp = record(i).compare(record(j));
+        return cmp < 0 || (cmp == 0 && name(i) < name(j));
+    }
+    
+    /// \return /true/ if the /i/-th entry is equal to the /j/-th entry
+    /// in the sense of AncestorRegion::operator==()
+    bool equal(unsigned int i, unsigned int j) const
+    {
+        return record(i).same_fields(record(j)) && name(i) == name(j);
+    }
+    
+    /// \return the /i/-th entry formatted like AncestorRegion::to_attrstring()
+    std::string to_attrstring(unsigned int i) const;
+    
+    /// Rebuilds the name pool so that it keeps only the names of the current entries.
+    /// Tables whose entries are overwritten by assign() many times should call this
+    /// from time to time. The entries do not change, but their name handles do.
+    void compact_names();
+    
+private:
+    
+    std::vector<RegRecord>& own_records();
+    StringPool& own_names();
+    unsigned int intern_name(const std::string& name);
+    
+    std::vector<RegRecord> _records;
+    std::shared_ptr<StringPool> _names; // referred to by the records' name handles
+    std::shared_ptr<const void> _storage;   // keeps the external records alive
+    const RegRecord* _extrecs;  // the external records while the table is not modified
+    unsigned int _extcnt;
+    
+    // serialization
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & own_records() & own_names();
+    }
+    
+};  // class AncestorTable
+
+/// Table of ancestor regions, e.g. the region table of a MultiOverlap object.
+typedef AncestorTable ancregvec_t;
+
+}   // namespace multovl
+
+#endif  // MULTOVL_ANCTABLE_HEADER
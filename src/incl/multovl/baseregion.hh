@@ -100,11 +100,9 @@ class BaseRegion:
     // -- Getters --
     
     /// Returns the first coordinate.
-    virtual
     unsigned int first() const { return _first; }
     
     /// Returns the last coordinate.
-    virtual
     unsigned int last() const { return _last; }
     
     /// Returns the length
@@ -143,11 +141,8 @@ class BaseRegion:
     // -- Setters --
     
     /// Sets the coordinates. Enforces f<=l.
-    /// This method is virtual, will be overridden in `Region`
-    /// to handle optional region limit extensions.
     /// \param f The first coordinate
     /// \param l the last coordinate
-    virtual
     void set_coords(unsigned int f, unsigned int l);
     
     /// Sets the strand
@@ -79,6 +79,17 @@ class ClassicOpts : public MultovlOptbase
 	/// given as positional arguments on the command line.
 	const std::string& load_from() const { return _loadfrom; }
 	
+	/// \return the number of threads for input parsing and overlap detection, 1 by default
+	unsigned int threads() const { return _threads; }
+	
+	/// \return /true/ if the input files are sorted by chromosome and start position
+	/// and should be processed as streams.
+	bool sorted() const { return _sorted; }
+	
+	/// \return the memory budget in megabytes. If it is not 0, then the input regions
+	/// are spilled to temporary files and the chromosomes are processed one at a time.
+	unsigned int membudget() const { return _membudget; }
+	
 	/// \return a vector of input file names provided as positional arguments on the command line.
 	std::vector<std::string> input_files() const { return pos_opts(); }
 	
@@ -97,6 +108,8 @@ class ClassicOpts : public MultovlOptbase
 	
 	std::string _source, _output, _outformat,
 	    _saveto, _loadfrom;
+	unsigned int _threads, _membudget;
+	bool _sorted;
 };
 
 } // namespace multovl
@@ -42,12 +42,19 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "multovl/basepipeline.hh"
 #include "multovl/multioverlap.hh"
 #include "multovl/classicopts.hh"
+#include "multovl/io/fileio.hh"
+#include "multovl/io/outbuffer.hh"
+#include "multovl/io/spillstore.hh"
 
 // -- Standard headers --
 
+#include <functional>
 #include <map>
 #include <string>
+#include <vector>
+#include <memory>
 #include <iostream>
+#include <fstream>
 
 namespace multovl {
 
@@ -55,8 +62,12 @@ namespace multovl {
 
 /// The ClassicPipeline implements the "classic" MULTOVL pipeline.
 /// The inputs are files (text or binary),
-/// the overlap calculations are serial/single core,
+/// the overlap calculations are done chromosome by chromosome,
+/// optionally on several threads,
 /// the output goes to a GFF2-formatted text file to standard output.
+/// If the input files are sorted by chromosome and start position (--sorted),
+/// then they are merged and the overlaps are written as soon as they are found,
+/// keeping only the current "pileup" of regions in memory.
 class ClassicPipeline: public BasePipeline
 {
 public:
@@ -70,9 +81,15 @@ protected:
     
     /// Reads the input tracks from files if no --load option was specified.
     /// The file names are parsed from the command line when the constructor runs.
-    /// If the --load <archfile> option was specified, then the complete status
-    /// of the program including all input details is read from a binary archive <archfile>.
+    /// If the --load <snapfile> option was specified, then the complete status
+    /// of the program including all input details is loaded from a snapshot <snapfile>.
+    /// The snapshot is memory-mapped and its regions are used in place.
     /// In this case the input track file name arguments are ignored.
+    /// In --sorted mode the input files are only opened here.
+    /// In --membudget mode the regions are spilled to per-chromosome temporary files.
+    /// With more than one thread, the input files are read concurrently
+    /// and large text input files are split into chunks which are parsed in parallel.
+    /// The results are the same as with one thread.
     /// \return the number of tracks successfully read, 0 on error.
     virtual
     unsigned int read_input() override;
@@ -87,14 +104,20 @@ protected:
     chrom_multovl_map& cmovl() { return _cmovl; }
 
     /// Detects the overlaps.
-    /// The default implementation provided here uses 1 CPU core.
+    /// The chromosomes are processed by a pool of `opt_ptr()->threads()` threads,
+    /// largest chromosome first. The results do not depend on the number of threads.
+    /// In --sorted mode the input files are read and the results are written here.
+    /// In --membudget mode the chromosomes are read back from the temporary files 
+    /// one at a time, and their results are written before the next one is read.
     /// \return the total number of overlaps found, including solitary regions.
     virtual
     unsigned int detect_overlaps() override;
     
     /// Writes the results to standard output. Format will be decided based on the options.
-    /// If the --save <archfile> option was specified, then the complete status of the program
-    /// except the results will be serialized to a binary archive <archfile> as well.
+    /// If the --save <snapfile> option was specified, then the complete status of the program
+    /// except the results will be saved to a snapshot <snapfile> as well.
+    /// In --sorted and --membudget mode the results are already written, only the input track
+    /// information and the multiplicity statistics are added at the end.
     virtual
     bool write_output() override;
     
@@ -106,13 +129,42 @@ protected:
     
 private:
     
+    /// A track file read in --sorted mode, with its current region
+    struct SortedTrack
+    {
+        std::unique_ptr<io::FileReader> reader;
+        std::string chrom;
+        BaseRegion reg;
+        unsigned int trackid, inputidx, problemcnt;
+    };
+    
     unsigned int read_tracks();
+    unsigned int load_snapshot();
+    unsigned int detect_chrom_overlaps(MultiOverlap& movl);
+    unsigned int open_sorted_tracks();
+    bool next_sorted_region(SortedTrack& track);
+    void finish_track(const io::FileReader& reader, unsigned int problemcnt, Input& input);
+    unsigned int stream_overlaps();
+    unsigned int spill_tracks();
+    unsigned int spilled_overlaps();
+    std::ostream& output_stream();
     bool write_result(std::ostream& outf, const std::string& format);
     bool write_gff_output(std::ostream& outf);
     bool write_bed_output(std::ostream& outf);
+    void write_gff_header(std::ostream& outf);
+    void write_regions(std::ostream& outf, bool gff);
+    void write_parallel(std::ostream& outf, 
+        const std::function<io::MultiregionWriter()>& make_writer);
     void write_comments(std::ostream& outf);
+    void write_param_comments(std::ostream& outf);
+    void write_input_comments(std::ostream& outf, const MultiOverlap::Counter& counter);
     
     chrom_multovl_map _cmovl;   ///< chromosome ==> MultiOverlap map
+    std::vector<SortedTrack> _sortedtracks; ///< the input tracks in --sorted mode
+    MultiOverlap::Counter _streamcounter;   ///< multiplicity statistics in --sorted and --membudget mode
+    std::unique_ptr<io::SpillStore> _spill; ///< the spilled input regions in --membudget mode
+    std::ofstream _outfile;     ///< the output file if specified
+    std::ostream* _outp;        ///< the output stream, set up on first use
 };
 
 }   // namespace multovl
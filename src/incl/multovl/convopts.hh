@@ -0,0 +1,90 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef CONVOPTS_HEADER
+#define CONVOPTS_HEADER
+
+// == HEADER convopts.hh ==
+
+/**
+ * \file Command-line option handling for the 
+ * 'multovlconv' track conversion program
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Base class header --
+
+#include "multovl/polite.hh"
+
+// == Classes ==
+
+namespace multovl {
+
+/// Option handling for the track converter.
+class ConvOpts : public Polite
+{
+	public:
+	
+	ConvOpts();
+	
+	/// \return the name of the track file to be converted
+	const std::string& input() const { return _input; }
+	
+	/// \return the name of the binary track file to be written
+	const std::string& output() const { return _output; }
+	
+	/// \return the number of threads reading the input, 1 by default
+	unsigned int threads() const { return _threads; }
+	
+	virtual
+	std::ostream& print_help(std::ostream& out) const;
+	
+	protected:
+	
+	virtual
+	bool check_variables();
+	
+	virtual
+	std::ostream& version_info(std::ostream& out) const;
+	
+	private:
+	
+	std::string _input, _output;
+	unsigned int _threads;
+};
+
+} // namespace multovl
+
+#endif	// CONVOPTS_HEADER
@@ -46,6 +46,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // -- Standard headers --
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -86,10 +87,38 @@ public:
     virtual
     std::string read_into(std::string& chrom, BaseRegion& reg);
 
+    /// Skips the alignments on the reference sequences not in /chroms/.
+    /// If the BAM file has a standard index (.bai), then only the wanted
+    /// reference sequences are visited, one after the other via BamReader::SetRegion().
+    /// Must be called before reading.
+    /// \return /true/: this reader always skips the other chromosomes itself
+    virtual
+    bool restrict_chroms(const std::set<std::string>& chroms);
+    
+    /// Reads all alignments of the BAM file into a buffer.
+    /// The BGZF blocks are decompressed ahead of the alignment decoder
+    /// by up to /threads/ threads, see Readahead. Falls back to the
+    /// default implementation if read_into() has already been called
+    /// or if the index is used to visit only some reference sequences.
+    /// \param track the regions are appended to this buffer
+    /// \param threads the number of decompressing threads
+    /// \return the number of alignments that could not be read
+    virtual
+    unsigned int read_all(TrackBuffer& track, unsigned int threads);
+    
     ~BamReader();
     
 private:
     
+    bool next_alignment();
+    bool wanted(int32_t refid) const;
+    
+    std::string _infname;
+    bool _started;  // read_into() has been called
+    bool _indexed;  // the wanted reference sequences are visited via the index
+    bool _inregion; // an index region is being read
+    std::vector<bool> _wanted;  // per reference sequence, empty if all are wanted
+    std::vector<int> _refqueue; // the reference sequences still to be visited, last first
     BamTools::BamReader _bamreader;
     BamTools::RefVector _refs;
     BamTools::BamAlignment _albuf;  // BAM aligned region input buffer
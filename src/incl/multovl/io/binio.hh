@@ -0,0 +1,185 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_BINIO_HEADER
+#define MULTOVL_BINIO_HEADER
+
+// == HEADER binio.hh ==
+
+/** \file 
+ * \brief Reading and writing tracks in the native binary MTB format.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Boost headers --
+
+#include "boost/interprocess/mapped_region.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/trackio.hh"
+#include "multovl/strpool.hh"
+
+namespace multovl {
+namespace io {
+
+/*
+ * The MTB ("MULTOVL track, binary") file layout. All integers are little-endian.
+ * 
+ * Header, 48 bytes:
+ *     char magic[8] = "MULTOVLB", uint32 version = 1, uint32 chromosome count,
+ *     uint64 region count, uint64 offset of the chromosome index,
+ *     uint64 offset of the name dictionary, uint64 file size.
+ * Chromosome index, 56 bytes per chromosome, in the order of first appearance:
+ *     uint64 name ID, uint64 region count, uint64 offsets[5]:
+ *     the column offsets of the starts, lengths, strands and name IDs and the block end.
+ * Per-chromosome blocks, the regions in input order, one column after the other:
+ *     starts: varints of the zigzag-encoded differences to the previous start
+ *     lengths: varints of last - first
+ *     strands: 2 bits per region ('.' = 0, '+' = 1, '-' = 2), 4 regions per byte
+ *     names: varints of name IDs
+ * Name dictionary (region and chromosome names):
+ *     uint64 name count, uint64 offsets[count + 1] relative to the characters, the characters.
+ */
+
+/// BinaryReader objects read the regions of an MTB file directly from a memory map.
+/// The regions come chromosome by chromosome in the order of the chromosome index,
+/// within a chromosome in their original input order.
+class BinaryReader: public TrackReader
+{
+public:
+    
+    /// Init a BinaryReader object to read from an MTB file.
+    /// \param infname the input file name. 
+    explicit BinaryReader(const std::string& infname);
+    
+    /// Reads the next region.
+    /// \param chrom string to store the chromosome name for /reg/
+    /// \param reg the region this method tries to read into.
+    /// \return "" if all is OK, "EOF" if all regions have been read,
+    ///     or some error message.
+    virtual
+    std::string read_into(std::string& chrom, BaseRegion& reg);
+    
+    /// Reads all remaining regions into a buffer. The chromosome blocks
+    /// are decoded by up to /threads/ threads in parallel.
+    /// \param track the regions are appended to this buffer
+    /// \param threads the number of decoding threads
+    /// \return the number of regions that could not be read (always 0, 
+    ///     errors in the file are reported in errors())
+    virtual
+    unsigned int read_all(TrackBuffer& track, unsigned int threads);
+    
+private:
+    
+    // the decoding state of a chromosome block: the current positions
+    // and the ends of the starts, lengths and names columns
+    struct Cursor
+    {
+        std::string_view chrom;
+        const unsigned char *starts, *startsend, *lengths, *lengthsend,
+            *strands, *names, *namesend;
+        std::uint64_t regcnt = 0, index = 0;
+        std::int64_t prevstart = 0;
+    };
+    
+    bool open(const std::string& infname);
+    bool start_chrom(std::uint64_t chromidx, Cursor& cursor) const;
+    bool next_region(Cursor& cursor, BaseRegion& reg, std::string& namebuf) const;
+    bool name(std::uint64_t nameid, std::string_view& nm) const;
+    std::string corrupt();
+    
+    std::string _infname;
+    boost::interprocess::mapped_region _region;
+    std::string _buffer;    // file contents if it could not be mapped
+    const unsigned char *_data;
+    std::uint64_t _size, _chromcnt, _indexoff, _dictoff, _namecnt;
+    std::uint64_t _chromidx;    // the next chromosome to be read by read_into()
+    Cursor _cursor;
+    std::string _namebuf;
+    
+};  // END OF CLASS BinaryReader
+
+/// BinaryWriter objects collect regions and write them to an MTB file.
+/// The regions are encoded as they are added, the chromosome blocks
+/// are kept in memory until write() is called.
+class BinaryWriter
+{
+public:
+    
+    /// Init to empty
+    BinaryWriter();
+    
+    /// Adds a region
+    /// \param chrom the chromosome name of /reg/
+    /// \param reg the region to be stored
+    void add(std::string_view chrom, const BaseRegion& reg);
+    
+    /// \return the number of regions added so far
+    std::uint64_t size() const { return _regcnt; }
+    
+    /// Writes all regions to a file.
+    /// \param outfname the output file name
+    /// \return /true/ on success, /false/ if the file could not be written
+    bool write(const std::string& outfname) const;
+    
+private:
+    
+    // the columns of one chromosome
+    struct Block
+    {
+        std::uint64_t nameid = 0, regcnt = 0;
+        std::int64_t prevstart = 0;
+        std::string starts, lengths, strands, names;
+    };
+    
+    StringPool _chroms;     // chromosome ID ==> block index
+    std::vector<Block> _blocks;
+    StringPool _names;      // the name dictionary
+    std::uint64_t _regcnt;
+    
+};  // END OF CLASS BinaryWriter
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_BINIO_HEADER
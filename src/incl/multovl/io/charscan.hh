@@ -0,0 +1,136 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_CHARSCAN_HEADER
+#define MULTOVL_CHARSCAN_HEADER
+
+// == HEADER charscan.hh ==
+
+/** \file 
+ * \brief Fast delimiter scanning for the text input parsers.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstddef>
+#include <cstdint>
+
+namespace multovl {
+namespace io {
+
+/// The Charscan class provides the character scanning kernels of the text input path.
+/// There are scalar, SSE2 and AVX2 implementations, the widest one
+/// supported by the CPU is selected at runtime when a kernel is first invoked.
+/// Charscan::select() overrides the choice, e.g. for the benchmarks of scanbench.
+/// All methods search the character range [first, last) and never read beyond /last/.
+class Charscan
+{
+public:
+    
+    /// The kernel implementations
+    enum Kernel {
+        SCALAR = 0,
+        SSE2 = 1,
+        AVX2 = 2
+    };
+    
+    /// \return the position of the first /c/ in [first, last), or /last/ if there is none
+    static
+    const char* find(const char* first, const char* last, char c)
+    {
+        return kernels().find(first, last, c);
+    }
+    
+    /// Finds all occurrences of /c/ in [first, last) in one pass.
+    /// \param offsets the offsets of the first /maxcnt/ occurrences relative to /first/
+    /// are stored here
+    /// \param maxcnt the maximal number of offsets stored
+    /// \return the total number of occurrences, may be larger than /maxcnt/
+    static
+    std::size_t find_all(const char* first, const char* last, char c, 
+        std::uint32_t* offsets, std::size_t maxcnt)
+    {
+        return kernels().find_all(first, last, c, offsets, maxcnt);
+    }
+    
+    /// \return the position of the first character in [first, last) which is not
+    /// a blank, tab or newline, or /last/ if there is none
+    static
+    const char* skip_blanks(const char* first, const char* last)
+    {
+        return kernels().skip_blanks(first, last);
+    }
+    
+    /// \return the kernel implementation currently in use
+    static
+    Kernel kernel() { return kernels().kind; }
+    
+    /// \return /true/ if the CPU can run the kernel /kind/
+    static
+    bool supported(Kernel kind);
+    
+    /// Selects a kernel implementation, e.g. for testing or benchmarking.
+    /// Not thread-safe, do not invoke while other threads are scanning.
+    /// \return /false/ if the CPU cannot run /kind/, the selection is not changed then.
+    static
+    bool select(Kernel kind);
+    
+    /// \return the name of a kernel implementation
+    static
+    const char* to_string(Kernel kind);
+    
+private:
+    
+    struct Kernels
+    {
+        Kernel kind;
+        const char* (*find)(const char*, const char*, char);
+        std::size_t (*find_all)(const char*, const char*, char, std::uint32_t*, std::size_t);
+        const char* (*skip_blanks)(const char*, const char*);
+    };
+    
+    static
+    Kernels& kernels();
+    
+    static
+    Kernels make_kernels(Kernel kind);
+    
+};  // class Charscan
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_CHARSCAN_HEADER
@@ -63,11 +63,13 @@ public:
         GFF2 = 2,
         GFF3 = 4,   // also GTF
         GFF = 6, // GFF2 | GFF3
-        BAM = 8     // this is binary
+        BAM = 8,    // this is binary
+        MTB = 16    // the native binary track format, see binio.hh
     };
 
     /// Deduces the format from the filename extension.
     /// \param filenm the filename. The extension should be ".bed", ".gff", ".bam", ... etc.
+    ///     Gzip-compressed text files may have an additional ".gz" extension, e.g. ".bed.gz".
     /// \return one of the non-0 Fileformat::Kind constants or Fileformat::Kind::UNKNOWN
     /// if the extension did not match anything this method knows about.
     static
@@ -46,6 +46,8 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <fstream>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <map>
@@ -57,11 +59,14 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "multovl/io/fileformat.hh"
 #include "multovl/errors.hh"
 #include "multovl/baseregion.hh"
+#include "multovl/strpool.hh"
+#include "multovl/io/trackbuffer.hh"
 
 namespace multovl {
 namespace io {
 
 class TrackReader;
+class BinaryWriter;
 
 // -- Input --
 
@@ -79,14 +84,26 @@ class FileReader
     /// \param format the file format if known.
     /// By default or if UNKNOWN is specified, then the format will be deduced automatically,
     ///     see the Fileformat class for details.
+    /// \param cachedir the directory of the parsed-track cache, "" (the default) means no caching.
+    ///     If the cache holds an entry for /infname/, then the regions are read from the entry.
+    ///     Otherwise the regions are stored in a new entry when the file has been read
+    ///     completely without errors or warnings, see trackcache.hh.
     explicit FileReader(
         const std::string& infname,
-        Fileformat::Kind format = Fileformat::UNKNOWN);
+        Fileformat::Kind format = Fileformat::UNKNOWN,
+        const std::string& cachedir = "");
     
     // Non-copyable class
     FileReader(const FileReader&) = delete;
     FileReader& operator=(const FileReader&) = delete;
     
+    /// Restricts reading to the regions on the chromosomes in /chroms/.
+    /// The regions on other chromosomes are skipped silently, BAM files with an index
+    /// are not even decompressed where they hold such regions, unless they are being cached.
+    /// Must be called before reading.
+    /// \param chroms the chromosome names. An empty set means all chromosomes.
+    void restrict_chroms(const std::set<std::string>& chroms);
+    
     /// Attempts to read from the wrapped input file into a region.
     /// We keep reading the file so that the user gets all problems in one go.
     /// \param chrom string to store the chromosome name for /reg/
@@ -94,6 +111,22 @@ class FileReader
     /// \return /true/ if all went well, /false/ on errors.
     ///     For details, invoke errors() and finished().
     bool read_into(std::string& chrom, BaseRegion& reg);
+    
+    /// Attempts to read from the wrapped input file into a region
+    /// and interns the chromosome name of the region.
+    /// \param chroms the chromosome name symbol table
+    /// \param chromid the ID of the chromosome of /reg/ in /chroms/ is stored here
+    /// \param reg the region this method tries to read into.
+    /// \return /true/ if all went well, /false/ on errors, like the other read_into().
+    bool read_into(StringPool& chroms, unsigned int& chromid, BaseRegion& reg);
+
+    /// Reads all regions of the wrapped input file into a buffer.
+    /// Regions that cannot be read are skipped and reported in errors(),
+    /// the reader is finished afterwards.
+    /// \param track the regions are appended to this buffer in input order
+    /// \param threads large text files are parsed by this many threads in parallel
+    /// \return the number of regions that could not be read
+    unsigned int read_all(TrackBuffer& track, unsigned int threads = 1);
 
     /// \return true if all input has been squeezed out of the input file.
     bool finished() const { return _finished; }
@@ -106,13 +139,43 @@ class FileReader
     private:
     
     void add_error(const std::string& msg);
+    void open_cached(const std::string& infname, const std::string& cachedir);
+    void store_cached();
     
     TrackReader* _reader;   // pimpl
+    std::unique_ptr<BinaryWriter> _cache;   // collects the regions for a new cache entry
+    std::string _cacheentry;
+    std::string _chrom;     // chromosome name buffer for the interning read_into()
+    std::set<std::string> _chroms;  // the wanted chromosomes
+    bool _filter;   // /true/ if _reader does not skip the regions on other chromosomes itself
     bool _finished;
     FileReader();   // no default ctor
     
 };  // END OF CLASS FileReader
 
+/// The complete contents of a track file, see read_all_tracks()
+struct LoadedTrack
+{
+    std::unique_ptr<FileReader> reader;   ///< the reader of the file, holds the errors
+    bool opened = false;    ///< /false/ if the file could not be opened
+    TrackBuffer regions;    ///< the regions in input order
+    unsigned int problemcnt = 0;    ///< the number of regions that could not be read
+};
+
+/// Reads several track files concurrently into memory.
+/// The files are distributed among up to /threads/ threads, largest file first.
+/// If there are fewer files than threads, then large text files 
+/// are also parsed in parallel chunks, see FileReader::read_all().
+/// \param infnames the names of the track files
+/// \param threads the maximal number of threads to use
+/// \param chroms only the regions on these chromosomes are read, see FileReader::restrict_chroms()
+/// \param cachedir the directory of the parsed-track cache, "" means no caching
+/// \return the contents of the files in the order of /infnames/
+std::vector<LoadedTrack> read_all_tracks(
+    const std::vector<std::string>& infnames, unsigned int threads,
+    const std::set<std::string>& chroms = std::set<std::string>(),
+    const std::string& cachedir = "");
+
 // -- Output --
 
 // NOTE: Implement a FileWriter if you want to let the user select an output format.
@@ -0,0 +1,114 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_INFLATER_HEADER
+#define MULTOVL_INFLATER_HEADER
+
+// == HEADER inflater.hh ==
+
+/** \file 
+ * \brief Decompression of gzip- and BGZF-compressed input.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstddef>
+#include <string>
+
+struct z_stream_s;  // from zlib.h
+
+namespace multovl {
+namespace io {
+
+/// Inflater objects decompress gzip-compressed data held in memory, part by part.
+/// BGZF data (a series of gzip members of at most 64 kiB each which carry their
+/// compressed size in a "BC" extra field, as written by bgzip and used in BAM files)
+/// are decompressed block-parallel. Other gzip data, including files with
+/// several gzip members, are decompressed sequentially as a stream.
+/// Inflater objects are non-copyable.
+class Inflater
+{
+public:
+    
+    /// \return /true/ if [first, last) starts with the gzip magic bytes
+    static
+    bool is_gzip(const char* first, const char* last);
+    
+    /// Init to decompress the data in [first, last) which must stay valid
+    /// during the lifetime of the calling object.
+    Inflater(const char* first, const char* last);
+    
+    Inflater(const Inflater&) = delete;
+    Inflater& operator=(const Inflater&) = delete;
+    
+    ~Inflater();
+    
+    /// Decompresses the next part of the input.
+    /// \param out the decompressed data are appended to this string
+    /// \param size about this many bytes are appended unless the input ends.
+    ///     BGZF data are decompressed in whole blocks so that a bit more may be appended.
+    /// \param threads the maximal number of threads decompressing BGZF blocks
+    /// \return the number of bytes appended. 0 is returned only if the input has been
+    ///     exhausted or a decompression error occurred, finished() is /true/ then.
+    ///     After an error, the data decompressed before it may have been appended.
+    std::size_t inflate(std::string& out, std::size_t size, unsigned int threads = 1);
+    
+    /// \return /true/ if all input has been decompressed or an error occurred
+    bool finished() const { return _finished; }
+    
+    /// \return /true/ if the input has been recognised as BGZF data
+    bool is_bgzf() const { return _bgzf; }
+    
+    /// \return the description of the decompression error, or "" if there was none
+    const std::string& error() const { return _err; }
+    
+private:
+    
+    std::size_t inflate_bgzf(std::string& out, std::size_t size, unsigned int threads);
+    std::size_t inflate_stream(std::string& out, std::size_t size);
+    void fail(const std::string& msg);
+    
+    const unsigned char *_pos, *_end;   // the unread part of the input
+    z_stream_s* _zs;    // stream state for non-BGZF input, set up on first use
+    bool _bgzf, _finished;
+    std::string _err;
+    
+};  // END OF CLASS Inflater
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_INFLATER_HEADER
@@ -48,9 +48,9 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <string>
+#include <string_view>
 #include <map>
 #include <iostream>
-#include <stdexcept>
 
 // -- Own headers --
 
@@ -90,8 +90,9 @@ class Linereader
     ~Linereader() = default;
     
     /// Parses a line into the calling object from /line/.
+    /// The line is tokenized in place, only the fields needed are copied.
     /// \return the status of the parsing operation.
-    Status parse(const std::string& line);
+    Status parse(std::string_view line);
     
     /// Updates the contents of a region with what has been parsed.
     /// Does nothing if the calling object is not in the DATA state.
@@ -122,18 +123,6 @@ class Linereader
 
     protected:
     
-    /// Linereader's own exception
-    class Exception: public std::logic_error
-    {
-        public:
-        
-        /// Create a parser exception.
-        /// \param from indicates where the error occurred (ie. which method)
-        /// \param problem description of what went wrong
-        Exception(const std::string& from, const std::string& problem):
-            logic_error("\"" + from + "\": " + problem) {}
-    };
-    
     /// Prepares the calling object for parsing by resetting all fields.
     /// This method must be invoked by the parse(...) method.
     virtual
@@ -147,21 +136,30 @@ class Linereader
     }
     
     /// Returns /true/ if /str/ is empty or contains whitespace characters only.
-    static bool empty_white(const std::string& str);
+    static bool empty_white(std::string_view str);
     
     /// Returns offset of a comment after "^[[:space:]]*#[[:space:]]"
-    /// or std::string::npos if /line/ is not a comment
-    static std::string::size_type parse_comment(const std::string& line);
+    /// or std::string_view::npos if /line/ is not a comment
+    static std::string_view::size_type parse_comment(std::string_view line);
 
     /// Parse a /line/ assuming it contains coordinate data.
     /// Implementations must set _status bits (ERROR and DATA) accordingly.
     virtual
-    void parse_data(const std::string& line) = 0;
+    void parse_data(std::string_view line) = 0;
     
-    /// Converts /str/ to an unsigned int
-    /// generates meaningful error messages via Linereader::Exception
+    /// Splits /line/ on tabs into at most /maxcnt/ fields.
+    /// \param fields the first /maxcnt/ (but at most MAXFIELDS) fields 
+    /// are stored here as views into /line/
+    /// \return the total number of fields in /line/
     static
-    unsigned int str_to_uint(std::string& str);
+    std::size_t split_fields(std::string_view line, std::string_view* fields, std::size_t maxcnt);
+    
+    /// Converts /str/ to an unsigned int.
+    /// If this is not possible, then a meaningful error message is stored in _err
+    /// and the ERROR status flag is set.
+    /// \param value the result is stored here
+    /// \return /true/ on success.
+    bool str_to_uint(std::string_view str, unsigned int& value);
     
     // these data members can be set during parsing by the derived classes
     // they are protected for simplicity's sake
@@ -175,9 +173,11 @@ class Linereader
     unsigned int _first, _last;
     char _strand;
     
+    /// The maximal number of fields split_fields() can store
+    static const std::size_t MAXFIELDS = 16;
+    
     private:
     
-    static const char WHITESPACE[];
     static const char COMCH = '#';
 };
 
@@ -207,7 +207,7 @@ class BedLinereader: public Linereader
     
     /// Parse a /line/ assuming it contains BED-formatted data.
     virtual
-    void parse_data(const std::string& line) override;
+    void parse_data(std::string_view line) override;
     
 };
 
@@ -231,7 +231,7 @@ class GffLinereader: public BedLinereader
     
     /// Parse a /line/ assuming it contains GFF-formatted data.
     virtual
-    void parse_data(const std::string& line) override;
+    void parse_data(std::string_view line) override;
 };
 
 }   // namespace io
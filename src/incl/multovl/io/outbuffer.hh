@@ -0,0 +1,187 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_OUTBUFFER_HEADER
+#define MULTOVL_OUTBUFFER_HEADER
+
+// == HEADER outbuffer.hh ==
+
+/** \file 
+ * \brief Buffered text output of the overlaps.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Own headers --
+
+#include "multovl/multiregion.hh"
+
+namespace multovl {
+namespace io {
+
+/// An OutputBuffer collects text in a large reusable byte array.
+/// If it is connected to an output stream, then the contents are written
+/// to the stream in large blocks whenever the buffer becomes full,
+/// otherwise the buffer grows as needed.
+/// Note that the destructor does not flush: call flush() explicitly.
+/// The class is movable but non-copyable.
+class OutputBuffer
+{
+public:
+    
+    /// The default capacity in bytes
+    static const std::size_t DEFAULT_CAPACITY = 4 << 20;
+    
+    /// Init to empty
+    /// \param out the stream the contents are written to, none if nullptr (the default)
+    /// \param capacity the initial capacity of the buffer in bytes
+    explicit OutputBuffer(std::ostream* out = nullptr, std::size_t capacity = DEFAULT_CAPACITY);
+    
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    OutputBuffer(OutputBuffer&&) = default;
+    OutputBuffer& operator=(OutputBuffer&&) = default;
+    
+    /// Appends a character
+    void put(char c)
+    {
+        if (_len == _cap) make_room(1);
+        _buf[_len++] = c;
+    }
+    
+    /// Appends a string
+    void put(std::string_view str)
+    {
+        if (_len + str.size() > _cap) make_room(str.size());
+        str.copy(_buf.get() + _len, str.size());
+        _len += str.size();
+    }
+    
+    /// Appends the decimal representation of an unsigned integer
+    void put(unsigned int n)
+    {
+        const std::size_t MAXDIGITS = 10;
+        if (_len + MAXDIGITS > _cap) make_room(MAXDIGITS);
+        char* end = std::to_chars(_buf.get() + _len, _buf.get() + _cap, n).ptr;
+        _len = end - _buf.get();
+    }
+    
+    /// \return the contents not written yet (not zero-terminated)
+    const char* data() const { return _buf.get(); }
+    
+    /// \return the number of bytes not written yet
+    std::size_t size() const { return _len; }
+    
+    /// Writes the contents to the output stream, if any, and empties the buffer.
+    /// Stream exceptions are passed on to the caller.
+    void flush();
+    
+    /// Empties the buffer without writing it
+    void clear() { _len = 0; }
+    
+private:
+    
+    void make_room(std::size_t n);
+    
+    std::ostream* _out;
+    std::unique_ptr<char[]> _buf;
+    std::size_t _cap, _len;
+};
+
+/// A MultiregionWriter formats multiregions into an OutputBuffer
+/// the same way as the BedLinewriter and GffLinewriter classes do,
+/// but without creating temporary strings.
+/// The attribute fragments of the ancestors can be formatted once and cached
+/// as long as the multiregions come from the same ancestor pool.
+/// This must be switched off if the pool may change between two write() calls,
+/// e.g. when the multiregions come from a StreamOverlap object.
+class MultiregionWriter
+{
+public:
+    
+    /// Sets up a BED writer
+    /// \param cache if /true/ (the default), then the ancestor fragments are cached
+    explicit MultiregionWriter(bool cache = true);
+    
+    /// Sets up a GFF writer
+    /// \param source this gets written in Column 2
+    /// \param version GFF version (2 or 3, clamped silently)
+    /// \param cache if /true/ (the default), then the ancestor fragments are cached
+    MultiregionWriter(const std::string& source, unsigned int version, bool cache = true);
+    
+    /// Sets the chromosome name of the multiregions to be written
+    void chrom(const std::string& chrom) { _chrom = chrom; }
+    
+    /// Writes a MultiRegion as a line (with a newline) into a buffer.
+    /// \param reg the MultiRegion to be written
+    /// \param buf the buffer the line is appended to
+    void write(const MultiRegion& reg, OutputBuffer& buf);
+    
+    /// Drops the cached ancestor fragments and releases the ancestor pool they belong to
+    void reset_cache();
+    
+private:
+    
+    // position of a formatted ancestor fragment in _frags, length 0 if not formatted yet
+    struct Fragment
+    {
+        std::uint64_t offset;
+        std::uint32_t length;
+    };
+    
+    void write_ancestors(const MultiRegion& reg, OutputBuffer& buf);
+    void write_fragment(const ancregvec_t& pool, unsigned int i, OutputBuffer& buf);
+    
+    std::string _chrom, _source;
+    bool _gff, _cache;
+    char _sep;  // ' ' for GFF version 2, '=' for version 3
+    ancregpool_t _pool;    // the pool the fragments belong to
+    std::vector<Fragment> _fragpos;
+    OutputBuffer _frags;
+};
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_OUTBUFFER_HEADER
@@ -0,0 +1,123 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_READAHEAD_HEADER
+#define MULTOVL_READAHEAD_HEADER
+
+// == HEADER readahead.hh ==
+
+/** \file 
+ * \brief Decompression of gzip- and BGZF-compressed input ahead of its consumer.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -- Own headers --
+
+#include "multovl/io/inflater.hh"
+
+namespace multovl {
+namespace io {
+
+/// Readahead objects decompress gzip-compressed data held in memory on a background thread
+/// while the client consumes the data decompressed so far through read().
+/// The decompressed parts are passed on through a ring of buffers so that decompression
+/// runs at most a few parts ahead. BGZF blocks within a part are decompressed in parallel,
+/// see Inflater. Readahead objects are non-copyable.
+class Readahead
+{
+public:
+    
+    /// Init and start decompressing the data in [first, last) which must stay valid
+    /// during the lifetime of the calling object.
+    /// \param threads the maximal number of threads decompressing BGZF blocks
+    /// \param partsize the approximate size of the decompressed parts
+    /// \param depth the number of parts that may be decompressed ahead (at least 2)
+    Readahead(const char* first, const char* last, unsigned int threads,
+        std::size_t partsize = PARTSIZE, unsigned int depth = 4);
+    
+    Readahead(const Readahead&) = delete;
+    Readahead& operator=(const Readahead&) = delete;
+    
+    /// Stops decompressing and waits for the background thread to finish.
+    ~Readahead();
+    
+    /// Copies the next /len/ decompressed bytes to /dest/, waits if necessary.
+    /// \return the number of bytes copied which is less than /len/ only
+    ///     if the input has been exhausted or a decompression error occurred.
+    std::size_t read(char* dest, std::size_t len);
+    
+    /// \return the description of the decompression error, or "" if there was none.
+    ///     Meaningful only after read() returned less than requested.
+    const std::string& error() const { return _inflater.error(); }
+    
+    static constexpr std::size_t PARTSIZE = 1024 * 1024;
+    
+private:
+    
+    void produce();
+    bool next_part();
+    
+    Inflater _inflater;
+    unsigned int _threads;
+    std::size_t _partsize;
+    
+    // ring of decompressed parts: _count parts are ready starting at _head
+    std::vector<std::string> _parts;
+    std::size_t _head, _count;
+    bool _done, _stop;
+    std::mutex _mutex;
+    std::condition_variable _ready, _free;
+    
+    // the consumer's position within the part at _head
+    const std::string* _curr;
+    std::size_t _off;
+    
+    std::thread _producer;  // must be the last member, it starts in the ctor
+    
+};  // END OF CLASS Readahead
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_READAHEAD_HEADER
@@ -0,0 +1,183 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_SNAPSHOT_HEADER
+#define MULTOVL_SNAPSHOT_HEADER
+
+// == HEADER snapshot.hh ==
+
+/** \file 
+ * \brief Session snapshots that can be used in place from a memory map.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Own headers --
+
+#include "multovl/anctable.hh"
+
+namespace multovl {
+namespace io {
+
+/*
+ * The snapshot file layout. All integers are in the byte order of the writing machine
+ * so that the region arrays can be used without conversion. Everything is 8-byte aligned.
+ * 
+ * Header, 56 bytes:
+ *     char magic[8] = "MULTOVLS", uint32 version = 1, uint32 byte order mark = 0x01020304,
+ *     uint32 input count, uint32 chromosome count, uint64 region count,
+ *     uint64 offset of the chromosome table, uint64 offset of the string table, uint64 file size.
+ * Input table, 16 bytes per input track, right after the header:
+ *     uint32 name string ID, uint32 track ID, uint32 region count, uint32 0.
+ * Chromosome table, 24 bytes per chromosome:
+ *     uint32 name string ID, uint32 region count, 
+ *     uint32 string ID of the first region name, uint32 region name count,
+ *     uint64 offset of the region array.
+ * Region arrays, one per chromosome: the RegRecord-s of the chromosome's AncestorTable.
+ *     Their name handles are relative to the first region name of the chromosome.
+ * String table (input, chromosome and region names):
+ *     uint64 string count, uint64 offsets[count + 1] relative to the characters, the characters.
+ */
+
+/// SnapshotReader objects map a snapshot file into memory.
+/// The region tables they provide refer to the mapped data directly,
+/// so that loading does not depend on the size of the session
+/// and processes loading the same snapshot share the page cache.
+class SnapshotReader
+{
+public:
+    
+    /// The description of an input track
+    struct Input
+    {
+        std::string_view name;
+        unsigned int trackid, regcnt;
+    };
+    
+    /// Init a SnapshotReader object to read from a snapshot file.
+    /// Check error() to see whether the file could be opened.
+    /// \param infname the input file name
+    explicit SnapshotReader(const std::string& infname);
+    
+    /// \return the description of the problem with the file, or "" if there was none.
+    /// Note that the region records are not checked one by one.
+    const std::string& error() const { return _error; }
+    
+    /// \return the number of input tracks
+    unsigned int input_count() const { return _inputcnt; }
+    
+    /// \return the description of the /i/-th input track, no range checking
+    Input input(unsigned int i) const;
+    
+    /// \return the number of chromosomes
+    unsigned int chrom_count() const { return _chromcnt; }
+    
+    /// \return the name of the /i/-th chromosome, no range checking
+    std::string_view chrom(unsigned int i) const;
+    
+    /// \return the regions of the /i/-th chromosome, no range checking.
+    /// The table refers to the mapped file, which stays mapped as long as it is needed
+    /// even if the SnapshotReader object is destroyed.
+    AncestorTable regions(unsigned int i) const;
+    
+private:
+    
+    bool open(const std::string& infname);
+    bool check_tables();
+    std::uint32_t get32(std::uint64_t offset) const;
+    std::uint64_t get64(std::uint64_t offset) const;
+    std::string_view string(std::uint64_t id) const;
+    
+    std::shared_ptr<const void> _storage;   // the memory map or the file contents
+    const unsigned char *_data;
+    std::uint64_t _size, _chromoff, _stroff, _strcnt;
+    unsigned int _inputcnt, _chromcnt;
+    const std::uint64_t* _stroffs;  // the offsets of the string table
+    const char* _chars;     // the characters of the string table
+    std::string _error;
+    
+};  // END OF CLASS SnapshotReader
+
+/// SnapshotWriter objects collect the input track descriptions
+/// and the region tables of a session and write them to a snapshot file.
+class SnapshotWriter
+{
+public:
+    
+    /// Init to empty
+    SnapshotWriter();
+    
+    /// Adds the description of an input track
+    void add_input(std::string_view name, unsigned int trackid, unsigned int regcnt);
+    
+    /// Adds the regions of a chromosome.
+    /// \param chrom the chromosome name
+    /// \param regions the region table, it is not copied and must exist until write() is called
+    void add_chrom(std::string_view chrom, const AncestorTable& regions);
+    
+    /// Writes the snapshot to a file.
+    /// \param outfname the output file name
+    /// \return /true/ on success, /false/ if the file could not be written
+    bool write(const std::string& outfname) const;
+    
+private:
+    
+    struct Input
+    {
+        unsigned int nameid, trackid, regcnt;
+    };
+    struct Chrom
+    {
+        unsigned int nameid;
+        const AncestorTable* regions;
+    };
+    
+    std::vector<std::string> _strings;  // input and chromosome names
+    std::vector<Input> _inputs;
+    std::vector<Chrom> _chroms;
+    
+};  // END OF CLASS SnapshotWriter
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_SNAPSHOT_HEADER
@@ -0,0 +1,164 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_SPILLSTORE_HEADER
+#define MULTOVL_SPILLSTORE_HEADER
+
+// == HEADER spillstore.hh ==
+
+/** \file 
+ * \brief Temporary per-chromosome region files for inputs larger than the memory.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Own headers --
+
+#include "multovl/baseregion.hh"
+
+namespace multovl {
+namespace io {
+
+/// A SpillStore collects the regions of several tracks in one temporary file per chromosome.
+/// The regions are buffered in memory, and the buffers are appended to the files
+/// whenever they grow larger than the memory budget.
+/// The regions of a chromosome can then be read back in the order of addition,
+/// or sorted by their first positions using an external merge sort within the budget.
+/// The temporary files are removed when the object is destroyed. 
+/// The class is non-copyable.
+class SpillStore
+{
+public:
+    
+    /// The type of the callables the regions are passed to when they are read back,
+    /// invoked as /sink(reg, trackid)/
+    typedef std::function<void(const BaseRegion&, unsigned int)> sink_t;
+    
+    /// Init to empty
+    /// \param budget the number of bytes the buffers and the sorting may use
+    /// \param tmpdir the temporary files are created in a new directory under /tmpdir/,
+    ///     by default under the system's temporary directory
+    explicit SpillStore(std::size_t budget, const std::string& tmpdir = "");
+    
+    // Non-copyable class
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+    
+    ~SpillStore();
+    
+    /// Adds a region
+    /// \param chrom the chromosome name of /reg/
+    /// \param reg the region to be stored
+    /// \param trackid the track ID of /reg/
+    /// \return /true/ on success, /false/ if the buffers could not be written, see error()
+    bool add(std::string_view chrom, const BaseRegion& reg, unsigned int trackid);
+    
+    /// Writes all buffered regions to the files.
+    /// \return /true/ on success, /false/ if the buffers could not be written, see error()
+    bool flush();
+    
+    /// \return the names of the chromosomes seen so far in ascending order
+    std::vector<std::string> chroms() const;
+    
+    /// \return the number of regions stored for /chrom/
+    std::uint64_t region_count(const std::string& chrom) const;
+    
+    /// \return the number of bytes the regions stored for /chrom/ take up
+    std::uint64_t byte_count(const std::string& chrom) const;
+    
+    /// Reads back the regions of a chromosome in the order they were added.
+    /// Must be called after flush().
+    /// \param chrom the chromosome name
+    /// \param sink the regions are passed to this callable one by one
+    /// \return /true/ on success, /false/ on error, see error()
+    bool read(const std::string& chrom, const sink_t& sink);
+    
+    /// Reads back the regions of a chromosome sorted by their first positions.
+    /// Regions with the same first position come in the order they were added.
+    /// If they do not fit into the budget, then sorted runs are written 
+    /// to temporary files and merged. Must be called after flush().
+    /// \param chrom the chromosome name
+    /// \param sink the regions are passed to this callable one by one
+    /// \return /true/ on success, /false/ on error, see error()
+    bool read_sorted(const std::string& chrom, const sink_t& sink);
+    
+    /// Removes the file of a chromosome, its regions cannot be read afterwards.
+    void release(const std::string& chrom);
+    
+    /// \return the description of the last error, "" if there was none
+    const std::string& error() const { return _error; }
+    
+private:
+    
+    // the regions of a chromosome: the file and the regions not yet written to it
+    struct Chrom
+    {
+        std::filesystem::path path;
+        std::string buffer;
+        std::uint64_t regcnt = 0, bytecnt = 0;
+    };
+    
+    // sorting key of a region record in a chunk
+    struct SortKey
+    {
+        unsigned int first;
+        std::size_t offset;
+    };
+    
+    bool fail(const std::string& msg);
+    bool read_chunk(std::ifstream& in, std::string& chunk, 
+        std::vector<SortKey>& keys, std::size_t limit);
+    
+    std::size_t _budget, _buffered;
+    std::filesystem::path _dir;
+    std::map<std::string, Chrom, std::less<>> _chroms;
+    std::string _error;
+    
+};  // END OF CLASS SpillStore
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_SPILLSTORE_HEADER
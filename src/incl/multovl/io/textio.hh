@@ -45,9 +45,16 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // -- Standard headers --
 
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+// -- Boost headers --
+
+#include "boost/interprocess/mapped_region.hpp"
+
 // -- Library headers --
 
 #include "multovl/io/trackio.hh"
@@ -57,10 +64,14 @@ namespace multovl {
 namespace io {
 
 class Linereader;
+class Inflater;
 
-/// TextReader objects encapsulate an input stream from which they can read
+/// TextReader objects encapsulate an input file from which they can read
 /// into a Reader object, one by one. TextReader-s are init-ed with a file name,
-/// the ctor opens the file for writing and the dtor closes it, RAII-style.
+/// the ctor maps the file into memory and the dtor unmaps it, RAII-style.
+/// The lines are scanned and parsed in place, without copying.
+/// Gzip- or BGZF-compressed files are recognised by their contents
+/// and decompressed part by part into an internal buffer while reading.
 /// Clients should instantiate a TextReader, then invoke its read_into() method,
 /// and use the resulting Region immediately for building up a MultiOverlap object.
 class TextReader: public TrackReader
@@ -74,8 +85,8 @@ public:
         const std::string& infname,
         Fileformat::Kind format);
     
-    /// Attempts to read from the wrapped input stream into a region.
-    /// Reads the stream internally line-by-line, parses each line
+    /// Attempts to read from the wrapped input file into a region.
+    /// Reads the file internally line-by-line, parses each line
     /// until a valid data line is found with which /reg/ is then updated.
     /// Comment and metainfo lines are ignored.
     /// \param chrom string to store the chromosome name for /reg/
@@ -86,6 +97,18 @@ public:
     virtual
     std::string read_into(std::string& chrom, BaseRegion& reg);
 
+    /// Reads all remaining regions of the input file into a buffer.
+    /// Large files are split into line-aligned chunks that are parsed
+    /// by up to /threads/ threads in parallel, the chunks are joined in input order.
+    /// Compressed files are decompressed and parsed in large batches,
+    /// BGZF blocks are decompressed by up to /threads/ threads as well.
+    /// The errors are reported with the correct line numbers, as with read_into().
+    /// \param track the regions are appended to this buffer
+    /// \param threads the maximal number of parsing threads
+    /// \return the number of lines that could not be parsed
+    virtual
+    unsigned int read_all(TrackBuffer& track, unsigned int threads);
+
     virtual
     ~TextReader();
     
@@ -95,13 +118,39 @@ public:
     
 private:
     
+    // The results of parsing a chunk of the input file
+    struct Chunk
+    {
+        TrackBuffer regions;
+        std::vector<std::pair<unsigned int, std::string>> errors;   // line number in chunk, message
+        unsigned int linecount = 0;
+    };
+    
     bool is_valid() const { return _valid; }
-
+    
+    Linereader* make_linereader() const;
+    bool open(const std::string& infname);
+    bool read_line(std::string_view& line);
+    bool refill(std::size_t size, unsigned int threads);
+    unsigned int parse_lines(const char* last, TrackBuffer& track, unsigned int threads);
+    void parse_chunk(const char* pos, const char* end, Chunk& chunk) const;
+    static
+    bool next_line(const char*& pos, const char* end, std::string_view& line);
+
+    // chunks smaller than this are not worth a thread of their own
+    static constexpr std::size_t MINCHUNK = 4 * 1024 * 1024;
+    // compressed input is decompressed in parts of about this size
+    static constexpr std::size_t BATCHSIZE = 16 * 1024 * 1024;
+    
+    Fileformat::Kind _format;
     Linereader* _lrp;   // can be BedLinereader or GffLinereader
-    std::ifstream _inf; // input file stream
-    std::string _line;  // input buffer
+    boost::interprocess::mapped_region _region; // the mapped input file
+    std::string _buffer;    // the input file contents if it cannot be mapped
+    std::unique_ptr<Inflater> _inflater;    // decompresses compressed input
+    std::string _text;      // the decompressed part of compressed input
+    const char *_pos, *_end;    // the unread part of the input
     unsigned int _linecount;
-    bool _valid;
+    bool _valid, _inflateerr;
     
 };  // END OF CLASS TextReader
 
@@ -0,0 +1,140 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_TRACKBUFFER_HEADER
+#define MULTOVL_TRACKBUFFER_HEADER
+
+// == HEADER trackbuffer.hh ==
+
+/** \file 
+ * \brief In-memory buffer holding all regions of a track.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// -- Own headers --
+
+#include "multovl/baseregion.hh"
+#include "multovl/strpool.hh"
+
+namespace multovl {
+namespace io {
+
+/// A TrackBuffer stores the regions of a track together with their chromosome names
+/// in compact records, in the order they were added.
+/// Buffers filled independently (e.g. from different parts of a file by different threads)
+/// can be joined with append(), the regions of the appended buffer come after those
+/// of the calling object. Buffers are movable but not copyable.
+class TrackBuffer
+{
+public:
+    
+    /// Init to empty
+    TrackBuffer(): _parts{} {}
+    
+    TrackBuffer(const TrackBuffer&) = delete;
+    TrackBuffer& operator=(const TrackBuffer&) = delete;
+    TrackBuffer(TrackBuffer&&) = default;
+    TrackBuffer& operator=(TrackBuffer&&) = default;
+    
+    /// Adds a region to the end of the buffer.
+    /// \param chrom the chromosome name of /reg/
+    /// \param reg the region to be stored
+    void add(std::string_view chrom, const BaseRegion& reg);
+    
+    /// Moves the contents of /other/ to the end of the calling object.
+    /// /other/ will be empty afterwards.
+    void append(TrackBuffer&& other);
+    
+    /// \return the number of regions stored
+    std::size_t size() const;
+    
+    /// \return /true/ if there are no regions in the buffer
+    bool empty() const { return size() == 0; }
+    
+    /// Invokes /fn(chrom, reg)/ on all regions in the order they were added.
+    /// /chrom/ is a std::string_view, /reg/ a const BaseRegion reference,
+    /// both are valid only during the call.
+    template <typename Fn>
+    void for_each(Fn fn) const
+    {
+        BaseRegion reg;
+        std::string name;
+        for (const auto& part : _parts) {
+            for (const auto& rec : part.records) {
+                reg.set_coords(rec.first, rec.last);
+                reg.strand(rec.strand);
+                name.assign(part.names, rec.nameoff, rec.namelen);
+                reg.name(name);
+                fn(part.chroms[rec.chromid], static_cast<const BaseRegion&>(reg));
+            }
+        }
+    }
+    
+    /// Releases all regions
+    void clear() { _parts.clear(); }
+    
+private:
+    
+    // one region, the name is stored in the names buffer of its Part
+    struct Record
+    {
+        unsigned int first, last;
+        std::size_t nameoff;
+        unsigned int namelen, chromid;
+        char strand;
+    };
+    
+    // a stretch of regions filled by add(), append() concatenates these
+    struct Part
+    {
+        StringPool chroms;
+        std::vector<Record> records;
+        std::string names;
+    };
+    
+    std::vector<Part> _parts;
+    
+};  // END OF CLASS TrackBuffer
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_TRACKBUFFER_HEADER
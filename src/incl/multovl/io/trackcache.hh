@@ -0,0 +1,84 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_TRACKCACHE_HEADER
+#define MULTOVL_TRACKCACHE_HEADER
+
+// == HEADER trackcache.hh ==
+
+/** \file 
+ * \brief The cache of parsed track files.
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <string>
+
+namespace multovl {
+namespace io {
+
+class BinaryWriter;
+
+/*
+ * The track cache is a directory of MTB files, one for each track file that has been
+ * read completely and without problems. The entry of a track file is named after
+ * a hash of its canonical path, size, modification time and contents,
+ * so that an entry is never used for a file that changed after it was cached.
+ * Entries of changed files are not removed, the directory can be emptied any time.
+ */
+
+/// \return the hash of the contents of a file, 0 if it cannot be read
+std::uint64_t content_hash(const std::string& fname);
+
+/// Finds the cache entry of a track file.
+/// \param cachedir the cache directory
+/// \param infname the track file name
+/// \return the name of the entry of /infname/ in /cachedir/, whether it exists or not,
+///     or "" if /infname/ cannot be cached (e.g. it does not exist)
+std::string cache_entry(const std::string& cachedir, const std::string& infname);
+
+/// Stores a cache entry. The entry appears at once and complete 
+/// so that concurrent readers never see a partial file.
+/// \param regions the regions of the track file
+/// \param entry the name of the entry, see cache_entry()
+/// \return /true/ on success
+bool store_cache_entry(const BinaryWriter& regions, const std::string& entry);
+
+}   // namespace io
+}   // namespace multovl
+
+#endif  // MULTOVL_TRACKCACHE_HEADER
@@ -46,6 +46,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <fstream>
+#include <set>
 #include <string>
 
 // -- Boost headers --
@@ -54,6 +55,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "multovl/baseregion.hh"
 #include "multovl/errors.hh"
+#include "multovl/io/trackbuffer.hh"
 
 namespace multovl {
 namespace io {
@@ -83,6 +85,40 @@ public:
     virtual
     std::string read_into(std::string& chrom, BaseRegion& reg) = 0;
 
+    /// Reads all remaining regions of the wrapped input file into a buffer.
+    /// Regions that cannot be read are skipped, the problems are recorded
+    /// in the same way as by read_into().
+    /// This default implementation calls read_into() repeatedly
+    /// and ignores /threads/. The reader must be in a valid state.
+    /// \param track the regions are appended to this buffer
+    /// \param threads the number of threads the implementation may use
+    /// \return the number of regions that could not be read
+    virtual
+    unsigned int read_all(TrackBuffer& track, unsigned int /* threads */)
+    {
+        std::string chrom;
+        BaseRegion reg;
+        unsigned int problemcnt = 0;
+        while (true)
+        {
+            std::string msg = read_into(chrom, reg);
+            if (msg == "EOF")
+                break;
+            if (msg != "")
+                ++problemcnt;
+            else
+                track.add(chrom, reg);
+        }
+        return problemcnt;
+    }
+
+    /// Tells the reader that only the regions on the chromosomes in /chroms/ are needed.
+    /// Readers which can skip the other regions cheaply (e.g. by using an index) do so.
+    /// Must be called before reading. This default implementation does nothing.
+    /// \return /true/ if the reader skips the regions on the other chromosomes itself
+    virtual
+    bool restrict_chroms(const std::set<std::string>& /* chroms */) { return false; }
+    
     /// \return const access to the internal error collecting object.
     const Errors& errors() const { return _errors; }
     
@@ -47,10 +47,14 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
 
 // -- Boost headers --
 
@@ -60,7 +64,9 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Own headers --
 
 #include "multovl/reglimit.hh"
+#include "multovl/regevent.hh"
 #include "multovl/multiregion.hh"
+#include "multovl/sweep.hh"
 
 // == Classes ==
 
@@ -81,7 +87,7 @@ public:
     public:
         
         /// Default ctor
-        Counter(): _histo(), _total(0) {}
+        Counter(): _histo(), _widehisto(), _total(0) {}
         
         /// Count update based on the ancestor IDs in /mr/
         void count(const MultiRegion& mr);
@@ -96,35 +102,72 @@ public:
         /// The format is either "(empty)" or
         /// "id1,id2,...,idN:count1 id1,id2,...,idM:count2 ..."
         /// where "id1,id2,...idN" are the track IDs (uints).
+        /// The entries are sorted lexicographically by their "id1,id2,..." keys.
         std::string to_string() const;
         
     private:
         
+        // The track combinations are stored as bitsets where bit N is set
+        // if track N contributed to the overlap. Track IDs below 64 fit into one word,
+        // combinations with larger track IDs go to a separate table with multiword keys.
+        typedef std::vector<std::uint64_t> widekey_t;
+        
+        struct WideKeyHash
+        {
+            std::size_t operator()(const widekey_t& key) const;
+        };
+        
         static
-        std::string get_key(
-            const std::vector<int>::const_iterator& from,
-            const std::vector<int>::const_iterator& to
-        );
+        std::string key_str(const std::uint64_t* words, std::size_t wordcnt);
         
-        typedef std::map<std::string, unsigned int> histo_t;
+        typedef std::unordered_map<std::uint64_t, unsigned int> histo_t;
+        typedef std::unordered_map<widekey_t, unsigned int, WideKeyHash> widehisto_t;
         histo_t _histo;
+        widehisto_t _widehisto;
         unsigned int _total;
         
     };  // class Counter
     
-    typedef std::multiset<RegLimit> reglimset_t;
+    /// The overlap detection algorithms ("engines").
+    /// Both produce identical results, the flat sweep is faster and uses less memory.
+    enum Engine {
+        TREESWEEP = 0,  ///< sweeps a multiset of RegLimit objects (the classic algorithm)
+        FLATSWEEP = 1   ///< sorts a flat array of packed RegEvents once and sweeps it linearly
+    };
+    
+    typedef std::pmr::multiset<RegLimit> reglimset_t;
 	typedef std::vector<MultiRegion> multiregvec_t;
 	
 	// -- methods --
            
     /// Init to empty 
-    MultiOverlap(): _ancregions{}, _reglims{}, _multiregions{} {}
+    MultiOverlap(): 
+        _ancregions{std::make_shared<ancregvec_t>()}, 
+        _work{std::make_unique<Workspace>()}, _reglimext(0), 
+        _events{}, _multiregions{}, _engine(TREESWEEP)
+    {}
     
     /// Init to contain a region and trackid 
     MultiOverlap(const Region& region, unsigned int trackid): 
         MultiOverlap()
     { add(region, trackid); }
     
+    /// Init to contain a copy of a region table. If the table refers to external records,
+    /// e.g. to those of a memory-mapped snapshot, then the copy refers to them as well
+    /// until a region is added.
+    explicit MultiOverlap(const ancregvec_t& regions):
+        MultiOverlap()
+    { *_ancregions = regions; }
+    
+    /// Copy ctor. The copy gets its own workspace.
+    MultiOverlap(const MultiOverlap& other);
+    
+    /// Assignment. The workspace of the calling object is replaced by a copy of that of /other/.
+    MultiOverlap& operator=(const MultiOverlap& other);
+    
+    MultiOverlap(MultiOverlap&&) = default;
+    MultiOverlap& operator=(MultiOverlap&&) = default;
+    
     // can serve as base class
     virtual
     ~MultiOverlap() = default;
@@ -137,9 +180,27 @@ public:
      *  \sa ShuffleOvl class
      */
     void add(const Region& region, unsigned int trackid, bool shuffleable=true) {
-        _ancregions.emplace_back(region, trackid, shuffleable);
+        // the region table may be shared with copies of this object 
+        // or with the overlaps found earlier, so copy it before modification
+        if (_ancregions.use_count() > 1) {
+            _ancregions = std::make_shared<ancregvec_t>(*_ancregions);
+        }
+        _ancregions->push_back(region, trackid, shuffleable);
     }
 
+    /// \return the number of regions added so far
+    unsigned int region_count() const { return _ancregions->size(); }
+    
+    /// \return the regions added so far, in the order of addition
+    const ancregvec_t& regions() const { return *_ancregions; }
+    
+    /// Selects the overlap detection engine used by subsequent
+    /// find_overlaps or find_unionoverlaps operations.
+    void engine(Engine eng) { _engine = eng; }
+    
+    /// \return the current overlap detection engine
+    Engine engine() const { return _engine; }
+    
     /**
      * Finds multiple overlaps. Whenever the multiplicity of the overlap
      * changes, there will be a new MultiRegion in the returned vector.
@@ -174,11 +235,43 @@ public:
     unsigned int find_unionoverlaps(unsigned int ovlen,
         unsigned int minmult = 2, unsigned int maxmult = 0, unsigned int ext = 0);
     
+    /**
+     * Finds multiple overlaps like `find_overlaps` above, but instead of storing them
+     * each overlap is passed to /sink/ as soon as it is found. 
+     * The overlaps stored by a previous `find_overlaps` call are not changed.
+     * \param sink a callable invoked as `sink(MultiRegion&&)` for each overlap.
+     * It is copied unless passed as an lvalue. If it can be invoked as 
+     * `sink(first, last, multiplicity)` instead, then it is called that way, and
+     * the overlaps are detected faster because their ancestors are not needed.
+     * The other parameters and the return value are the same as for `find_overlaps`.
+     */
+    template <class Sink>
+    unsigned int find_overlaps(unsigned int ovlen, 
+        unsigned int minmult, unsigned int maxmult, 
+        unsigned int ext, bool intrack, Sink&& sink);
+    
+    /**
+     * Finds 'unions' of overlaps like `find_unionoverlaps` above,
+     * but instead of storing them each union is passed to /sink/ as soon as it is found.
+     * \param sink a callable invoked as `sink(MultiRegion&&)` 
+     * or as `sink(first, last, multiplicity)` for each union.
+     * The other parameters and the return value are the same as for `find_unionoverlaps`.
+     */
+    template <class Sink>
+    unsigned int find_unionoverlaps(unsigned int ovlen,
+        unsigned int minmult, unsigned int maxmult, unsigned int ext, Sink&& sink);
+    
     /// Returns the multiple overlaps found by the last 
     /// find_overlaps or find_unionoverlaps operation.
     /// \return a vector of MultiRegion objects.
     const multiregvec_t& overlaps() const { return _multiregions; }
     
+    /// Releases the memory the last find_overlaps or find_unionoverlaps operation
+    /// used for the sweep, in one step. The overlaps found are kept.
+    /// Invoke this when no more overlaps will be detected, e.g. before the overlaps are written.
+    /// The object may be used as before afterwards.
+    void release_workspace();
+    
     /// Generates some overlap statistics using the overlaps found by the last
     /// find_overlaps or find_unionoverlaps operation.
     /// \param counter a Counter object with track histogram data which will be updated.
@@ -186,50 +279,217 @@ public:
     
 protected:
 
-    typedef std::vector<AncestorRegion> ancregionvec_t;
+    typedef ancregvec_t ancregionvec_t;
+    typedef std::shared_ptr<ancregionvec_t> ancregionvecptr_t;
     
     /// \return const access to the ancestor region vector
-    const ancregionvec_t& ancregions() const { return _ancregions; }
+    const ancregionvec_t& ancregions() const { return *_ancregions; }
+    
+    /// \return the ancestor region vector as a pool that can be shared by MultiRegions
+    ancregpool_t ancregpool() const { return _ancregions; }
     
     /// Sets up the private region limits object. Clears the old one
-    void setup_reglims();
+    /// \param ext the region limits are extended by this much
+    void setup_reglims(unsigned int ext);
     
-    /// Adds the limits of an ancestor region to the internal `_reglims` object
-    void add_reglimit(const AncestorRegion& ancreg);
+    /// Adds the limits of an ancestor region to the internal RegLimit multiset
+    /// \param ancreg the record of the ancestor region
+    /// \param idx the index of /ancreg/ in the region table
+    /// \param ext the region limits are extended by this much
+    void add_reglimit(const RegRecord& ancreg, unsigned int idx, unsigned int ext);
     
-    /// Generates the overlaps based on what has been set up in `_reglims`
-    unsigned int generate_overlaps(
-            unsigned int ovlen, unsigned int minmult, unsigned int maxmult, bool intrack);
+    /// Generates the overlaps based on what has been set up in the RegLimit multiset
+    /// and passes them to /sink/
+    /// \param regions the region table the RegLimit indices refer to
+    /// \param ext the extension the RegLimits were set up with
+    template <class Sink>
+    unsigned int generate_overlaps(const ancregpool_t& regions,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+            bool intrack, unsigned int ext, Sink&& sink);
     
-    /// Generates union overlaps based on what has been set up in `_reglims`
-    unsigned int generate_unionoverlaps(
-            unsigned int ovlen, unsigned int minmult, unsigned int maxmult);
+    /// Generates union overlaps based on what has been set up in the RegLimit multiset
+    /// and passes them to /sink/
+    /// \param regions the region table the RegLimit indices refer to
+    /// \param ext the extension the RegLimits were set up with
+    template <class Sink>
+    unsigned int generate_unionoverlaps(const ancregpool_t& regions,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
+            unsigned int ext, Sink&& sink);
 
+    typedef std::vector<RegEvent> regeventvec_t;
+    
+    /// Sets up the private sorted event array of the flat sweep engine. Clears the old one
+    /// \param ext the region limits are extended by this much
+    void setup_events(unsigned int ext);
+    
+    /// Appends the limits of an ancestor region to a (not yet sorted) event vector
+    /// \param events the event vector
+    /// \param ancreg the record of the ancestor region
+    /// \param idx the index of /ancreg/ in the region table the events will refer to
+    /// \param ext the region limits are extended by this much
+    static
+    void add_events(regeventvec_t& events, const RegRecord& ancreg, 
+            unsigned int idx, unsigned int ext);
+    
+    /// Generates the overlaps by sweeping a sorted event array (flat sweep engine)
+    /// and passes them to /sink/
+    /// \param regions the region table the ancestor indices in /events/ refer to
+    /// \param events the sorted event array
+    /// \param ext the extension the events were set up with
+    template <class Sink>
+    unsigned int sweep_overlaps(
+            const ancregpool_t& regions, const regeventvec_t& events,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+            bool intrack, unsigned int ext, Sink&& sink);
+    
+    /// Generates union overlaps by sweeping a sorted event array (flat sweep engine)
+    /// and passes them to /sink/
+    /// \param regions the region table the ancestor indices in /events/ refer to
+    /// \param events the sorted event array
+    /// \param ext the extension the events were set up with
+    template <class Sink>
+    unsigned int sweep_unionoverlaps(
+            const ancregpool_t& regions, const regeventvec_t& events,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
+            unsigned int ext, Sink&& sink);
+    
+    /// Forgets the overlaps found by the last find_overlaps or find_unionoverlaps operation
+    void clear_overlaps() { _multiregions.clear(); }
+    
+    /// \return a sink that stores the overlaps, to be passed to the sweep methods
+    impl::AppendSink overlap_sink() { return impl::AppendSink(_multiregions); }
+    
     /// \return const access to the RegLimit multiset inside
-    const reglimset_t& reglims() const { return _reglims; }
+    const reglimset_t& reglims() const { return _work->reglims; }
+    
+    /// \return the extension the RegLimit multiset was last set up with
+    unsigned int reglim_extension() const { return _reglimext; }
 
     /// \return non-const access to the RegLimit multiset inside
-    reglimset_t& nonconst_reglims() { return _reglims; }
+    reglimset_t& nonconst_reglims() { return _work->reglims; }
+    
+    /// \return the memory resource the sweeps allocate their scratch data from
+    std::pmr::memory_resource* workspace() { return &_work->pool; }
 
 private:
     
+    // The scratch memory of overlap detection. The RegLimit multiset nodes 
+    // and the sweep kernels' pileups are allocated from a pool
+    // which recycles them from one detection to the next (e.g. when reshuffling)
+    // and which can be released in one step.
+    // Kept on the heap so that moving a MultiOverlap does not move the pool.
+    struct Workspace
+    {
+        Workspace(): pool(), reglims(&pool) {}
+        std::pmr::unsynchronized_pool_resource pool;
+        reglimset_t reglims;
+    };
     
     // -- data 
-    ancregionvec_t _ancregions;
-    reglimset_t _reglims;
+    ancregionvecptr_t _ancregions;  // may be shared by copies and by the MultiRegions found
+    std::unique_ptr<Workspace> _work;
+    unsigned int _reglimext;    // the extension `_work->reglims` was set up with
+    regeventvec_t _events;
     multiregvec_t _multiregions;
+    Engine _engine;
     
     // serialization
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int version)
     {
-        // _reglims is NOT serialized because it changes with each `find_overlaps`
+        // the workspace and _events are NOT serialized because they change with each `find_overlaps`
+        // the MultiRegions refer to _ancregions, which is saved only once
         ar & _ancregions & _multiregions;
     }
     
 };
 
+// -- Template implementations --
+
+template <class Sink>
+unsigned int MultiOverlap::find_overlaps(unsigned int ovlen, 
+    unsigned int minmult, unsigned int maxmult, 
+    unsigned int ext, bool intrack, Sink&& sink)
+{
+    // The region limits are extended (if required) when the sweep input is set up
+    if (engine() == FLATSWEEP) {
+        setup_events(ext);
+        return sweep_overlaps(_ancregions, _events, ovlen, minmult, maxmult, intrack, ext, 
+            std::forward<Sink>(sink));
+    } else {
+        setup_reglims(ext);
+        return generate_overlaps(_ancregions, ovlen, minmult, maxmult, intrack, ext,
+            std::forward<Sink>(sink));
+    }
+}
+
+template <class Sink>
+unsigned int MultiOverlap::find_unionoverlaps(unsigned int ovlen,
+    unsigned int minmult, unsigned int maxmult, unsigned int ext, Sink&& sink)
+{
+    if (engine() == FLATSWEEP) {
+        setup_events(ext);
+        return sweep_unionoverlaps(_ancregions, _events, ovlen, minmult, maxmult, ext,
+            std::forward<Sink>(sink));
+    } else {
+        setup_reglims(ext);
+        return generate_unionoverlaps(_ancregions, ovlen, minmult, maxmult, ext,
+            std::forward<Sink>(sink));
+    }
+}
+
+template <class Sink>
+unsigned int MultiOverlap::generate_overlaps(const ancregpool_t& regions,
+    unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+    bool intrack, unsigned int ext, Sink&& sink)
+{
+    // set up filter params with solitary checking
+    impl::Filter filter(ovlen, minmult, maxmult, true, intrack, ext);
+    
+    // iterate over the region limits which have already been set up
+    return impl::run_overlap_sweep(filter, regions, std::forward<Sink>(sink),
+        [this](auto& sweep) { impl::sweep_reglims(reglims(), sweep); }, workspace());
+}
+
+template <class Sink>
+unsigned int MultiOverlap::generate_unionoverlaps(const ancregpool_t& regions,
+    unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
+    unsigned int ext, Sink&& sink)
+{
+    // set up filter params without solitary checking
+    // intra-track overlaps are always allowed
+    impl::Filter filter(ovlen, minmult, maxmult, false, true, ext);
+    
+    // iterate over the region limit multiset which was set up already
+    impl::UnionSweep<Sink> sweep(filter, regions, std::forward<Sink>(sink), workspace());
+    impl::sweep_reglims(reglims(), sweep);
+    return sweep.region_count();
+}
+
+template <class Sink>
+unsigned int MultiOverlap::sweep_overlaps(
+    const ancregpool_t& regions, const regeventvec_t& events,
+    unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+    bool intrack, unsigned int ext, Sink&& sink)
+{
+    impl::Filter filter(ovlen, minmult, maxmult, true, intrack, ext);
+    return impl::run_overlap_sweep(filter, regions, std::forward<Sink>(sink),
+        [&events](auto& sweep) { impl::sweep_events(events, sweep); }, workspace());
+}
+
+template <class Sink>
+unsigned int MultiOverlap::sweep_unionoverlaps(
+    const ancregpool_t& regions, const regeventvec_t& events,
+    unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
+    unsigned int ext, Sink&& sink)
+{
+    impl::Filter filter(ovlen, minmult, maxmult, false, true, ext);
+    impl::UnionSweep<Sink> sweep(filter, regions, std::forward<Sink>(sink), workspace());
+    impl::sweep_events(events, sweep);
+    return sweep.region_count();
+}
+
 } // namespace multovl
 
 #endif  // MULTOVL_MULTIOVERLAP_HEADER
@@ -44,7 +44,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // -- Library headers --
 
-#include "multovl/ancregion.hh"     // pulls in region.hh 
+#include "multovl/anctable.hh"     // pulls in [anc]region.hh 
 
 // -- Boost headers --
 
@@ -54,29 +54,46 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "boost/serialization/library_version_type.hpp"
 #endif
 #include "boost/serialization/set.hpp"  // other serialization headers come from [anc]region.hh
+#include "boost/serialization/vector.hpp"
+#include "boost/serialization/shared_ptr.hpp"   // for serializing `std::shared_ptr`
+#include "boost/serialization/split_member.hpp"
+#include "boost/container/small_vector.hpp"
+
+// -- Standard headers --
+
+#include <memory>
 
 // == CLASSES ==
 
 namespace multovl {
 
+/// Shared immutable pool of ancestor regions. Multiregions refer to their ancestors
+/// by indices into such a pool (typically the region table of a MultiOverlap object).
+typedef std::shared_ptr<const ancregvec_t> ancregpool_t;
+
 /**
  * Multiple regions (overlaps) which constitute the output type of the multioverlap operations.
  * Use this for file-based "multovl" where it is important that the objects can be
  * written to a text file.
+ * The ancestors are not stored in the multiregion itself: it keeps a small
+ * sorted vector of indices into a shared ancestor region pool instead.
  */
-class MultiRegion: public BaseRegion
+class MultiRegion
 {
     public:
     
+    /// Indices of the ancestors in the ancestor pool.
+    /// Up to 4 ancestors are stored without heap allocation.
+    typedef boost::container::small_vector<unsigned int, 4> ancidxvec_t;
+    
     /// Init to empty (to be used by STL containers etc)  
     MultiRegion();
     
     /** 
      * Inits to a region between [first..last] to contain
      * a (multi)set of regions as its "ancestry". Note that multiregions
-     * have unspecified ('.') strands and a name "overlap" by default,
-     * but these can be changed using the strand(char) and name(const std::string&) methods
-     * inherited from BaseRegion.
+     * have unspecified ('.') strands and the name "overlap".
+     * The ancestors are copied into a new ancestor pool owned by the multiregion.
      * \param first start of the multiregion
      * \param last end of the multiregion
      * \param ancestors multiset of AncestorRegion objects, empty if omitted
@@ -86,7 +103,47 @@ class MultiRegion: public BaseRegion
     MultiRegion(unsigned int first, unsigned int last, 
         const ancregset_t& ancestors = ancregset_t(), unsigned int mult = 0);
     
+    /** 
+     * Inits to a region between [first..last] whose ancestors are
+     * in an ancestor pool shared with other multiregions.
+     * \param first start of the multiregion
+     * \param last end of the multiregion
+     * \param ancpool the shared ancestor pool
+     * \param ancidx indices of the ancestors in /ancpool/, must be sorted
+     * so that the ancestors are in ascending order
+     * \param mult the maximal multiplicity of the overlap, if 0 then
+     * ancidx.size() will be used.
+     * \param ext the extension of the ancestor limits which were used
+     * when /first/ and /last/ were determined (default 0)
+     */
+    MultiRegion(unsigned int first, unsigned int last, 
+        const ancregpool_t& ancpool, const ancidxvec_t& ancidx, unsigned int mult,
+        unsigned int ext = 0);
+    
+    // -- Region-like getters --
+    
+    /// Returns the first coordinate.
+    unsigned int first() const { return _first; }
+    
+    /// Returns the last coordinate.
+    unsigned int last() const { return _last; }
+    
+    /// Returns the length
+    unsigned int length() const { return is_empty()? 0: last() - first() + 1; }
+    
+    /// Empty region (0,0)
+    bool is_empty() const { return (first() == 0 && last() == 0); }
+    
+    /// Returns the strand information, always '.'
+    const char& strand() const { return STRAND; }
+    
+    /// Returns the name of the region, always "overlap"
+    const std::string& name() const { return NAME; }
+    
+    // -- Ancestry --
+    
     /// Adds an ancestor to the calling object.
+    /// Copies the ancestor pool, use only for small multiregions.
     /// \param anc the ancestor to be added.
     void add_ancestor(const AncestorRegion& anc);
 
@@ -95,8 +152,24 @@ class MultiRegion: public BaseRegion
     /// Not the same as the number of ancestors when "union overlaps" are generated.
     unsigned int multiplicity() const { return _mult; }
     
-    /// Returns the set of ancestors.
-    const ancregset_t& ancestors() const { return _ancestors; }
+    /// \return the number of ancestors
+    unsigned int ancestor_count() const { return _ancidx.size(); }
+    
+    /// \return a copy of the i-th ancestor in ascending order, no range checking
+    AncestorRegion ancestor(unsigned int i) const { return (*_ancpool)[_ancidx[i]]; }
+    
+    /// \return the record of the i-th ancestor in ascending order, no range checking
+    const RegRecord& ancestor_record(unsigned int i) const { return _ancpool->record(_ancidx[i]); }
+    
+    /// \return the index of the i-th ancestor in the ancestor pool, no range checking
+    unsigned int ancestor_index(unsigned int i) const { return _ancidx[i]; }
+    
+    /// \return the ancestor pool the ancestors of this multiregion are stored in
+    const ancregpool_t& ancestor_pool() const { return _ancpool; }
+    
+    /// Returns the set of ancestors. 
+    /// Note that this makes copies of all ancestors.
+    ancregset_t ancestors() const;
     
     /// Return the track IDs of the ancestors in a vector.
     std::vector<int> ancestor_trackids() const;
@@ -115,20 +188,42 @@ class MultiRegion: public BaseRegion
     
     private:
     
-    bool update_solitary();
+    bool update_solitary(unsigned int ext = 0);
     
-    ancregset_t _ancestors; // ancestors
+    static const char STRAND;
+    static const std::string NAME;
+    
+    unsigned int _first, _last;
+    ancregpool_t _ancpool;  // shared ancestor pool
+    ancidxvec_t _ancidx;    // indices of the ancestors in _ancpool
     bool _solitary;
     unsigned int _mult;
     
-    // serialization
+    // "split" serialization
+    // the ancestor pool is saved only once even if shared by several multiregions
     friend class boost::serialization::access;
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int version)
+    void save(Archive& ar, const unsigned int version) const
+    {
+        ar << _first << _last;
+        std::shared_ptr<ancregvec_t> pool = std::const_pointer_cast<ancregvec_t>(_ancpool);
+        ar << pool;
+        std::vector<unsigned int> ancidx(_ancidx.begin(), _ancidx.end());
+        ar << ancidx << _solitary << _mult;
+    }
+    
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version)
     {
-        ar & boost::serialization::base_object<BaseRegion>(*this);
-        ar & _ancestors & _solitary & _mult;
+        ar >> _first >> _last;
+        std::shared_ptr<ancregvec_t> pool;
+        ar >> pool;
+        _ancpool = pool;
+        std::vector<unsigned int> ancidx;
+        ar >> ancidx >> _solitary >> _mult;
+        _ancidx.assign(ancidx.begin(), ancidx.end());
     }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
     
 };  // class MultiRegion
 	
@@ -44,6 +44,11 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * \date 2010-03-22
  */
 
+// -- Standard headers --
+
+#include <set>
+#include <string>
+
 // -- Polite header --
 
 #include "multovl/polite.hh"
@@ -67,6 +72,13 @@ class MultovlOptbase : public virtual Polite
     unsigned int extension() const { return _extension; }
     bool uniregion() const { return _uniregion; }
     bool timing() const { return _timing; }
+    bool flatsweep() const { return _flatsweep; }
+    
+    /// \return the chromosomes to be analysed, empty if all of them
+    const std::set<std::string>& chroms() const { return _chroms; }
+    
+    /// \return the directory of the parsed-track cache, empty if there is no caching
+    const std::string& cachedir() const { return _cachedir; }
 	
 	virtual
 	std::string param_str() const;
@@ -79,13 +91,20 @@ class MultovlOptbase : public virtual Polite
 	virtual
 	bool check_variables();
 	
+	/// \return the number of CPU cores, at least 1
+	static
+	unsigned int core_count();
+	
 	virtual
 	std::ostream& version_info(std::ostream& out) const;
 	
 	private:
 	
 	unsigned int _minmult, _maxmult, _ovlen, _extension, _copt;
-	bool _uniregion, _nointrack, _timing;
+	bool _uniregion, _nointrack, _timing, _flatsweep;
+	std::string _chromlist;
+	std::set<std::string> _chroms;
+	std::string _cachedir;
 };
 
 } // namespace multovl
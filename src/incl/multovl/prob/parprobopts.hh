@@ -62,6 +62,7 @@ public:
 	ParProbOpts();
 	
     /// \return the number of threads requested
+    virtual
     unsigned int threads() const { return _threads; }
     
 	virtual
@@ -77,8 +78,6 @@ protected:
 
 private:
 	
-    static
-    unsigned int core_count();
     static const unsigned int DEFAULT_THREADS;
     unsigned int _threads;
 };
@@ -87,6 +87,10 @@ class ProbOpts : public MultovlOptbase
     
     /// \return true if the user requested an ASCII progress bar display
     bool progress() const { return _progress; }
+    
+    /// \return the number of threads, the serial tool uses only 1
+    virtual
+    unsigned int threads() const { return 1; }
 	
 	virtual
     std::string param_str() const;
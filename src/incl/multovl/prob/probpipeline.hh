@@ -85,6 +85,17 @@ protected:
         /// \param overlaps a vector of MultiRegion objects
         /// which are the results of a multiple overlap calculation
         void update(const MultiOverlap::multiregvec_t& overlaps);
+        
+        /// Adds the length of one overlap to the total of its multiplicity.
+        /// This way an OvlenCounter can be passed as a "counting" sink 
+        /// to the overlap detection methods so that the overlaps need not be constructed.
+        /// \param first the first position of the overlap
+        /// \param last the last position of the overlap
+        /// \param mult the multiplicity of the overlap
+        void operator()(unsigned int first, unsigned int last, unsigned int mult)
+        {
+            _mtolen[mult] += last - first + 1;
+        }
     
         /// \return const access to the multiplicity => total overlap length map
         const mtolen_t& mtolen() const { return _mtolen; }
@@ -103,6 +114,7 @@ protected:
     /// a track containing free regions must also be read. All regions must fall within
     /// these free regions. Optionally, a set of "fixed" tracks may be defined
     /// which won't be shuffled; they are also read here.
+    /// If the options allow more than one thread, then the track files are read concurrently.
     /// \return the total number of tracks successfully read, 0 on error.
     virtual
     unsigned int read_input();
@@ -52,6 +52,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <set>
 #include <map>
+#include <utility>
 
 namespace multovl {
 namespace prob {
@@ -75,7 +76,7 @@ public:
     /// \return true if /reg/ fits, false otherwise.
     bool fit_into_frees(const Region& reg) const { return _freeregions.fit(reg); }
     
-    /// Shuffles the "shufflable"regions once by updating the internal `_reglims` object
+    /// Shuffles the "shufflable"regions once by updating the internal RegLimit multiset
     /// and then calculates the overlaps.
     /// \param rng A uniform RNG
     /// \param ovlen the minimum overlap length (>=1) required
@@ -89,7 +90,7 @@ public:
             unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
             unsigned int ext, bool intrack);
 
-    /// Shuffles the "shufflable"regions once by updating the internal `_reglims` object
+    /// Shuffles the "shufflable"regions once by updating the internal RegLimit multiset
     /// and then calculates the union overlaps.
     /// \param rng A uniform RNG
     /// \param ovlen the minimum overlap length (>=1) required
@@ -101,16 +102,53 @@ public:
     unsigned int shuffle_unionoverlaps(UniformGen& rng,
             unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
             unsigned int ext);
+    
+    /// Shuffles the "shufflable" regions once and passes the overlaps to /sink/
+    /// instead of storing them. The parameters are the same as for `shuffle_overlaps` above.
+    /// \param sink a callable invoked for each overlap, \sa MultiOverlap::find_overlaps()
+    template <class Sink>
+    unsigned int shuffle_overlaps(UniformGen& rng,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+            unsigned int ext, bool intrack, Sink&& sink)
+    {
+        shuffle(rng, ext);
+        return (engine() == FLATSWEEP)?
+            sweep_overlaps(_shuffled, _sweepevents, ovlen, minmult, maxmult, intrack, ext,
+                std::forward<Sink>(sink)):
+            generate_overlaps(_shuffled, ovlen, minmult, maxmult, intrack, ext,
+                std::forward<Sink>(sink));
+    }
+    
+    /// Shuffles the "shufflable" regions once and passes the union overlaps to /sink/
+    /// instead of storing them. The parameters are the same as for `shuffle_unionoverlaps` above.
+    /// \param sink a callable invoked for each union overlap, \sa MultiOverlap::find_unionoverlaps()
+    template <class Sink>
+    unsigned int shuffle_unionoverlaps(UniformGen& rng,
+            unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
+            unsigned int ext, Sink&& sink)
+    {
+        shuffle(rng, ext);
+        return (engine() == FLATSWEEP)?
+            sweep_unionoverlaps(_shuffled, _sweepevents, ovlen, minmult, maxmult, ext,
+                std::forward<Sink>(sink)):
+            generate_unionoverlaps(_shuffled, ovlen, minmult, maxmult, ext,
+                std::forward<Sink>(sink));
+    }
 
 private:
     
-    unsigned int shuffle(UniformGen& rng);
-    bool place_randomly(UniformGen& rng, AncestorRegion& sreg) const;
+    void setup_shuffled();
+    void setup_fixedevents(unsigned int ext);
+    unsigned int shuffle(UniformGen& rng, unsigned int ext);
+    bool place_randomly(UniformGen& rng, RegRecord& sreg, unsigned int ext) const;
     
     // data
     FreeRegions _freeregions;
-    typedef std::vector<AncestorRegion> ancregvec_t;
-    ancregvec_t _shuffleables;
+    ancregionvecptr_t _shuffled;   // copy of ancregions() with the shuffleable regions moved around
+    std::vector<unsigned int> _shuffleidx;  // indices of the shuffleable regions in _shuffled
+    regeventvec_t _fixedevents, _sweepevents;   // flat sweep engine only
+    unsigned int _fixedext;     // the region extension used for _fixedevents
+    bool _fixedready;   // _fixedevents is set up (it may be empty if there are no fixed regions)
     unsigned int _shufflecount;
 
 #if 0
@@ -0,0 +1,119 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_REGEVENT_HEADER
+#define MULTOVL_REGEVENT_HEADER
+
+// == Header regevent.hh ==
+
+/// \file 
+/// \brief Packed region limits for the "flat sweep" overlap detection engine.
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <cstdint>
+#include <stdexcept>
+
+// == Classes ==
+
+namespace multovl {
+
+/// A RegEvent is the "flat" equivalent of a RegLimit:
+/// it packs a region limit position, a first/last flag and the index of
+/// the ancestor region (in the owning MultiOverlap's region table)
+/// into a single 64-bit unsigned integer.
+/// The layout is [position:32|islast:1|index:31], so that a plain integer sort
+/// orders the events by position, "first" limits before "last" limits at the same position,
+/// and then by ancestor index. This is exactly the order in which the
+/// RegLimit-based engine visits its multiset.
+class RegEvent
+{
+public:
+    
+    /// The maximal ancestor index that can be stored in a RegEvent
+    static constexpr unsigned int MAX_INDEX = 0x7FFFFFFFu;
+    
+    /// Init to empty
+    RegEvent(): _key(0) {}
+    
+    /// Init with a position, a first/last flag and an ancestor index.
+    /// \param pos the position of the region limit
+    /// \param isfirst true if first position, false if last
+    /// \param idx the index of the ancestor region, must not exceed MAX_INDEX
+    RegEvent(unsigned int pos, bool isfirst, unsigned int idx):
+        _key(
+            (static_cast<std::uint64_t>(pos) << 32) | 
+            (isfirst? 0: LASTBIT) | 
+            (idx & MAX_INDEX)
+        )
+    {}
+    
+    // -- Accessors --
+    
+    /// \return the position of the region limit
+    unsigned int pos() const { return static_cast<unsigned int>(_key >> 32); }
+    
+    /// \return /true/ if this is the "first" coordinate of the underlying ancestor region.
+    bool is_first() const { return !(_key & LASTBIT); }
+    
+    /// \return the index of the underlying ancestor region
+    unsigned int index() const { return static_cast<unsigned int>(_key & MAX_INDEX); }
+    
+    /// Ordering according to position, or first before last if the same position,
+    /// then by ancestor index.
+    bool operator<(const RegEvent& other) const { return _key < other._key; }
+    
+    /// Makes sure that /n/ ancestor regions can be indexed by RegEvents.
+    /// \throw std::length_error if that is not possible
+    static
+    void check_size(std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(MAX_INDEX) + 1)
+            throw std::length_error("Too many regions for the flat sweep engine");
+    }
+    
+private:
+    
+    static constexpr std::uint64_t LASTBIT = 0x80000000u;
+    
+    // data
+    std::uint64_t _key;
+    
+};  // class RegEvent
+    
+}   // namespace multovl
+
+#endif  // MULTOVL_REGEVENT_HEADER
@@ -66,8 +66,10 @@ namespace multovl {
 
 /**
  * \brief Instances of the Region class represent regions on a sequence.
- * The coordinates may be "extended" symmetrically in all Region instances
- * by invoking the `set_extension()` static method.
+ * The coordinates may be "extended" symmetrically by an extension length
+ * passed explicitly to the `extended_*()` methods. The extension is not
+ * stored anywhere, so objects working with different extensions
+ * (possibly in different threads) do not interfere with each other.
  */
 class Region: public BaseRegion {
     public:
@@ -101,39 +103,40 @@ class Region: public BaseRegion {
     
     // -- Getters --
     
-    /// Returns the extension
-    static
-    const unsigned int& extension() { return _extension; }
+    /// \return the first coordinate extended by /ext/, but not below 0.
+    unsigned int extended_first(unsigned int ext) const
+    {
+        return ext > first()? 0: first() - ext;
+    }
     
-    /// Returns the (possibly extended) first coordinate.
-    virtual 
-    unsigned int first() const override final;
+    /// \return the last coordinate extended by /ext/.
+    unsigned int extended_last(unsigned int ext) const
+    {
+        return last() + ext;
+    }
     
-    /// Returns the (possibly extended) last coordinate.
-    virtual
-    unsigned int last() const override final;
+    /// \return the length of the region extended by /ext/.
+    unsigned int extended_length(unsigned int ext) const
+    {
+        return ext == 0? length(): extended_last(ext) - extended_first(ext) + 1;
+    }
     
     // -- Setters --
     
-    /// Sets the region coordinate extension.
-    static
-    void set_extension(unsigned int ext) { _extension = ext; }
-    
-    /// Sets the coordinates. Enforces f<=l.
-    /// The `f` and `l` parameters are extended coordinates.
-    /// For instance, if the current extension is 10, and you invoke
-    /// `set_coords(50, 80)`, then the "true" coordinates stored inside
+    /// Sets the coordinates from extended coordinates. Enforces f<=l.
+    /// For instance, if the extension is 10, and you invoke
+    /// `set_extended_coords(50, 80, 10)`, then the "true" coordinates stored inside
     /// will be `_first=60`, `_last=70`.
-    /// \param f The first, possibly extended coordinate
-    /// \param l the last, possibly extended coordinate
-    virtual
-    void set_coords(unsigned int f, unsigned int l) override;
+    /// \param f The first extended coordinate
+    /// \param l the last extended coordinate
+    /// \param ext the extension
+    void set_extended_coords(unsigned int f, unsigned int l, unsigned int ext)
+    {
+        set_coords(f + ext, l - ext);
+    }
 
     private:
     
-    // data
-    static unsigned int _extension; // region limits are artificially "extendable"
-    
     // serialization
     // no new members, use base class serialization
     friend class boost::serialization::access;
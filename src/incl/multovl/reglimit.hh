@@ -51,6 +51,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // -- Own headers --
 
+#include "multovl/regrecord.hh"
 #include "multovl/ancregion.hh"     // pulls in region.hh as well
 
 // == Classes ==
@@ -60,28 +61,37 @@ namespace multovl {
 /// Each ancestor region to be overlapped is stored twice in MultiRegion's lookup;
 /// once as a "first pos", and once as a "last pos".
 /// The RegLimit class implements these "region limit" objects.
+/// A RegLimit does not refer to its region, it copies what the sweeps need
+/// and the index of the region in the region table of its owner.
 class RegLimit
 {
 public:
     
     /// Init to empty
-    RegLimit(): _regp(), _isfirst(false) {}
+    RegLimit(): _idx(0), _firstpos(0), _lastpos(0), _trackid(0), 
+        _isfirst(false), _shuffleable(false) {}
     
-    /// Init with an ancestor region
-    /// \param const reference to an ancestor region (managed by somebody else)
+    /// Init with a region record
+    /// \param rec the record of an ancestor region
     /// \param isfirst true if first position, false if last
+    /// \param idx the index of /rec/ in the region table of its owner (default 0)
+    /// \param ext the region limits are extended by this much (default 0).
+    /// The extended positions are calculated once, here.
+    explicit RegLimit(const RegRecord& rec, 
+        bool isfirst=true, unsigned int idx=0, unsigned int ext=0)
+    : _idx{idx}, 
+      _firstpos{rec.extended_first(ext)}, _lastpos{rec.extended_last(ext)},
+      _trackid{rec.track_id()}, _isfirst{isfirst}, _shuffleable{rec.is_shuffleable()} {}
+    
+    /// Init with an ancestor region, the parameters are the same as above.
     explicit RegLimit(const AncestorRegion& reg, 
-        bool isfirst=true)
-    : _regp{&reg}, _isfirst{isfirst} {}
+        bool isfirst=true, unsigned int idx=0, unsigned int ext=0)
+    : _idx{idx}, 
+      _firstpos{reg.extended_first(ext)}, _lastpos{reg.extended_last(ext)},
+      _trackid{reg.track_id()}, _isfirst{isfirst}, _shuffleable{reg.is_shuffleable()} {}
     
     // -- Accessors --
     
-    /// \return the AncestorRegion underlying this RegLimit.
-    const AncestorRegion& region() const
-    {
-        return *_regp;
-    }
-    
     /// \return /true/ if this limit is the "first" coordinate of the underlying AncestorRegion.
     bool is_first() const
     {
@@ -94,23 +104,36 @@ public:
         _isfirst = isfirst;
     }
     
+    /// \return the index of the underlying ancestor region in the region table of its owner.
+    unsigned int index() const
+    {
+        return _idx;
+    }
+    
+    /// \return the track ID of the underlying ancestor region
     unsigned int track_id() const
     {
-        return _regp->track_id();   // convenience function
+        return _trackid;
+    }
+    
+    /// \return /true/ if the underlying ancestor region may be reshuffled
+    bool is_shuffleable() const
+    {
+        return _shuffleable;
     }
     
-    /// \return the position of the calling object, depending on is_first().
+    /// \return the (extended) position of the calling object, depending on is_first().
     /// If is_first() == true, then the first position is returned, otherwise the last is returned.
     unsigned int this_pos() const
     {
-        return (is_first()? _regp->first(): _regp->last());
+        return (is_first()? _firstpos: _lastpos);
     }
     
-    /// \return the "other" position of the calling object, depending on is_first().
+    /// \return the "other" (extended) position of the calling object, depending on is_first().
     /// If is_first() == true, then the last position is returned, otherwise the first is returned.
     unsigned int other_pos() const
     {
-        return (is_first()? _regp->last(): _regp->first());
+        return (is_first()? _lastpos: _firstpos);
     }
     
     /// Ordering according to position, or first before last if the same position.
@@ -119,8 +142,10 @@ public:
 private:
     
     // data
-    const AncestorRegion* _regp;    // not supposed to modify underlying object ("view ptr")
-    bool _isfirst;
+    unsigned int _idx;
+    unsigned int _firstpos, _lastpos;   // possibly extended limits of the region
+    unsigned int _trackid;
+    bool _isfirst, _shuffleable;
     
 };  // class RegLimit
     
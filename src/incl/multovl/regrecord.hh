@@ -0,0 +1,197 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_REGRECORD_HEADER
+#define MULTOVL_REGRECORD_HEADER
+
+// == Header regrecord.hh ==
+
+/// \file 
+/// \brief Compact region records for the overlap detection internals.
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <cstdint>
+#include <stdexcept>
+
+// -- Boost headers --
+
+#include "boost/serialization/access.hpp"
+
+// == Classes ==
+
+namespace multovl {
+
+/// A RegRecord is the plain, non-virtual equivalent of an AncestorRegion
+/// used inside MultiOverlap, ShuffleOvl and the sweeps.
+/// It stores the coordinates, the track ID and a handle to the region's name
+/// in 16 bytes: the name itself is kept in a separate name table (see AncestorTable).
+/// The strand and the shuffleability are packed into the high bits of the name handle.
+/// BaseRegion, Region and AncestorRegion remain the types used at the I/O boundary.
+class RegRecord
+{
+public:
+    
+    /// The maximal name handle that can be stored in a RegRecord
+    static constexpr unsigned int MAX_NAMEID = 0x1FFFFFFFu;
+    
+    /// Init to empty
+    RegRecord(): _first(0), _last(0), _trackid(0), _nameflags(STRAND_NONE | SHUFFLEBIT) {}
+    
+    /**
+     * Inits a record with positions [f..l]. Swaps /f/ and /l/ silently if f>l.
+     * \param f the first position
+     * \param l the last position
+     * \param s the strand, anything else than '+' or '-' is stored as '.'
+     * \param trackid the track ID
+     * \param shuffleable /true/ if the region may be reshuffled
+     * \param nameid the handle of the region's name in a name table, must not exceed MAX_NAMEID
+     */
+    RegRecord(unsigned int f, unsigned int l, char s, 
+            unsigned int trackid, bool shuffleable, unsigned int nameid):
+        _first(f <= l? f: l), _last(f <= l? l: f), _trackid(trackid),
+        _nameflags((nameid & MAX_NAMEID) | strand_bits(s) | (shuffleable? SHUFFLEBIT: 0))
+    {}
+    
+    // -- Getters --
+    
+    unsigned int first() const { return _first; }
+    unsigned int last() const { return _last; }
+    
+    /// \return the length, 0 for the empty record (0,0) like BaseRegion::length()
+    unsigned int length() const { return (_first == 0 && _last == 0)? 0: _last - _first + 1; }
+    
+    /// \return the first coordinate extended by /ext/, but not below 0.
+    unsigned int extended_first(unsigned int ext) const { return ext > _first? 0: _first - ext; }
+    
+    /// \return the last coordinate extended by /ext/.
+    unsigned int extended_last(unsigned int ext) const { return _last + ext; }
+    
+    /// \return the length of the region extended by /ext/.
+    unsigned int extended_length(unsigned int ext) const
+    {
+        return ext == 0? length(): extended_last(ext) - extended_first(ext) + 1;
+    }
+    
+    /// \return the strand: '+', '-' or '.'
+    char strand() const
+    {
+        unsigned int s = _nameflags & STRANDMASK;
+        return s == STRAND_PLUS? '+': (s == STRAND_MINUS? '-': '.');
+    }
+    
+    unsigned int track_id() const { return _trackid; }
+    bool is_shuffleable() const { return (_nameflags & SHUFFLEBIT) != 0; }
+    
+    /// \return the handle of the name of the region in its name table
+    unsigned int name_id() const { return _nameflags & MAX_NAMEID; }
+    
+    /// Compares the coordinates, the track ID, the strand and the shuffleability,
+    /// i.e. everything but the name.
+    bool same_fields(const RegRecord& other) const
+    {
+        return _first == other._first && _last == other._last && _trackid == other._trackid &&
+            (_nameflags & ~MAX_NAMEID) == (other._nameflags & ~MAX_NAMEID);
+    }
+    
+    /// Ordering by track ID, then first position ascending, last position descending,
+    /// and strand ('+' < '-' < '.'). This is the same as the AncestorRegion ordering
+    /// except that the names are not compared.
+    /// \return -1, 0, or 1 if the calling object is less than, "equal to" or greater than /other/
+    int compare(const RegRecord& other) const
+    {
+        if (_trackid != other._trackid) return _trackid < other._trackid? -1: 1;
+        if (_first != other._first) return _first < other._first? -1: 1;
+        if (_last != other._last) return _last > other._last? -1: 1;
+        unsigned int s = _nameflags & STRANDMASK, os = other._nameflags & STRANDMASK;
+        if (s != os) return s < os? -1: 1;
+        return 0;
+    }
+    
+    // -- Setters --
+    
+    /// Sets the coordinates. Enforces f<=l.
+    void set_coords(unsigned int f, unsigned int l)
+    {
+        _first = f <= l? f: l;
+        _last = f <= l? l: f;
+    }
+    
+    /// Sets the coordinates from extended coordinates, \sa Region::set_extended_coords()
+    void set_extended_coords(unsigned int f, unsigned int l, unsigned int ext)
+    {
+        set_coords(f + ext, l - ext);
+    }
+    
+    /// Makes sure that /n/ names can be referred to by RegRecords.
+    /// \throw std::length_error if that is not possible
+    static
+    void check_size(std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(MAX_NAMEID) + 1)
+            throw std::length_error("Too many region names");
+    }
+    
+private:
+    
+    // the strand codes are ordered like the strand characters
+    static constexpr std::uint32_t STRAND_PLUS = 0x00000000u,
+        STRAND_MINUS = 0x20000000u, STRAND_NONE = 0x40000000u, 
+        STRANDMASK = 0x60000000u, SHUFFLEBIT = 0x80000000u;
+    
+    static
+    std::uint32_t strand_bits(char s)
+    {
+        return s == '+'? STRAND_PLUS: (s == '-'? STRAND_MINUS: STRAND_NONE);
+    }
+    
+    // data
+    std::uint32_t _first, _last, _trackid;
+    std::uint32_t _nameflags;   // [shuffleable:1|strand:2|nameid:29]
+    
+    // serialization
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & _first & _last & _trackid & _nameflags;
+    }
+    
+};  // class RegRecord
+
+}   // namespace multovl
+
+#endif  // MULTOVL_REGRECORD_HEADER
@@ -0,0 +1,148 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_STREAMOVERLAP_HEADER
+#define MULTOVL_STREAMOVERLAP_HEADER
+
+// == Header streamoverlap.hh ==
+
+/// \file 
+/// \brief Multiple overlaps of coordinate-sorted genomic region streams.
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <utility>
+#include <functional>
+
+// -- Own headers --
+
+#include "multovl/multioverlap.hh"
+#include "multovl/sweep.hh"
+
+// == Classes ==
+
+namespace multovl {
+
+namespace impl {
+    class AnySweep;
+}
+
+/// A StreamOverlap object detects the multiple overlaps of regions on one chromosome
+/// which are fed to it in ascending order of their first coordinates.
+/// Unlike MultiOverlap, it keeps only the regions which may still take part in an overlap
+/// (the current "pileup"), so that its memory usage does not depend on the total
+/// number of regions. The overlaps are the same as those MultiOverlap would find.
+/// The class is non-copyable.
+class StreamOverlap
+{
+public:
+    
+    typedef MultiOverlap::multiregvec_t multiregvec_t;
+    
+    /**
+     * Inits a StreamOverlap object. The parameters have the same meaning as in 
+     * MultiOverlap::find_overlaps() and MultiOverlap::find_unionoverlaps().
+     * \param ovlen the minimum overlap length (>=1) required
+     * \param minmult the minimum multiplicity required
+     * \param maxmult the maximum multiplicity required, 0 means any
+     * \param ext "fake" extension of the input region boundaries
+     * \param intrack if /true/, then overlaps within the same track are accepted
+     * \param uniregion if /true/, then union overlaps are detected, /intrack/ is ignored
+     */
+    StreamOverlap(unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+        unsigned int ext, bool intrack, bool uniregion);
+    
+    // Non-copyable class
+    StreamOverlap(const StreamOverlap&) = delete;
+    StreamOverlap& operator=(const StreamOverlap&) = delete;
+    
+    ~StreamOverlap();
+    
+    /// Adds a region to the stream. The overlaps which are completed
+    /// by this region are made available in overlaps().
+    /// \param reg the region to be added, its first coordinate must not be smaller
+    /// than that of the previously added region.
+    /// \param trackid the track ID of /reg/
+    /// \return /true/ on success, /false/ if /reg/ is out of order (it is ignored then).
+    bool add(const BaseRegion& reg, unsigned int trackid);
+    
+    /// Finishes the stream: all remaining overlaps are made available in overlaps().
+    /// Afterwards the object can be reused for another chromosome.
+    void finish();
+    
+    /// \return the overlaps completed by the last add() or finish() call.
+    /// They are valid until the next add() or finish() call only.
+    const multiregvec_t& overlaps() const { return _multiregions; }
+    
+    /// \return the maximal number of regions that were kept at the same time.
+    unsigned int max_depth() const { return _maxdepth; }
+    
+    /// \return the number of region slots allocated at the moment
+    unsigned int slot_count() const { return _slots->size(); }
+    
+    /// \return the number of names the slots keep at the moment
+    unsigned int name_count() const { return _slots->names().size(); }
+    
+private:
+    
+    typedef std::pair<unsigned int, unsigned int> endslot_t;    // (extended last pos, slot)
+    typedef std::priority_queue<endslot_t, std::vector<endslot_t>, std::greater<endslot_t> > endqueue_t;
+    
+    void reset();
+    void close_until(unsigned int pos);
+    void close_top();
+    void recycle_slots();
+    
+    // data
+    unsigned int _ext;
+    bool _uniregion;
+    std::unique_ptr<impl::Filter> _filter;
+    std::unique_ptr<impl::AnySweep> _sweep;     // the kernel chosen for the parameters
+    std::shared_ptr<ancregvec_t> _slots;  // the regions in the current pileup
+    ancregpool_t _pool;     // the same as _slots, shared with the overlaps
+    std::vector<unsigned int> _freeslots, _closedslots, _doneslots;
+    endqueue_t _ends;       // the ends of the regions in the current pileup
+    multiregvec_t _multiregions;
+    unsigned int _lastfirst, _maxdepth;
+    
+};  // class StreamOverlap
+
+}   // namespace multovl
+
+#endif  // MULTOVL_STREAMOVERLAP_HEADER
@@ -0,0 +1,169 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_STRPOOL_HEADER
+#define MULTOVL_STRPOOL_HEADER
+
+// == Header strpool.hh ==
+
+/// \file 
+/// \brief Arena-backed string interning.
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// -- Boost headers --
+
+#include "boost/serialization/access.hpp"
+#include "boost/serialization/split_member.hpp"
+#include "boost/serialization/string.hpp"
+
+// == Classes ==
+
+namespace multovl {
+
+/**
+ * A StringPool stores each distinct string once and hands out
+ * consecutive integer IDs for them, starting from 0.
+ * The characters are kept in large arena blocks so that interning
+ * does not allocate per string. The pool is used as a symbol table
+ * for chromosome names and region names.
+ */
+class StringPool
+{
+public:
+    
+    /// Init to empty
+    StringPool();
+    
+    /// Copying re-interns the strings into a new arena
+    StringPool(const StringPool& other);
+    StringPool& operator=(const StringPool& other);
+    
+    StringPool(StringPool&&) = default;
+    StringPool& operator=(StringPool&&) = default;
+    
+    /**
+     * Inits a pool that refers to strings stored elsewhere, e.g. in a memory-mapped file.
+     * The strings are not copied. When a new string is interned, the pool indexes 
+     * the external strings, which stay where they are.
+     * \param storage keeps the external strings alive as long as the pool needs them
+     * \param chars the characters of the strings
+     * \param offsets /count/+1 offsets into /chars/, the string with the ID /i/
+     *  is [chars+offsets[i], chars+offsets[i+1])
+     * \param count the number of strings, they must be distinct
+     */
+    StringPool(std::shared_ptr<const void> storage, const char* chars, 
+            const std::uint64_t* offsets, unsigned int count);
+    
+    /// Interns a string.
+    /// \param str the string to be stored
+    /// \return the ID of /str/ in the pool. If /str/ has been interned before,
+    /// then the previous ID is returned and nothing is stored.
+    unsigned int intern(std::string_view str);
+    
+    /// \return the string with the ID /id/, no range checking
+    std::string_view operator[](unsigned int id) const
+    {
+        return _extoffs == nullptr? _strs[id]: 
+            std::string_view(_extchars + _extoffs[id], _extoffs[id + 1] - _extoffs[id]);
+    }
+    
+    /// \return the number of distinct strings
+    unsigned int size() const { return _extoffs == nullptr? _strs.size(): _extcnt; }
+    
+    /// \return /true/ if the pool is empty
+    bool empty() const { return size() == 0; }
+    
+    /// Forgets all strings and releases the arena
+    void clear();
+    
+private:
+    
+    char* allocate(std::size_t len);
+    void index_external();
+    
+    static const std::size_t BLOCKSIZE = 64 * 1024;
+    
+    std::vector<std::unique_ptr<char[]>> _blocks;   // the arena, BLOCKSIZE chars each
+    std::vector<std::unique_ptr<char[]>> _longblocks;   // one for each long string
+    char* _freepos;     // first free char in the last block
+    std::size_t _freelen;   // number of free chars in the last block
+    std::vector<std::string_view> _strs;  // ID ==> string, the views point into _blocks
+    std::unordered_map<std::string_view, unsigned int> _ids;    // string ==> ID
+    unsigned int _lastid;   // most recently interned ID, checked before the hash lookup
+    std::shared_ptr<const void> _storage;   // keeps the external strings alive
+    const char* _extchars;  // the external strings while they are not indexed, see ctor
+    const std::uint64_t* _extoffs;
+    unsigned int _extcnt;
+    
+    // serialization
+    friend class boost::serialization::access;
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const
+    {
+        unsigned int n = size();
+        ar << n;
+        for (unsigned int i = 0; i < n; ++i) {
+            std::string str((*this)[i]);
+            ar << str;
+        }
+    }
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version)
+    {
+        clear();
+        unsigned int n;
+        ar >> n;
+        std::string str;
+        for (unsigned int i = 0; i < n; ++i) {
+            ar >> str;
+            intern(str);
+        }
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+    
+};  // class StringPool
+
+}   // namespace multovl
+
+#endif  // MULTOVL_STRPOOL_HEADER
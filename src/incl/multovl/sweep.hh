@@ -0,0 +1,613 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#ifndef MULTOVL_SWEEP_HEADER
+#define MULTOVL_SWEEP_HEADER
+
+// == Header sweep.hh ==
+
+/// \file 
+/// \brief Building blocks of the overlap detection sweeps.
+/// These are shared by MultiOverlap and StreamOverlap,
+/// client code should not need them directly.
+/// The sweeps pass the multiregions they generate to a "sink",
+/// which is any callable that accepts a temporary MultiRegion,
+/// or only the coordinates and the multiplicity (a "counting" sink).
+/// \author agent
+/// \date 2026-10-17
+
+// -- System headers --
+
+#include <vector>
+#include <set>
+#include <memory_resource>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <limits>
+#include <type_traits>
+
+// -- Own headers --
+
+#include "multovl/reglimit.hh"
+#include "multovl/regevent.hh"
+#include "multovl/multiregion.hh"
+
+// == Classes ==
+
+namespace multovl {
+
+namespace impl {
+    /**
+     * The running set of ancestors while sweeping along a chromosome.
+     * Stores the indices of the ancestor regions in a region table,
+     * sorted so that the ancestors themselves are in ascending order
+     * (exactly as they would be in an `ancregset_t` multiset).
+     * Keeps track of how many ancestors are active per track as well,
+     * so that the number of distinct tracks is available in constant time.
+     */
+    class Ancestry
+    {
+    public:
+        
+        /// Init to empty, the indices will refer to /regions/
+        /// \param mem the internal vectors are allocated from this memory resource
+        explicit Ancestry(const ancregvec_t& regions, 
+                std::pmr::memory_resource* mem = std::pmr::get_default_resource()): 
+            _regions(regions), _idx(mem), _trackcnt(mem), _distinct(0) {}
+        
+        /// Inserts the ancestor with index /idx/ after its equals
+        void insert(unsigned int idx)
+        {
+            auto pos = std::upper_bound(_idx.begin(), _idx.end(), idx, 
+                [this](unsigned int i, unsigned int j) { return _regions.less(i, j); });
+            _idx.insert(pos, idx);
+            add_track(_regions.record(idx).track_id());
+        }
+        
+        /// Removes the ancestor with index /idx/ and all its equals
+        void erase(unsigned int idx)
+        {
+            auto range = std::equal_range(_idx.begin(), _idx.end(), idx, 
+                [this](unsigned int i, unsigned int j) { return _regions.less(i, j); });
+            for (auto it = range.first; it != range.second; ++it) {
+                remove_track(_regions.record(*it).track_id());
+            }
+            _idx.erase(range.first, range.second);
+        }
+        
+        void clear()
+        {
+            for (auto i : _idx) {
+                _trackcnt[_regions.record(i).track_id()] = 0;
+            }
+            _distinct = 0;
+            _idx.clear();
+        }
+        bool empty() const { return _idx.empty(); }
+        unsigned int size() const { return _idx.size(); }
+        
+        /// \return the record of the i-th ancestor region
+        const RegRecord& operator[](unsigned int i) const { return _regions.record(_idx[i]); }
+        
+        /// \return the index of the i-th ancestor region in the region table
+        unsigned int index(unsigned int i) const { return _idx[i]; }
+        
+        /// \return the ancestor indices, to be stored in a MultiRegion
+        MultiRegion::ancidxvec_t indices() const
+        {
+            return MultiRegion::ancidxvec_t(_idx.begin(), _idx.end());
+        }
+        
+        /// Count the distinct tracks that make up an ancestry.
+        /// \return the number of distinct tracks in the ancestry. If there were no intra-track
+        /// overlaps, then this is equal to size(), otherwise it is less because
+        /// some tracks occur in the ancestry more than once.
+        unsigned int distinct_track_count() const { return _distinct; }
+        
+    private:
+        
+        void add_track(unsigned int trackid)
+        {
+            if (trackid >= _trackcnt.size()) _trackcnt.resize(trackid + 1, 0);
+            if (_trackcnt[trackid]++ == 0) ++_distinct;
+        }
+        
+        void remove_track(unsigned int trackid)
+        {
+            if (--_trackcnt[trackid] == 0) --_distinct;
+        }
+        
+        const ancregvec_t& _regions;
+        std::pmr::vector<unsigned int> _idx;
+        std::pmr::vector<unsigned int> _trackcnt;   // active ancestors per track ID
+        unsigned int _distinct;     // number of tracks with active ancestors
+        
+    };  // class Ancestry
+    
+    /**
+     * The running tally of the ancestors while sweeping along a chromosome
+     * for sinks which need the positions and multiplicities of the overlaps only.
+     * It counts the ancestors per track but does not list them.
+     * Unlike Ancestry::erase(), erase() removes one ancestor only.
+     * This makes no difference because the copies of an ancestor end at the same position.
+     */
+    class Tally
+    {
+    public:
+        
+        /// Init to empty, the indices will refer to /regions/
+        /// \param mem the internal vector is allocated from this memory resource
+        explicit Tally(const ancregvec_t& regions,
+                std::pmr::memory_resource* mem = std::pmr::get_default_resource()): 
+            _regions(regions), _trackcnt(mem), _size(0), _distinct(0), _idxsum(0) {}
+        
+        void insert(unsigned int idx)
+        {
+            unsigned int trackid = _regions.record(idx).track_id();
+            if (trackid >= _trackcnt.size()) _trackcnt.resize(trackid + 1, 0);
+            if (_trackcnt[trackid]++ == 0) ++_distinct;
+            ++_size;
+            _idxsum += idx;
+        }
+        
+        void erase(unsigned int idx)
+        {
+            if (--_trackcnt[_regions.record(idx).track_id()] == 0) --_distinct;
+            --_size;
+            _idxsum -= idx;
+        }
+        
+        bool empty() const { return _size == 0; }
+        unsigned int size() const { return _size; }
+        unsigned int distinct_track_count() const { return _distinct; }
+        
+        /// \return the record of the only ancestor region, valid only if size() == 1
+        const RegRecord& sole() const { return _regions.record(_idxsum); }
+        
+    private:
+        
+        const ancregvec_t& _regions;
+        std::pmr::vector<unsigned int> _trackcnt;   // active ancestors per track ID
+        unsigned int _size, _distinct;
+        unsigned int _idxsum;   // sum of the active indices, wraps around harmlessly
+        
+    };  // class Tally
+    
+    /**
+     * Encapsulates the parameters according to which the generated multiregions
+     * should be filtered: the minimal overlap length, the minimal and maximal
+     * multiplicity. The solitary and intra-track settings select the sweep kernel
+     * (see OverlapSweep), the rest is checked by accept().
+     */
+    class Filter
+    {
+    public:
+        
+        /**
+         * Constructs a Filter.
+         * \param ovlen must be >=1, adjusted silently
+         * \param minmult minimal multiplicity, must be >=1 
+         * \param maxmult must be >=0, 0 means any multiplicity >= minmult is accepted; 
+         * if /minmult/ > /maxmult/ then they are swapped silently
+         * \param checksoli if /true/, then only solitary regions will be accepted
+         * if /minmult/ == 1
+         * (this sets /intrack/ to /true/, and /ovlen/ to 1)
+         * \param intrack if /true/, then overlaps within the same track are accepted as well,
+         * otherwise overlaps within the same track only are filtered out.
+         * \param ext the extension of the ancestor region limits
+         */
+        Filter(unsigned int ovlen, unsigned int minmult, 
+                unsigned int maxmult, bool checksoli, bool intrack=true,
+                unsigned int ext=0):
+            _ovlen((ovlen<1)? 1: ovlen),
+            _minmult((minmult<1)? 1: minmult),
+            _maxmult(maxmult), _ext(ext), _intrack(intrack)
+        {
+            // silent swapping: note _maxmult == 0 means _maxmult == infinity
+            if (_maxmult > 0 && _minmult > _maxmult) std::swap(_minmult, _maxmult);
+            if (_maxmult == 0) _maxmult = std::numeric_limits<unsigned int>::max();
+    
+            // do we detect solitary regions?
+            _solitary = checksoli && minmult == 1;
+            if (_solitary)
+            {
+                _ovlen = 1;   // longer ovlen wouldn't make sense
+                _intrack = true;   // do check intra-track overlaps
+            }
+        }
+        
+        /**
+         * Checks the length and the multiplicity of a "nascent" multiregion (not yet constructed).
+         * \param mrstart the first position of the new multiregion
+         * \param mrend the last position of the new multiregion
+         * \param mult the multiplicity of the new multiregion
+         * \return /true/ if the multiregion may be accepted.
+         */
+        bool accept(unsigned int mrstart, unsigned int mrend, unsigned int mult) const
+        {
+            return (_minmult <= mult && mult <= _maxmult && mrend - mrstart + 1 >= _ovlen);
+        }
+        
+        /// \return /true/ if solitary regions are detected
+        bool solitary() const { return _solitary; }
+        
+        /// \return /true/ if overlaps within the same track are accepted
+        bool intrack() const { return _intrack; }
+        
+        /// \return the extension of the ancestor region limits
+        unsigned int extension() const { return _ext; }
+            
+    private:
+        
+        unsigned int _ovlen, _minmult, _maxmult, _ext;
+        bool _solitary, _intrack;
+        
+    };  // class Filter
+
+    /// The default sink which appends the multiregions to a vector.
+    class AppendSink
+    {
+    public:
+        
+        explicit AppendSink(std::vector<MultiRegion>& multiregions): _multiregions(multiregions) {}
+        
+        void operator()(MultiRegion&& mr) { _multiregions.push_back(std::move(mr)); }
+        
+    private:
+        
+        std::vector<MultiRegion>& _multiregions;
+        
+    };  // class AppendSink
+    
+    /// A "counting" sink is invoked as `sink(first, last, mult)` instead of with a MultiRegion.
+    /// The sweeps need not keep track of the ancestors for such sinks.
+    template <class Sink>
+    struct is_counting_sink:
+        std::is_invocable<Sink&, unsigned int, unsigned int, unsigned int>
+    {};
+    
+    /**
+     * The sweep kernel of multiple overlap detection. It implements what happens 
+     * at each region limit while sweeping along a chromosome. The sweep engines
+     * (RegLimit multiset or flat event array) feed the region limits
+     * in sorted order into an OverlapSweep object.
+     * \param Sink the type of the sink the accepted multiregions are passed to.
+     * If it is a reference type, then the sink object is not copied.
+     * \param Solitary /true/ if solitary regions are detected (implies /Intrack/)
+     * \param Intrack /true/ if overlaps within the same track are accepted
+     * \sa run_overlap_sweep() which picks the right kernel for a Filter
+     */
+    template <class Sink, bool Solitary, bool Intrack>
+    class OverlapSweep
+    {
+    public:
+        
+        /// Init with a filter, the region table the ancestor indices refer to,
+        /// and the sink the results are passed to.
+        /// The running set of ancestors is allocated from /mem/.
+        OverlapSweep(const Filter& filter, const ancregpool_t& regions, Sink sink,
+                std::pmr::memory_resource* mem = std::pmr::get_default_resource()):
+            _filter(filter), _regions(regions), _sink(std::forward<Sink>(sink)), 
+            _ancestors(*regions, mem),
+            _mrstart(0), _mrend(0), _regcount(0), _istempthere(false)
+        {}
+        
+        /// The ancestor region with index /idx/ starts at /pos/
+        void first_limit(unsigned int pos, unsigned int idx)
+        {
+#ifndef NDEBUG
+            debug_limit(pos, idx, true);
+#endif
+            // Region starts here
+            // finish prev region if applicable, 1 pos before current
+            // and start new one at current pos
+            if (_istempthere && pos > _mrstart)
+            {
+                emit(pos-1);
+            }
+            _mrstart = pos;
+            _ancestors.insert(idx);   // save ancestor
+#ifndef NDEBUG
+            std::cerr << "** mrstart = " << pos << std::endl;
+            std::cerr << "** save ancestor: " << _regions->to_attrstring(idx) << std::endl;
+            std::cerr << "** ancestorcnt = " << _ancestors.size() << std::endl;
+#endif
+            _istempthere = true;
+        }
+        
+        /// The ancestor region with index /idx/ ends at /pos/
+        void last_limit(unsigned int pos, unsigned int idx)
+        {
+#ifndef NDEBUG
+            debug_limit(pos, idx, false);
+#endif
+            // region ends here
+            // finish prev region if applicable at current pos
+            // start new one at current pos+1 if Idset is not empty
+            if (_istempthere && _mrend < pos)
+            {
+                emit(pos);
+                _mrstart = pos+1;
+            }
+            
+            // remove the ancestor (all copies of it)
+            _ancestors.erase(idx);
+            _istempthere = !_ancestors.empty();
+        }
+        
+        /// \return the number of multiregions generated so far
+        unsigned int region_count() const { return _regcount; }
+        
+    private:
+        
+        static constexpr bool COUNTING = is_counting_sink<Sink>::value;
+        typedef typename std::conditional<COUNTING, Tally, Ancestry>::type pileup_t;
+        
+        // Finishes the current multiregion at /mrend/ and passes it on if it is accepted
+        void emit(unsigned int mrend)
+        {
+            _mrend = mrend;
+            unsigned int mult = _ancestors.size();
+            if constexpr (Solitary)
+            {
+                // solitary region required
+                // accept if there is only one ancestor with equal position
+                if (mult == 1)
+                {
+                    const RegRecord& anc = sole();
+                    if (anc.extended_first(_filter.extension()) == _mrstart && 
+                            anc.extended_last(_filter.extension()) == _mrend)
+                        pass(mult);
+                    return;
+                }
+            }
+            if constexpr (!Intrack)
+            {
+                // do not accept overlaps within the same track only
+                // otherwise use the number of distinct tracks contributing to the overlap
+                // as multiplicity (a lame workaround for track-filtered complex overlaps)
+                mult = _ancestors.distinct_track_count();
+                if (mult == 1)
+                    return;
+            }
+            if (_filter.accept(_mrstart, _mrend, mult))
+                pass(mult);
+        }
+        
+        void pass(unsigned int mult)
+        {
+            if constexpr (COUNTING)
+                _sink(_mrstart, _mrend, mult);
+            else
+                _sink(MultiRegion(_mrstart, _mrend, _regions, _ancestors.indices(), 
+                    mult, _filter.extension()));
+            ++_regcount;
+        }
+        
+        const RegRecord& sole() const
+        {
+            if constexpr (COUNTING)
+                return _ancestors.sole();
+            else
+                return _ancestors[0];
+        }
+        
+#ifndef NDEBUG
+        void debug_limit(unsigned int pos, unsigned int idx, bool isfirst) const
+        {
+            const RegRecord& anc = _regions->record(idx);
+            std::cerr << "** pos = " << pos << ", other = " << (isfirst? 
+                anc.extended_last(_filter.extension()): anc.extended_first(_filter.extension()))
+                <<": track = " << anc.track_id() << " isfirst = " << isfirst << ": ";
+            if constexpr (!COUNTING) {
+                for (unsigned int i = 0; i < _ancestors.size(); ++i) {
+                    std::cerr << _regions->to_attrstring(_ancestors.index(i)) << '|';
+                }
+            }
+            std::cerr << std::endl;
+        }
+#endif
+        
+        const Filter& _filter;
+        const ancregpool_t& _regions;
+        Sink _sink;
+        pileup_t _ancestors;  // running set of ancestors
+        unsigned int _mrstart, _mrend, _regcount;
+        bool _istempthere;
+        
+    };  // class OverlapSweep
+    
+    /**
+     * The sweep kernel of union overlap detection. 
+     * Only the current multiplicity is needed while sweeping,
+     * the ancestors of a union are just collected and sorted once when the union is complete.
+     * \sa OverlapSweep
+     */
+    template <class Sink>
+    class UnionSweep
+    {
+    public:
+        
+        /// Init with a filter, the region table the ancestor indices refer to,
+        /// and the sink the results are passed to.
+        /// The ancestors of the current union are collected in memory allocated from /mem/.
+        UnionSweep(const Filter& filter, const ancregpool_t& regions, Sink sink,
+                std::pmr::memory_resource* mem = std::pmr::get_default_resource()):
+            _filter(filter), _regions(regions), _sink(std::forward<Sink>(sink)), 
+            _ancidx(mem),
+            _mrstart(0), _mult(0), _multmax(0), _regcount(0)
+        {}
+        
+        /// The ancestor region with index /idx/ starts at /pos/
+        void first_limit(unsigned int pos, unsigned int idx)
+        {
+#ifndef NDEBUG
+            debug_limit(pos, idx, true);
+#endif
+            // Region starts here
+            if (_mult == 0)   // remember if a new union region is started here
+                _mrstart = pos;
+            if constexpr (!COUNTING)
+                _ancidx.push_back(idx);   // save ancestor
+            _mult += 1;  // add to (maximal) multiplicity
+            if (_mult > _multmax) _multmax = _mult;
+        }
+        
+        /// The ancestor region with index /idx/ ends at /pos/
+        void last_limit(unsigned int pos, unsigned int idx)
+        {
+#ifndef NDEBUG
+            debug_limit(pos, idx, false);
+#endif
+            // region ends here
+            _mult -= 1;
+            // finish if there are no overlapping regions left
+            if (_mult == 0)
+            {
+                // check if this currently ended region needs to be saved
+                if (_filter.accept(_mrstart, pos, _multmax))
+                {
+                    pass(pos);
+                    ++_regcount;
+                }
+                
+                // forget multiplicity, ancestors
+                _multmax = 0;
+                _ancidx.clear();
+            }
+        }
+        
+        /// \return the number of union multiregions generated so far
+        unsigned int region_count() const { return _regcount; }
+        
+    private:
+        
+        static constexpr bool COUNTING = is_counting_sink<Sink>::value;
+        
+        void pass(unsigned int mrend)
+        {
+            if constexpr (COUNTING) {
+                _sink(_mrstart, mrend, _multmax);
+            } else {
+                // the ancestors of a MultiRegion are sorted, equal ones in the order of insertion
+                const ancregvec_t& regions = *_regions;
+                std::stable_sort(_ancidx.begin(), _ancidx.end(), 
+                    [&regions](unsigned int i, unsigned int j) { return regions.less(i, j); });
+                _sink(MultiRegion(_mrstart, mrend, _regions, 
+                    MultiRegion::ancidxvec_t(_ancidx.begin(), _ancidx.end()), 
+                    _multmax, _filter.extension()));
+            }
+        }
+        
+#ifndef NDEBUG
+        void debug_limit(unsigned int pos, unsigned int idx, bool isfirst) const
+        {
+            const RegRecord& anc = _regions->record(idx);
+            std::cerr << "** pos = " << pos << ", other = " << (isfirst? 
+                anc.extended_last(_filter.extension()): anc.extended_first(_filter.extension()))
+                <<": track = " << anc.track_id() << " isfirst = " << isfirst 
+                << ": mult = " << _mult << std::endl;
+        }
+#endif
+        
+        const Filter& _filter;
+        const ancregpool_t& _regions;
+        Sink _sink;
+        std::pmr::vector<unsigned int> _ancidx; // the ancestors of the current union
+        unsigned int _mrstart, _mult, _multmax, _regcount;
+        
+    };  // class UnionSweep
+    
+    /**
+     * Picks the OverlapSweep kernel matching the settings of /filter/ and runs it.
+     * \param filter the overlap filter
+     * \param regions the region table the indices refer to
+     * \param sink the multiregions are passed to this
+     * \param feed a callable which is invoked with the kernel as argument,
+     * it should feed the sorted region limits into it 
+     * (e.g. a lambda calling sweep_reglims() or sweep_events()).
+     * \param mem the memory resource of the kernel's running set of ancestors
+     * \return the number of multiregions generated
+     */
+    template <class Sink, class Feed>
+    unsigned int run_overlap_sweep(const Filter& filter, const ancregpool_t& regions, 
+        Sink&& sink, Feed feed, 
+        std::pmr::memory_resource* mem = std::pmr::get_default_resource())
+    {
+        if (filter.solitary()) {
+            OverlapSweep<Sink, true, true> sweep(filter, regions, std::forward<Sink>(sink), mem);
+            feed(sweep);
+            return sweep.region_count();
+        } else if (filter.intrack()) {
+            OverlapSweep<Sink, false, true> sweep(filter, regions, std::forward<Sink>(sink), mem);
+            feed(sweep);
+            return sweep.region_count();
+        } else {
+            OverlapSweep<Sink, false, false> sweep(filter, regions, std::forward<Sink>(sink), mem);
+            feed(sweep);
+            return sweep.region_count();
+        }
+    }
+    
+    // Feeds the limits stored in a RegLimit multiset into a sweep object.
+    template <class Sweep>
+    void sweep_reglims(const std::pmr::multiset<RegLimit>& reglims, Sweep& sweep)
+    {
+        // the multiset is ordered by position, "first" limits before "last" limits
+        for (const auto& rl : reglims) {
+            if (rl.is_first())
+                sweep.first_limit(rl.this_pos(), rl.index());
+            else
+                sweep.last_limit(rl.this_pos(), rl.index());
+        }
+    }
+    
+    // Feeds the limits stored in a sorted RegEvent vector into a sweep object.
+    template <class Sweep>
+    void sweep_events(const std::vector<RegEvent>& events, Sweep& sweep)
+    {
+        for (const auto& ev : events) {
+            if (ev.is_first())
+                sweep.first_limit(ev.pos(), ev.index());
+            else
+                sweep.last_limit(ev.pos(), ev.index());
+        }
+    }
+
+}   // namespace impl
+
+}   // namespace multovl
+
+#endif  // MULTOVL_SWEEP_HEADER
@@ -61,7 +61,7 @@ unsigned int AncestorRegion::track_id(unsigned int trackid)
 
 bool AncestorRegion::operator==(const AncestorRegion& rhs) const
 {
-    return (static_cast<Region>(*this) == static_cast<Region>(rhs) &&
+    return (static_cast<const Region&>(*this) == static_cast<const Region&>(rhs) &&
         this->track_id() == rhs.track_id() &&
         this->is_shuffleable() == rhs.is_shuffleable());
 }
@@ -70,7 +70,8 @@ bool AncestorRegion::operator<(const AncestorRegion& rhs) const
 {
     return track_id() < rhs.track_id()
         ||
-        (track_id() == rhs.track_id() && static_cast<Region>(*this) < static_cast<Region>(rhs));
+        (track_id() == rhs.track_id() && 
+            static_cast<const Region&>(*this) < static_cast<const Region&>(rhs));
 }
 
 std::string AncestorRegion::to_attrstring() const
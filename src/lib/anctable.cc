@@ -0,0 +1,135 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == Module anctable.cc ==
+
+// -- Own header --
+
+#include "multovl/anctable.hh"
+
+// == Implementation ==
+
+namespace multovl {
+
+void AncestorTable::push_back(const BaseRegion& reg, unsigned int trackid, bool shuffleable)
+{
+    unsigned int nameid = intern_name(reg.name());
+    own_records().emplace_back(reg.first(), reg.last(), reg.strand(), 
+        trackid, shuffleable, nameid);
+}
+
+void AncestorTable::assign(unsigned int i, const BaseRegion& reg, unsigned int trackid, bool shuffleable)
+{
+    unsigned int nameid = intern_name(reg.name());
+    own_records()[i] = RegRecord(reg.first(), reg.last(), reg.strand(), trackid, shuffleable, nameid);
+}
+
+AncestorRegion AncestorTable::operator[](unsigned int i) const
+{
+    const RegRecord& rec = record(i);
+    return AncestorRegion(rec.first(), rec.last(), rec.strand(), std::string(name(i)), 
+        rec.track_id(), rec.is_shuffleable());
+}
+
+void AncestorTable::clear()
+{
+    _records.clear();
+    _storage.reset();
+    _extrecs = nullptr;
+    _extcnt = 0;
+    if (_names.use_count() > 1)
+        _names = std::make_shared<StringPool>();
+    else
+        _names->clear();
+}
+
+void AncestorTable::compact_names()
+{
+    auto names = std::make_shared<StringPool>();
+    for (auto& rec : own_records()) {
+        unsigned int nameid = names->intern((*_names)[rec.name_id()]);
+        rec = RegRecord(rec.first(), rec.last(), rec.strand(), 
+            rec.track_id(), rec.is_shuffleable(), nameid);
+    }
+    _names = names;
+}
+
+// Returns the record vector, copies the external records into it first if necessary.
+// Private
+std::vector<RegRecord>& AncestorTable::own_records()
+{
+    if (_extrecs != nullptr) {
+        _records.assign(_extrecs, _extrecs + _extcnt);
+        _storage.reset();
+        _extrecs = nullptr;
+        _extcnt = 0;
+    }
+    return _records;
+}
+
+// Returns a name pool that is not shared with other tables,
+// copies the shared one if necessary.
+// Private
+StringPool& AncestorTable::own_names()
+{
+    if (_names.use_count() > 1)
+        _names = std::make_shared<StringPool>(*_names);
+    return *_names;
+}
+
+// Interns /name/ in the name pool and returns its handle.
+// Private
+unsigned int AncestorTable::intern_name(const std::string& name)
+{
+    unsigned int nameid = own_names().intern(name);
+    RegRecord::check_size(nameid + 1);
+    return nameid;
+}
+
+std::string AncestorTable::to_attrstring(unsigned int i) const
+{
+    const RegRecord& rec = record(i);
+    std::string astr = std::to_string(rec.track_id());
+    astr += ':';
+    astr += name(i);
+    astr += ':';
+    astr += rec.strand();
+    astr += ':';
+    astr += std::to_string(rec.first());
+    astr += '-';
+    astr += std::to_string(rec.last());
+    return astr;
+}
+
+}   // namespace multovl
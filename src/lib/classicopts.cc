@@ -46,6 +46,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Boost headers --
 
 #include "boost/algorithm/string/case_conv.hpp"
+#include "boost/lexical_cast.hpp"
 
 // == Implementation ==
 
@@ -59,15 +60,42 @@ ClassicOpts::ClassicOpts():
 	add_option<std::string>("output", &_output, "", 
 		"Output file, format BED or GFF, auto-detected from extension, standard output in GFF format if omitted", 'o');
 	add_option<std::string>("save", &_saveto, "", 
-		"Save program data to archive file, default: do not save");
+		"Save program data to snapshot file, default: do not save");
 	add_option<std::string>("load", &_loadfrom, "", 
-		"Load program data from archive file, default: do not load");
+		"Load program data from snapshot file, default: do not load");
+	add_option<unsigned int>("threads", &_threads, 1, 
+		"Number of threads parsing large input files, detecting overlaps on different chromosomes and formatting the output, default 1, 0 means use all cores", 'T');
+	add_bool_switch("sorted", &_sorted,
+		"Input files are sorted by chromosome name and start position (as with 'sort -k1,1 -k2,2n'), stream them using little memory. Cannot be combined with --save, --load, -T");
+	add_option<unsigned int>("membudget", &_membudget, 0,
+		"Memory budget in megabytes for inputs larger than the memory: spill the regions to temporary files and process one chromosome at a time, default 0 = keep everything in memory. Cannot be combined with --sorted, --save, --load, -T");
 }
 
 bool ClassicOpts::check_variables()
 {
 	MultovlOptbase::check_variables();
 	
+	// streaming keeps nothing in memory that could be saved or loaded,
+	// and there is only one stream to process
+	if (_sorted) {
+	    if (_saveto != "" || _loadfrom != "")
+	        add_error("The --sorted switch cannot be combined with --save or --load");
+	    if (_threads != 1)
+	        add_error("The --sorted switch cannot be combined with -T");
+	}
+	
+	// the spilled chromosomes are processed one after the other
+	if (_membudget > 0) {
+	    if (_sorted || _saveto != "" || _loadfrom != "")
+	        add_error("The --membudget option cannot be combined with --sorted, --save or --load");
+	    if (_threads != 1)
+	        add_error("The --membudget option cannot be combined with -T");
+	}
+	
+	if (_threads == 0) {
+	    _threads = core_count();
+	}
+	
 	// figure out the output format: currently BED and GFF are accepted
 	_outformat = "GFF"; // default
 	if (_output != "") {
@@ -81,7 +109,7 @@ bool ClassicOpts::check_variables()
 	
     // there must be at least 1 positional param
     // unless --load has been set in which case
-    // all input comes from the archive
+    // all input comes from the snapshot
     unsigned int filecnt = pos_opts().size();
     if (_loadfrom == "" && filecnt < 1)
     {
@@ -97,6 +125,9 @@ std::string ClassicOpts::param_str() const
     if (_loadfrom != "") outstr += " --load " + _loadfrom;
     if (_saveto != "") outstr += " --save " + _saveto;
     if (_output != "") outstr += " -o " + _output;
+    if (_threads > 1) outstr += " -T " + boost::lexical_cast<std::string>(_threads);
+    if (_sorted) outstr += " --sorted";
+    if (_membudget > 0) outstr += " --membudget " + boost::lexical_cast<std::string>(_membudget);
     return outstr;
 }
 
@@ -104,7 +135,7 @@ std::ostream& ClassicOpts::print_help(std::ostream& out) const
 {
 	out << "Multiple Chromosome / Multiple Region Overlaps" << std::endl
 		<< "Usage: multovl [options] [<infile1> [ <infile2> ... ]]" << std::endl
-		<< "Accepted input file formats: BED, GFF/GTF, BAM (detected from extension)" << std::endl
+		<< "Accepted input file formats: BED, GFF/GTF (optionally gzipped), BAM, MTB (detected from extension)" << std::endl
         << "<infileX> arguments are ignored if --load is set" << std::endl
 		<< "Output goes to stdout in GFF format by default, specify output file with the -o option" << std::endl;
 	Polite::print_help(out);
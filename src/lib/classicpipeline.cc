@@ -39,46 +39,32 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "multovl/classicpipeline.hh"
 #include "multovl/io/fileio.hh"
 #include "multovl/multioverlap.hh"
+#include "multovl/streamoverlap.hh"
 #include "multovl/baseregion.hh"
-#include "multovl/io/linewriter.hh"
+#include "multovl/io/outbuffer.hh"
+#include "multovl/io/snapshot.hh"
 #include "multovl/config.hh"
 
-// -- Boost headers --
-
-#include <boost/archive/binary_oarchive.hpp>    // serialization
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/archive/archive_exception.hpp>
-#include <boost/serialization/string.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/serialization/map.hpp>
-
 // -- Standard headers --
 
 #include <fstream>
 #include <ctime>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 // == Implementation ==
 
-// -- Serialization --
-
-namespace boost {
-namespace serialization {
-
-// Non-intrusive serialization for the Input struct
-template<class Archive>
-void serialize(Archive& ar, multovl::ClassicPipeline::Input& inp, const unsigned int version)
-{
-    ar & inp.name & inp.trackid & inp.regcnt;
-}
-
-}   // namespace serialization
-}   // namespace boost
-
 // -- ClassicPipeline methods --
 
 namespace multovl {
 
-ClassicPipeline::ClassicPipeline(int argc, char* argv[])
+ClassicPipeline::ClassicPipeline(int argc, char* argv[]):
+    _outp(nullptr)
 {
     set_optpimpl(new ClassicOpts());
     opt_ptr()->process_commandline(argc, argv); // exits on error or help request
@@ -91,17 +77,14 @@ unsigned int ClassicPipeline::read_input()
     unsigned int trackcnt = 0;
     if (opt_ptr()->load_from() != "")
     {
-        // read input data from a previously saved archive
-        try {
-            std::ifstream ifs(opt_ptr()->load_from().c_str());
-            boost::archive::binary_iarchive ia(ifs);
-            ia >> inputs() >> cmovl();
-            trackcnt = inputs().size();
-        } catch (const boost::archive::archive_exception& aex)
-        {
-            add_error("Cannot load archive", std::string(aex.what()));
-            return 0;
-        }
+        // map a previously saved snapshot, the regions are used in place
+        trackcnt = load_snapshot();
+    } else if (opt_ptr()->sorted()) {
+        // the sorted tracks will be read while detecting the overlaps
+        trackcnt = open_sorted_tracks();
+    } else if (opt_ptr()->membudget() > 0) {
+        // the regions are kept in temporary files until the overlaps are detected
+        trackcnt = spill_tracks();
     } else {
         // read tracks from cmdline arg files
         trackcnt = read_tracks();
@@ -109,6 +92,30 @@ unsigned int ClassicPipeline::read_input()
     return trackcnt;
 }
 
+// Map the snapshot file specified by the --load option (private)
+unsigned int ClassicPipeline::load_snapshot()
+{
+    io::SnapshotReader snapshot(opt_ptr()->load_from());
+    if (snapshot.error() != "")
+    {
+        add_error("Cannot load snapshot", snapshot.error());
+        return 0;
+    }
+    for (unsigned int i = 0; i < snapshot.input_count(); ++i)
+    {
+        auto snapinp = snapshot.input(i);
+        Input inp{std::string(snapinp.name)};
+        inp.trackid = snapinp.trackid;
+        inp.regcnt = snapinp.regcnt;
+        inputs().push_back(inp);
+    }
+    for (unsigned int i = 0; i < snapshot.chrom_count(); ++i)
+    {
+        cmovl().emplace(std::string(snapshot.chrom(i)), MultiOverlap(snapshot.regions(i)));
+    }
+    return inputs().size();
+}
+
 // Read tracks from separate files specified as pos args on the command line (private)
 unsigned int ClassicPipeline::read_tracks()
 {
@@ -116,10 +123,35 @@ unsigned int ClassicPipeline::read_tracks()
     const str_vec& inputfiles = opt_ptr()->input_files();
     unsigned int trackid = 0;   // current ID, will be equal to the number of OK tracks on return
     
-    for (const auto& inf : inputfiles) {
-        Input currinp(inf);
-        io::FileReader reader(currinp.name);    // automatic format detection
-        if (!reader.errors().ok())
+    // With several threads the track files are read concurrently into memory first,
+    // then they are added one after the other in command-line order
+    // so that the track IDs and the problem reports are the same as in the serial case.
+    // Otherwise the regions are added while reading.
+    std::vector<io::LoadedTrack> loaded;
+    if (opt_ptr()->threads() > 1)
+        loaded = io::read_all_tracks(inputfiles, opt_ptr()->threads(), opt_ptr()->chroms(),
+            opt_ptr()->cachedir());
+    
+    // the chromosome names are interned, their IDs index the MultiOverlap objects
+    StringPool chroms;
+    std::vector<MultiOverlap*> chrommovls;
+    for (std::size_t i = 0; i < inputfiles.size(); ++i) {
+        Input currinp(inputfiles[i]);
+        io::LoadedTrack track;
+        if (loaded.empty())
+        {
+            track.reader = std::make_unique<io::FileReader>(currinp.name,    // automatic format detection
+                io::Fileformat::UNKNOWN, opt_ptr()->cachedir());
+            track.opened = track.reader->errors().ok();
+            if (track.opened)
+                track.reader->restrict_chroms(opt_ptr()->chroms());
+        }
+        else
+        {
+            track = std::move(loaded[i]);
+        }
+        io::FileReader& reader = *track.reader;
+        if (!track.opened)
         {
             // make a note of all errors seen by the reader
             add_all_errors(reader.errors());
@@ -127,122 +159,513 @@ unsigned int ClassicPipeline::read_tracks()
             continue;
         }
         
-        std::string chrom;
-        BaseRegion reg;
-        unsigned int regcnt = 0, problemcnt = 0;
-        while (true)
-        {
-            bool ok = reader.read_into(chrom, reg);
-            if (reader.finished())
-                break;
-            if (!ok)
-            {
-                ++problemcnt;
-                continue;
-            }
-
-            chrom_multovl_map::iterator cmit = cmovl().find(chrom);
-            if (cmit != cmovl().end())
+        unsigned int regcnt = 0, problemcnt = track.problemcnt;
+        auto add_region = [this, &chroms, &chrommovls, trackid, &regcnt](
+            unsigned int chromid, const BaseRegion& reg) {
+            if (chromid < chrommovls.size())
             {
                 // this chromosome has been seen already
                 // add current region to the corresponding MultiOverlap object
-                cmit->second.add(reg, trackid+1);
+                chrommovls[chromid]->add(reg, trackid+1);
             }
             else
             {
                 // new chromosome with new MultiOverlap object
-                MultiOverlap mo(reg, trackid+1);
-                cmovl()[chrom] = mo;
+                // (the IDs are consecutive, so chromid == chrommovls.size() here)
+                auto ins = cmovl().emplace(std::string(chroms[chromid]), MultiOverlap());
+                ins.first->second.add(reg, trackid+1);
+                chrommovls.push_back(&ins.first->second);
             }
             ++regcnt;
+        };
+        
+        if (loaded.empty())
+        {
+            unsigned int chromid = 0;
+            BaseRegion reg;
+            while (true)
+            {
+                bool ok = reader.read_into(chroms, chromid, reg);
+                if (reader.finished())
+                    break;
+                if (!ok)
+                {
+                    ++problemcnt;
+                    continue;
+                }
+                add_region(chromid, reg);
+            }
         }
-        if (problemcnt > 0)
+        else
         {
-            reader.errors().print(std::cerr);    // print errors & warnings
-            add_warning("Summary",
-                boost::lexical_cast<std::string>(problemcnt) +
-                "x problem reading from file " + currinp.name
-            );
+            // the buffered regions are added in input order
+            track.regions.for_each([&chroms, &add_region](std::string_view chrom, const BaseRegion& reg) {
+                add_region(chroms.intern(chrom), reg);
+            });
+            track.regions.clear();
         }
         if (regcnt > 0)
         {
             // good input
             currinp.trackid = ++trackid;
             currinp.regcnt = regcnt;
+        }
+        // bad input has trackid,regcnt still 0
+        finish_track(reader, problemcnt, currinp);
+        inputs().push_back(currinp);
+    }
+    return trackid; // number of tracks from which at least 1 region could be read
+}
+
+// Reports the problems seen while reading a track (private)
+// \param reader the reader that has finished reading the track
+// \param problemcnt the number of regions that could not be read
+// \param input the input record of the track
+void ClassicPipeline::finish_track(const io::FileReader& reader, 
+    unsigned int problemcnt, Input& input)
+{
+    if (problemcnt > 0)
+    {
+        reader.errors().print(std::cerr);    // print errors & warnings
+        add_warning("Summary",
+            boost::lexical_cast<std::string>(problemcnt) +
+            "x problem reading from file " + input.name
+        );
+    }
+    if (input.regcnt == 0 && !reader.errors().ok())
+    {
+        add_warning("Could not read valid regions from file", input.name);
+    }
+}
+
+// Opens the sorted track files specified as pos args on the command line 
+// and reads the first region from each of them (private)
+// \return the number of tracks from which at least 1 region could be read
+unsigned int ClassicPipeline::open_sorted_tracks()
+{
+    unsigned int trackid = 0;
+    for (const auto& inf : opt_ptr()->input_files()) {
+        Input currinp(inf);
+        SortedTrack track;
+        track.reader.reset(new io::FileReader(currinp.name, io::Fileformat::UNKNOWN, opt_ptr()->cachedir()));
+        if (!track.reader->errors().ok())
+        {
+            add_all_errors(track.reader->errors());
             inputs().push_back(currinp);
             continue;
         }
-        inputs().push_back(currinp);  // bad input, with trackid,regcnt still 0
-        if (!reader.errors().ok())
+        track.reader->restrict_chroms(opt_ptr()->chroms());
+        track.trackid = 0;
+        track.inputidx = inputs().size();
+        track.problemcnt = 0;
+        inputs().push_back(currinp);
+        if (!next_sorted_region(track))
+            continue;   // no regions at all, trackid stays 0
+        track.trackid = inputs().back().trackid = ++trackid;
+        _sortedtracks.push_back(std::move(track));
+    }
+    return trackid;
+}
+
+// Reads the next region from a sorted track (private)
+// and checks whether it comes after the previous one.
+// \param track the track to be read
+// \return /true/ if a region could be read, /false/ at the end of the track
+// or if the track is not sorted (this is an error)
+bool ClassicPipeline::next_sorted_region(SortedTrack& track)
+{
+    Input& input = inputs()[track.inputidx];
+    std::string chrom;
+    BaseRegion reg;
+    while (true)
+    {
+        bool ok = track.reader->read_into(chrom, reg);
+        if (track.reader->finished())
+        {
+            finish_track(*track.reader, track.problemcnt, input);
+            return false;
+        }
+        if (!ok)
         {
-            add_warning("Could not read valid regions from file", currinp.name);
+            ++track.problemcnt;
+            continue;
         }
+        break;
     }
-    return trackid; // number of tracks from which at least 1 region could be read
+    
+    // there is a previous region if some have been counted already
+    if (input.regcnt > 0 && 
+        (chrom < track.chrom || (chrom == track.chrom && reg.first() < track.reg.first())))
+    {
+        add_error("Input file is not sorted by chromosome and start position", 
+            input.name + ": " + chrom + ':' + boost::lexical_cast<std::string>(reg.first()) + 
+            " comes after " + track.chrom + ':' + boost::lexical_cast<std::string>(track.reg.first()));
+        return false;
+    }
+    track.chrom = chrom;
+    track.reg = reg;
+    return true;
 }
 
 // Serial implementation of Multovl
 unsigned int ClassicPipeline::detect_overlaps()
 {
+    if (opt_ptr()->sorted())
+        return stream_overlaps();
+    if (opt_ptr()->membudget() > 0)
+        return spilled_overlaps();
+    
     // the overlaps are detected chromosome by chromosome
-    unsigned int totalcounts = 0;
+    unsigned int threadcnt = std::min<unsigned int>(opt_ptr()->threads(), cmovl().size());
+    if (threadcnt <= 1)
+    {
+        unsigned int totalcounts = 0;
+        for (auto& cm : cmovl()) {
+            totalcounts += detect_chrom_overlaps(cm.second);
+        }
+        return totalcounts;
+    }
+    
+    // the chromosomes are independent, so they can be processed in parallel.
+    // Start with the largest ones so that a big chromosome picked up last
+    // does not keep all the other threads waiting.
+    // The results stay in their MultiOverlap objects, so the output order
+    // is that of the chromosome map, independent of the scheduling.
+    std::vector<MultiOverlap*> movls;
+    movls.reserve(cmovl().size());
     for (auto& cm : cmovl()) {
-        MultiOverlap& movl = cm.second;      // "current overlap"
+        movls.push_back(&cm.second);
+    }
+    std::stable_sort(movls.begin(), movls.end(), 
+        [](const MultiOverlap* m1, const MultiOverlap* m2) {
+            return m1->region_count() > m2->region_count();
+        });
+    
+    std::atomic<unsigned int> nextidx(0), totalcounts(0);
+    auto worker = [this, &movls, &nextidx, &totalcounts]() {
+        unsigned int counts = 0;
+        for (unsigned int i = nextidx++; i < movls.size(); i = nextidx++) {
+            counts += detect_chrom_overlaps(*movls[i]);
+        }
+        totalcounts += counts;
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadcnt; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) { w.join(); }
+    return totalcounts;
+}
+
+// Detects the overlaps in one chromosome.
+// May run in parallel for different chromosomes.
+// \param movl the MultiOverlap object of a chromosome
+// \return the number of overlaps found
+// Private
+unsigned int ClassicPipeline::detect_chrom_overlaps(MultiOverlap& movl)
+{
+    movl.engine(opt_ptr()->flatsweep()? 
+        MultiOverlap::FLATSWEEP: MultiOverlap::TREESWEEP);
+    
+    // generate and store overlaps
+    unsigned int count;
+    if (opt_ptr()->uniregion())
+    {
+        count = movl.find_unionoverlaps(opt_ptr()->ovlen(), 
+            opt_ptr()->minmult(), opt_ptr()->maxmult(), opt_ptr()->extension());
+    }
+    else
+    {
+        count = movl.find_overlaps(opt_ptr()->ovlen(), 
+            opt_ptr()->minmult(), opt_ptr()->maxmult(), 
+            opt_ptr()->extension(), !opt_ptr()->nointrack());
+    }
+    
+    // the sweep data are not needed any more, only the overlaps are written
+    movl.release_workspace();
+    return count;
+}
+
+// Merges the sorted tracks, detects the overlaps while reading the regions,
+// and writes them immediately unless timing was requested (private)
+// \return the number of overlaps found
+unsigned int ClassicPipeline::stream_overlaps()
+{
+    std::ostream* outp = opt_ptr()->timing()? nullptr: &output_stream();
+    bool gff = (opt_ptr()->outformat() != "BED");
+    if (outp != nullptr)
+    {
+        // the input track information and the statistics go to the end
+        if (gff) write_gff_header(*outp);
+        write_param_comments(*outp);
+    }
+    unsigned int errcnt = errors().error_count();
+    
+    StreamOverlap sovl(opt_ptr()->ovlen(), opt_ptr()->minmult(), opt_ptr()->maxmult(), 
+        opt_ptr()->extension(), !opt_ptr()->nointrack(), opt_ptr()->uniregion());
+    
+    // the slots of the ancestor pool are reused, the ancestors cannot be cached
+    io::MultiregionWriter mw = gff? 
+        io::MultiregionWriter(opt_ptr()->source(), 2, false): io::MultiregionWriter(false);
+    io::OutputBuffer outbuf(outp);
+    bool started = false;
+    std::string chrom;
+    unsigned int totalcounts = 0;
+    auto write_overlaps = [this, &sovl, &mw, &outbuf, outp, &totalcounts]() {
+        for (const auto& mreg : sovl.overlaps()) {
+            _streamcounter.count(mreg);
+            if (outp != nullptr)
+                mw.write(mreg, outbuf);
+        }
+        totalcounts += sovl.overlaps().size();
+    };
+    
+    try {
+        while (errors().error_count() == errcnt)
+        {
+            // k-way merge: pick the track with the smallest current region
+            SortedTrack* next = nullptr;
+            for (auto& track : _sortedtracks) {
+                if (!track.reader)
+                    continue;   // finished already
+                if (next == nullptr || track.chrom < next->chrom ||
+                    (track.chrom == next->chrom && track.reg.first() < next->reg.first()))
+                    next = &track;
+            }
+            if (next == nullptr)
+                break;  // all tracks finished
+            
+            if (!started || next->chrom != chrom)
+            {
+                // new chromosome
+                if (started)
+                {
+                    sovl.finish();
+                    write_overlaps();
+                }
+                started = true;
+                chrom = next->chrom;
+                mw.chrom(chrom);
+            }
+            sovl.add(next->reg, next->trackid);
+            write_overlaps();
+            ++inputs()[next->inputidx].regcnt;
+            if (!next_sorted_region(*next))
+                next->reader.reset();
+        }
+        if (started)
+        {
+            sovl.finish();
+            write_overlaps();
+        }
+        outbuf.flush();
+    } catch(const std::ios_base::failure& err) {
+        add_error("Cannot write the output", err.what());
+    }
+    return totalcounts;
+}
+
+// Reads the track files specified as pos args on the command line one after the other
+// and spills their regions to per-chromosome temporary files (private)
+// \return the number of tracks from which at least 1 region could be read
+unsigned int ClassicPipeline::spill_tracks()
+{
+    _spill = std::make_unique<io::SpillStore>(std::size_t(opt_ptr()->membudget()) << 20);
+    if (_spill->error() != "")
+    {
+        add_error("Cannot spill the input regions", _spill->error());
+        return 0;
+    }
+    
+    unsigned int trackid = 0;
+    for (const auto& inf : opt_ptr()->input_files()) {
+        Input currinp(inf);
+        io::FileReader reader(currinp.name, io::Fileformat::UNKNOWN, opt_ptr()->cachedir());
+        if (!reader.errors().ok())
+        {
+            add_all_errors(reader.errors());
+            inputs().push_back(currinp);
+            continue;
+        }
+        reader.restrict_chroms(opt_ptr()->chroms());
         
-        // generate and store overlaps
-        if (opt_ptr()->uniregion())
+        unsigned int regcnt = 0, problemcnt = 0;
+        std::string chrom;
+        BaseRegion reg;
+        while (true)
         {
-            totalcounts += movl.find_unionoverlaps(opt_ptr()->ovlen(), 
-                opt_ptr()->minmult(), opt_ptr()->maxmult(), opt_ptr()->extension());
+            bool ok = reader.read_into(chrom, reg);
+            if (reader.finished())
+                break;
+            if (!ok)
+            {
+                ++problemcnt;
+                continue;
+            }
+            if (!_spill->add(chrom, reg, trackid + 1))
+            {
+                add_error("Cannot spill the input regions", _spill->error());
+                return 0;
+            }
+            ++regcnt;
         }
-        else
+        if (regcnt > 0)
         {
-            totalcounts += movl.find_overlaps(opt_ptr()->ovlen(), 
-                opt_ptr()->minmult(), opt_ptr()->maxmult(), 
-                opt_ptr()->extension(), !opt_ptr()->nointrack());
+            currinp.trackid = ++trackid;
+            currinp.regcnt = regcnt;
         }
+        finish_track(reader, problemcnt, currinp);
+        inputs().push_back(currinp);
+    }
+    if (!_spill->flush())
+    {
+        add_error("Cannot spill the input regions", _spill->error());
+        return 0;
     }
+    return trackid;
+}
+
+// Detects the overlaps of the spilled regions chromosome by chromosome 
+// and writes them immediately unless timing was requested (private).
+// A chromosome whose regions fit into the memory budget is processed by a MultiOverlap object,
+// a larger one is sorted externally and streamed through a StreamOverlap object.
+// The results are the same either way.
+// \return the number of overlaps found
+unsigned int ClassicPipeline::spilled_overlaps()
+{
+    // a rough upper estimate of the memory a region needs in a MultiOverlap object
+    // together with its share of the sweep workspace and the overlaps
+    const std::uint64_t REGION_MEMORY = 256;
+    
+    std::ostream* outp = opt_ptr()->timing()? nullptr: &output_stream();
+    bool gff = (opt_ptr()->outformat() != "BED");
+    if (outp != nullptr)
+    {
+        // the input track information and the statistics go to the end
+        if (gff) write_gff_header(*outp);
+        write_param_comments(*outp);
+    }
+    
+    std::uint64_t budget = std::uint64_t(opt_ptr()->membudget()) << 20;
+    io::OutputBuffer outbuf(outp);
+    unsigned int totalcounts = 0;
+    try {
+        for (const auto& chrom : _spill->chroms()) {
+            bool inmemory = (_spill->region_count(chrom) * REGION_MEMORY + _spill->byte_count(chrom) <= budget);
+            
+            // the ancestors can be cached only if they are all kept in memory
+            io::MultiregionWriter mw = gff? 
+                io::MultiregionWriter(opt_ptr()->source(), 2, inmemory): io::MultiregionWriter(inmemory);
+            mw.chrom(chrom);
+            auto write_overlaps = [this, &mw, &outbuf, outp, &totalcounts](const MultiOverlap::multiregvec_t& mregs) {
+                for (const auto& mreg : mregs) {
+                    _streamcounter.count(mreg);
+                    if (outp != nullptr)
+                        mw.write(mreg, outbuf);
+                }
+                totalcounts += mregs.size();
+            };
+            
+            bool ok;
+            if (inmemory)
+            {
+                MultiOverlap movl;
+                ok = _spill->read(chrom, [&movl](const BaseRegion& reg, unsigned int trackid) {
+                    movl.add(reg, trackid);
+                });
+                detect_chrom_overlaps(movl);
+                write_overlaps(movl.overlaps());
+            }
+            else
+            {
+                StreamOverlap sovl(opt_ptr()->ovlen(), opt_ptr()->minmult(), opt_ptr()->maxmult(), 
+                    opt_ptr()->extension(), !opt_ptr()->nointrack(), opt_ptr()->uniregion());
+                ok = _spill->read_sorted(chrom, [&sovl, &write_overlaps](const BaseRegion& reg, unsigned int trackid) {
+                    sovl.add(reg, trackid);
+                    write_overlaps(sovl.overlaps());
+                });
+                sovl.finish();
+                write_overlaps(sovl.overlaps());
+            }
+            if (!ok)
+            {
+                add_error("Cannot read the spilled input regions", _spill->error());
+                break;
+            }
+            _spill->release(chrom);
+        }
+        outbuf.flush();
+    } catch(const std::ios_base::failure& err) {
+        add_error("Cannot write the output", err.what());
+    }
+    _spill.reset();     // removes the temporary files
     return totalcounts;
 }
 
+// Opens the output file on first use, falls back to standard output
+// if no output file was specified or it cannot be opened (private)
+// \return the output stream
+std::ostream& ClassicPipeline::output_stream()
+{
+    if (_outp == nullptr)
+    {
+        _outp = &std::cout;
+        auto outfnm = opt_ptr()->output();
+        if (outfnm != "") {
+            // write to file if it opens OK
+            try {
+                _outfile.exceptions(_outfile.failbit); // raise exceptions for failure
+                _outfile.open(outfnm);
+                _outp = &_outfile;
+            } catch(const std::ios_base::failure& err) {
+                add_error("Output goes to stdout because I cannot write to output file " + outfnm, err.what());
+            }
+        }
+    }
+    return *_outp;
+}
+
 bool ClassicPipeline::write_output()
 {
-    // save current status in archive if asked to do so
-    if (opt_ptr()->save_to() != "")
+    if (opt_ptr()->sorted() || opt_ptr()->membudget() > 0)
     {
-        // write status data to archive file
+        // the overlaps have been written already
         try {
-            std::ofstream ofs(opt_ptr()->save_to().c_str());
-            boost::archive::binary_oarchive oa(ofs);
-            
-            // Note that only the input data and the chrom=>MultiOverlap map is saved
-            // neither the results nor the parameter settings are.
-            // The idea is to load these again and re-run with possibly different settings.
-            oa << inputs() << cmovl();
-        } catch (const boost::archive::archive_exception& aex)
+            write_input_comments(output_stream(), _streamcounter);
+        } catch(const std::ios_base::failure& err) {
+            add_error("Cannot write the output", err.what());
+            return false;
+        }
+        return true;
+    }
+    
+    // save current status in a snapshot if asked to do so
+    if (opt_ptr()->save_to() != "")
+    {
+        // Note that only the input data and the regions of the chromosomes are saved,
+        // neither the results nor the parameter settings are.
+        // The idea is to load these again and re-run with possibly different settings.
+        io::SnapshotWriter snapshot;
+        for (const auto& inp : inputs())
+            snapshot.add_input(inp.name, inp.trackid, inp.regcnt);
+        for (const auto& cm : cmovl())
+            snapshot.add_chrom(cm.first, cm.second.regions());
+        if (!snapshot.write(opt_ptr()->save_to()))
         {
-            add_error("Cannot save archive", std::string(aex.what()));
+            add_error("Cannot save snapshot", opt_ptr()->save_to());
             return false;
         }
     }
     
     // write the result either to a file or to stdout
-    auto outfnm = opt_ptr()->output();
     auto outform = opt_ptr()->outformat();
     bool retval = false;
-    if (outfnm != "") {
-        // write to file if it opens OK
-        try {
-            std::ofstream outf(outfnm);
-            outf.exceptions(outf.failbit); // raise exceptions for failure
-            retval = write_result(outf, outform);
-        } catch(const std::ios_base::failure& err) {
-            add_error("Output goes to stdout because I cannot write to output file " + outfnm, err.what());
-            // fall back to stdout
-            retval = write_result(std::cout, outform);
-        }
-    } else {
-        // write to stdout
+    try {
+        retval = write_result(output_stream(), outform);
+    } catch(const std::ios_base::failure& err) {
+        add_error("Output goes to stdout because I cannot write to output file " + opt_ptr()->output(), err.what());
+        // fall back to stdout
+        _outp = &std::cout;
         retval = write_result(std::cout, outform);
     }
     return retval;
@@ -262,6 +685,19 @@ bool ClassicPipeline::write_result(std::ostream& outf, const std::string& format
 }
 
 bool ClassicPipeline::write_gff_output(std::ostream& outf)
+{
+    write_gff_header(outf);
+    
+    // MultOvl standard comments
+    write_comments(outf);
+    
+    // process each chromosome in turn
+    write_regions(outf, true);
+    return true;    // cannot really go wrong
+}
+
+// Writes the GFF2 metainfo lines. Private
+void ClassicPipeline::write_gff_header(std::ostream& outf)
 {
     // GFF2 metainfo
     outf << "##gff-version 2" << std::endl;
@@ -279,44 +715,162 @@ bool ClassicPipeline::write_gff_output(std::ostream& outf)
         << config::build_type() << " build, compiler: "
         << config::build_compiler() 
         << ", system: "<< config::build_system() << std::endl;
-    
+}
+
+bool ClassicPipeline::write_bed_output(std::ostream& outf)
+{
     // MultOvl standard comments
     write_comments(outf);
     
     // process each chromosome in turn
-    for (const auto& cm : cmovl()) {
-        io::GffLinewriter lw(
-            opt_ptr()->source(), 
-            2, cm.first
-        );    // init with chromosome
-        const MultiOverlap::multiregvec_t& mregs = cm.second.overlaps();
-        
-        // simply write the regions
-        for (const auto& mreg : mregs) {
-            outf << lw.write(mreg) << '\n';
+    write_regions(outf, false);
+    return true;    // cannot really go wrong
+}
+
+// Writes the overlaps of all chromosomes in GFF (/gff/ is true) or BED format.
+// With several threads the overlaps are formatted in parallel, see write_parallel(). Private
+void ClassicPipeline::write_regions(std::ostream& outf, bool gff)
+{
+    auto make_writer = [this, gff]() {
+        return gff? io::MultiregionWriter(opt_ptr()->source(), 2): io::MultiregionWriter();
+    };
+    
+    if (opt_ptr()->threads() > 1)
+    {
+        write_parallel(outf, make_writer);
+    }
+    else
+    {
+        io::MultiregionWriter mw = make_writer();
+        io::OutputBuffer outbuf(&outf);
+        for (const auto& cm : cmovl()) {
+            mw.chrom(cm.first);
+            for (const auto& mreg : cm.second.overlaps()) {
+                mw.write(mreg, outbuf);
+            }
         }
+        outbuf.flush();
     }
     outf << std::flush;
-    return true;    // cannot really go wrong
 }
 
-bool ClassicPipeline::write_bed_output(std::ostream& outf)
+// Formats the overlaps on several threads and writes them in chromosome order.
+// The overlaps of each chromosome are cut into chunks, and the worker threads
+// format the chunks into their own buffers, picking up the next chunk in output order.
+// The calling thread meanwhile writes the finished buffers to /outf/ in that order,
+// so that formatting and writing overlap. The workers can run ahead of the writing
+// by a few chunks only, this keeps the memory use low.
+// An exception thrown by a worker stops all threads and is rethrown here.
+// \param outf the output stream
+// \param make_writer returns a new MultiregionWriter for each worker
+// Private
+void ClassicPipeline::write_parallel(std::ostream& outf, 
+    const std::function<io::MultiregionWriter()>& make_writer)
 {
-    // MultOvl standard comments
-    write_comments(outf);
+    // the number of overlaps in one chunk
+    const unsigned int CHUNKSIZE = 1 << 14;
     
-    // process each chromosome in turn
+    struct Chunk
+    {
+        const std::string* chrom;
+        const MultiOverlap::multiregvec_t* mregs;
+        unsigned int from, to;
+        std::unique_ptr<io::OutputBuffer> buf;  // set when formatted
+    };
+    std::vector<Chunk> chunks;
     for (const auto& cm : cmovl()) {
-        io::BedLinewriter lw(cm.first); // init with chromosome
         const MultiOverlap::multiregvec_t& mregs = cm.second.overlaps();
-        
-        // simply write the regions
-        for (const auto& mreg : mregs) {
-            outf << lw.write(mreg) << '\n';
+        for (unsigned int from = 0; from < mregs.size(); from += CHUNKSIZE) {
+            unsigned int to = std::min<unsigned int>(from + CHUNKSIZE, mregs.size());
+            chunks.push_back(Chunk{&cm.first, &mregs, from, to, nullptr});
         }
     }
-    outf << std::flush;
-    return true;    // cannot really go wrong
+    
+    unsigned int threadcnt = std::min<unsigned int>(opt_ptr()->threads(), chunks.size());
+    const unsigned int AHEAD = 2 * threadcnt;
+    std::mutex mutex;
+    std::condition_variable cond;
+    unsigned int nextidx = 0, written = 0;
+    bool stop = false;
+    std::exception_ptr error;   // the first exception thrown by a worker
+    
+    auto worker = [&]() {
+        try {
+            io::MultiregionWriter mw = make_writer();
+            while (true)
+            {
+                unsigned int i;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    i = nextidx++;
+                    if (i >= chunks.size())
+                        return;
+                    cond.wait(lock, [&]() { return stop || i < written + AHEAD; });
+                    if (stop)
+                        return;
+                }
+                
+                Chunk& chunk = chunks[i];
+                auto buf = std::make_unique<io::OutputBuffer>(nullptr, 
+                    (chunk.to - chunk.from) * std::size_t(128));
+                mw.chrom(*chunk.chrom);
+                for (unsigned int r = chunk.from; r < chunk.to; ++r) {
+                    mw.write((*chunk.mregs)[r], *buf);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chunk.buf = std::move(buf);
+                }
+                cond.notify_all();
+            }
+        } catch(...) {
+            // e.g. std::bad_alloc: stop everybody, the writer rethrows it
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+            }
+            cond.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadcnt; ++t) {
+        workers.emplace_back(worker);
+    }
+    
+    auto stop_workers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cond.notify_all();
+        for (auto& w : workers) { w.join(); }
+    };
+    try {
+        for (auto& chunk : chunks) {
+            std::unique_ptr<io::OutputBuffer> buf;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&chunk, &stop]() { return stop || chunk.buf != nullptr; });
+                if (chunk.buf == nullptr)
+                    break;  // a worker failed
+                buf = std::move(chunk.buf);
+            }
+            outf.write(buf->data(), buf->size());
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++written;
+            }
+            cond.notify_all();
+        }
+    } catch(...) {
+        stop_workers();
+        throw;
+    }
+    stop_workers();
+    if (error)
+        std::rethrow_exception(error);
 }
 
 // Writes the standard MultOvl comments to stdout.
@@ -331,15 +885,28 @@ void ClassicPipeline::write_comments(std::ostream& outf)
         cm.second.overlap_stats(counter);      // "current overlap"
     }
     
+    write_param_comments(outf);
+    write_input_comments(outf, counter);
+}
+
+// Writes the command-line parameters as comments. Private
+void ClassicPipeline::write_param_comments(std::ostream& outf)
+{
     // the command-line parameters
     outf << "# Parameters = " << opt_ptr()->param_str() << '\n';
     
-    // add the input file names as comments
     if (opt_ptr()->load_from() != "")
     {
         outf << "# Input data loaded from archive = " 
             << opt_ptr()->load_from() << '\n';
     }
+}
+
+// Writes the input file names and the multiplicity statistics as comments. Private
+void ClassicPipeline::write_input_comments(std::ostream& outf, 
+    const MultiOverlap::Counter& counter)
+{
+    // add the input file names as comments
     outf << "# Input files = " << inputs().size() << '\n';
     for (const auto& inp : inputs()) {
         outf << "# " << inp.name;
@@ -0,0 +1,96 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE convopts.cc ==
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <thread>
+
+// -- Own headers --
+
+#include "multovl/convopts.hh"
+#include "multovl/config.hh"
+#include "multovl/io/fileformat.hh"
+
+// == Implementation ==
+
+namespace multovl {
+
+ConvOpts::ConvOpts():
+	Polite("Options"),
+	_input(),
+	_output()
+{
+	add_option<unsigned int>("threads", &_threads, 1, 
+		"Number of threads reading the input file, default 1, 0 means use all cores", 'T');
+}
+
+bool ConvOpts::check_variables()
+{
+	if (_threads == 0) {
+	    _threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	
+	std::vector<std::string> files = pos_opts();
+	if (files.size() != 2)
+	{
+	    add_error("Must specify one input file and one output file");
+	    return false;
+	}
+	_input = files[0];
+	_output = files[1];
+	if (io::Fileformat::from_filename(_output) != io::Fileformat::MTB)
+	    add_error("The output file name must have the extension .mtb: " + _output);
+	return (!error_status());
+}
+
+std::ostream& ConvOpts::print_help(std::ostream& out) const
+{
+	out << "Converts a track file to the binary MTB format" << std::endl
+		<< "Usage: multovlconv [options] <infile> <outfile.mtb>" << std::endl
+		<< "Accepted input file formats: BED, GFF/GTF (optionally gzipped), BAM (detected from extension)" << std::endl
+		<< "The MTB file can be used instead of <infile> by all MULTOVL programs" << std::endl;
+	Polite::print_help(out);
+	return out;
+}
+
+std::ostream& ConvOpts::version_info(std::ostream& out) const
+{
+	out << config::detailed_versioninfo(); // \n-terminated string
+	return out;
+}
+
+}   // namespace multovl
@@ -37,9 +37,85 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Own headers --
 
 #include "multovl/io/bamio.hh"
+#include "multovl/io/readahead.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+// -- Boost headers --
+
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/interprocess/exceptions.hpp"
 
 // == Implementation ==
 
+namespace {
+
+// BAM record layout, see the SAM/BAM format specification:
+// the fixed-size part of an alignment record following its block_size field
+const std::size_t BAM_CORESIZE = 32;
+const std::uint32_t BAM_FUNMAP = 0x4, BAM_FREVERSE = 0x10;
+
+inline std::uint32_t le32(const char* p)
+{
+    const unsigned char* q = reinterpret_cast<const unsigned char*>(p);
+    return q[0] | (q[1] << 8) | (q[2] << 16) | (std::uint32_t(q[3]) << 24);
+}
+
+inline unsigned int le16(const char* p)
+{
+    const unsigned char* q = reinterpret_cast<const unsigned char*>(p);
+    return q[0] | (q[1] << 8);
+}
+
+// Reads a little-endian 32-bit integer from /input/.
+// \return /false/ if the input ended
+bool read_uint32(multovl::io::Readahead& input, std::uint32_t& value)
+{
+    char buf[4];
+    if (input.read(buf, 4) != 4)
+        return false;
+    value = le32(buf);
+    return true;
+}
+
+// Skips /len/ bytes of /input/, using /buf/ as scratch space.
+// \return /false/ if the input ended
+bool skip(multovl::io::Readahead& input, std::size_t len, std::string& buf)
+{
+    buf.resize(len);
+    return (input.read(&buf[0], len) == len);
+}
+
+// \return the end position of an alignment starting at /pos/
+// calculated from its CIGAR operations like BamAlignment::GetEndPosition() does:
+// the operations M, D, N, = and X consume the reference
+std::int32_t end_position(std::int32_t pos, const char* cigar, unsigned int opcnt)
+{
+    for (unsigned int i = 0; i < opcnt; ++i)
+    {
+        std::uint32_t op = le32(cigar + 4 * i);
+        switch (op & 0xf)
+        {
+            case 0: case 2: case 3: case 7: case 8:
+                pos += op >> 4;
+                break;
+            default:
+                break;
+        }
+    }
+    return pos;
+}
+
+}   // end of unnamed namespace
+
 namespace multovl {
 namespace io {
 
@@ -47,6 +123,12 @@ namespace io {
 
 BamReader::BamReader(const std::string& infname):
     TrackReader(),
+    _infname(infname),
+    _started(false),
+    _indexed(false),
+    _inregion(false),
+    _wanted(),
+    _refqueue(),
     _bamreader(),
     _refs()
 {
@@ -70,13 +152,22 @@ std::string BamReader::read_into(std::string& chrom, BaseRegion& reg)
 {
     if (!_bamreader.IsOpen())
         return "Input file not open";
-        
-    bool ok = _bamreader.GetNextAlignmentCore(_albuf);
-    if (!ok)
-        return "EOF";   // hopefully...
+    _started = true;
+    
+    // unmapped alignments and those on unwanted chromosomes are skipped
+    while (true)
+    {
+        bool ok = next_alignment();
+        if (!ok)
+            return "EOF";   // hopefully...
+        if (_albuf.RefID >= static_cast<int32_t>(_refs.size()))
+            return "Alignment without reference sequence";
+        if (_albuf.RefID >= 0 && _albuf.IsMapped() && wanted(_albuf.RefID))
+            break;
+    }
 
     // chromosome is the reference sequence
-    chrom = _refs.at(_albuf.RefID).RefName;
+    chrom = _refs[_albuf.RefID].RefName;
     
     // coordinates
     int32_t first = _albuf.Position;
@@ -89,6 +180,154 @@ std::string BamReader::read_into(std::string& chrom, BaseRegion& reg)
     return "";  // OK
 }
 
+bool BamReader::restrict_chroms(const std::set<std::string>& chroms)
+{
+    if (chroms.empty())
+        return true;
+    _wanted.assign(_refs.size(), false);
+    for (std::size_t i = 0; i < _refs.size(); ++i)
+    {
+        _wanted[i] = (chroms.count(_refs[i].RefName) > 0);
+    }
+    if (_bamreader.IsOpen() && _bamreader.LocateIndex(BamTools::BamIndex::STANDARD))
+    {
+        _indexed = true;
+        for (int i = _refs.size() - 1; i >= 0; --i)
+        {
+            if (_wanted[i] && _refs[i].RefLength > 0)
+                _refqueue.push_back(i);
+        }
+    }
+    return true;
+}
+
+unsigned int BamReader::read_all(TrackBuffer& track, unsigned int threads)
+{
+    if (!_bamreader.IsOpen())
+        return 0;
+    if (_started || _indexed)
+        return TrackReader::read_all(track, threads);
+    _started = true;
+    
+    // map the whole compressed file into memory
+    namespace bip = boost::interprocess;
+    bip::mapped_region region;
+    std::string contents;
+    const char *first = nullptr, *last = nullptr;
+    bool mapped = false;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(_infname, ec);
+    if (!ec && size > 0)
+    {
+        try
+        {
+            bip::file_mapping mapping(_infname.c_str(), bip::read_only);
+            bip::mapped_region tmp(mapping, bip::read_only);
+            tmp.advise(bip::mapped_region::advice_sequential);
+            region.swap(tmp);
+            first = static_cast<const char*>(region.get_address());
+            last = first + region.get_size();
+            mapped = true;
+        }
+        catch (const bip::interprocess_exception&)
+        {
+            // fall back to reading
+        }
+    }
+    if (!mapped)
+    {
+        std::ifstream inf(_infname.c_str(), std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+        first = contents.data();
+        last = first + contents.size();
+    }
+    
+    // the decompressed parts are large enough to keep all threads busy
+    Readahead input(first, last, threads, std::max(1u, threads) * Readahead::PARTSIZE);
+    std::string buf;
+    
+    // skip the header: magic, SAM header text, reference sequence dictionary.
+    // The reference sequences have been read already when the file was opened.
+    std::uint32_t len = 0, refcnt = 0;
+    bool ok = skip(input, 4, buf) && buf == std::string("BAM\1", 4) &&
+        read_uint32(input, len) && skip(input, len, buf) && read_uint32(input, refcnt);
+    for (std::uint32_t i = 0; ok && i < refcnt; ++i)
+    {
+        ok = read_uint32(input, len) && skip(input, len + 4, buf);
+    }
+    if (!ok || refcnt != _refs.size())
+    {
+        add_error("Cannot read the header of input BAM file: " + _infname);
+        return 0;
+    }
+    
+    unsigned int problemcnt = 0;
+    BaseRegion reg;
+    reg.name("bam");    // we don't read it from the BAM, although we could
+    std::uint32_t blocksize;
+    while (read_uint32(input, blocksize) && blocksize > 0)
+    {
+        if (blocksize < BAM_CORESIZE || !skip(input, blocksize, buf))
+        {
+            add_error("Truncated alignment record in input BAM file: " + _infname);
+            break;
+        }
+        const char* rec = buf.data();
+        std::int32_t refid = le32(rec), pos = le32(rec + 4);
+        unsigned int namelen = static_cast<unsigned char>(rec[8]),
+            opcnt = le16(rec + 12),
+            flag = le16(rec + 14);
+        if (refid >= static_cast<int32_t>(_refs.size()) ||
+            BAM_CORESIZE + namelen + 4 * opcnt > blocksize)
+        {
+            ++problemcnt;
+            continue;
+        }
+        if (refid < 0 || (flag & BAM_FUNMAP) || !wanted(refid))
+            continue;   // skipped as by read_into()
+        reg.set_coords(pos, end_position(pos, rec + BAM_CORESIZE + namelen, opcnt));
+        reg.strand((flag & BAM_FREVERSE)? '-': '+');
+        track.add(_refs[refid].RefName, reg);
+    }
+    if (input.error() != "")
+        add_error("Cannot decompress input BAM file: " + input.error());
+    return problemcnt;
+}
+
+// Reads the next alignment into _albuf. With an index, the wanted reference
+// sequences are visited one after the other.
+// \return /false/ if there are no more alignments
+// Private
+bool BamReader::next_alignment()
+{
+    if (!_indexed)
+        return _bamreader.GetNextAlignmentCore(_albuf);
+    
+    while (true)
+    {
+        if (_inregion && _bamreader.GetNextAlignmentCore(_albuf))
+            return true;
+        
+        // no more alignments in the current region, jump to the next one
+        _inregion = false;
+        while (!_inregion && !_refqueue.empty())
+        {
+            int refid = _refqueue.back();
+            _refqueue.pop_back();
+            _inregion = _bamreader.SetRegion(refid, 0, refid, _refs[refid].RefLength);
+        }
+        if (!_inregion)
+            return false;
+    }
+}
+
+// \return /true/ if the alignments on reference sequence /refid/ are wanted
+// Private
+bool BamReader::wanted(int32_t refid) const
+{
+    return (_wanted.empty() || _wanted[refid]);
+}
+
 BamReader::~BamReader()
 {
     _bamreader.Close();
@@ -0,0 +1,451 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE binio.cc ==
+
+// -- Own header --
+
+#include "multovl/io/binio.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+// -- Boost headers --
+
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/exceptions.hpp"
+
+// == Implementation ==
+
+namespace {
+
+const char MTB_MAGIC[8] = { 'M', 'U', 'L', 'T', 'O', 'V', 'L', 'B' };
+const std::uint32_t MTB_VERSION = 1;
+const std::uint64_t MTB_HEADERLEN = 48, MTB_INDEXLEN = 56;
+
+void put_le(std::string& out, std::uint64_t value, unsigned int bytes)
+{
+    for (unsigned int i = 0; i < bytes; ++i, value >>= 8)
+        out += static_cast<char>(value & 0xFF);
+}
+
+std::uint64_t get_le(const unsigned char* p, unsigned int bytes)
+{
+    std::uint64_t value = 0;
+    for (unsigned int i = bytes; i > 0; --i)
+        value = (value << 8) | p[i - 1];
+    return value;
+}
+
+// 7 bits per byte, the high bit is set on all but the last byte
+void put_varint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// \return /false/ if the varint at /p/ runs past /end/ or is too long
+inline bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = *p++;
+        value |= std::uint64_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+// zigzag encoding maps small negative differences to small unsigned numbers
+inline std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+// -- BinaryReader methods --
+
+BinaryReader::BinaryReader(const std::string& infname):
+    TrackReader(),
+    _infname(infname),
+    _region(),
+    _buffer(),
+    _data(nullptr),
+    _size(0),
+    _chromcnt(0),
+    _indexoff(0),
+    _dictoff(0),
+    _namecnt(0),
+    _chromidx(0),
+    _cursor(),
+    _namebuf()
+{
+    if (!open(infname))
+        _chromcnt = 0;  // nothing will be read
+}
+
+std::string BinaryReader::read_into(std::string& chrom, BaseRegion& reg)
+{
+    while (_cursor.index == _cursor.regcnt)
+    {
+        if (_chromidx >= _chromcnt)
+            return "EOF";
+        if (!start_chrom(_chromidx++, _cursor))
+            return corrupt();
+    }
+    if (!next_region(_cursor, reg, _namebuf))
+        return corrupt();
+    chrom.assign(_cursor.chrom);
+    return "";
+}
+
+unsigned int BinaryReader::read_all(TrackBuffer& track, unsigned int threads)
+{
+    // finish the chromosome read_into() has started
+    BaseRegion reg;
+    while (_cursor.index < _cursor.regcnt)
+    {
+        if (!next_region(_cursor, reg, _namebuf))
+        {
+            corrupt();
+            return 1;
+        }
+        track.add(_cursor.chrom, reg);
+    }
+    
+    // the remaining chromosome blocks are independent
+    std::uint64_t first = _chromidx, chromcnt = _chromcnt - first;
+    _chromidx = _chromcnt;
+    std::vector<TrackBuffer> buffers(chromcnt);
+    std::vector<char> ok(chromcnt, 0);
+    std::atomic<std::uint64_t> next(0);
+    auto worker = [this, first, chromcnt, &buffers, &ok, &next]() {
+        Cursor cursor;
+        BaseRegion reg;
+        std::string namebuf;
+        for (std::uint64_t i = next++; i < chromcnt; i = next++)
+        {
+            if (!start_chrom(first + i, cursor))
+                continue;
+            while (cursor.index < cursor.regcnt && next_region(cursor, reg, namebuf)) {
+                buffers[i].add(cursor.chrom, reg);
+            }
+            ok[i] = (cursor.index == cursor.regcnt);
+        }
+    };
+    unsigned int threadcnt = std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads, chromcnt));
+    if (threadcnt == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threadcnt; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w : workers) { w.join(); }
+    }
+    
+    // join in file order, up to the first corrupt block
+    for (std::uint64_t i = 0; i < chromcnt; ++i)
+    {
+        if (!ok[i])
+        {
+            corrupt();
+            return 1;
+        }
+        track.append(std::move(buffers[i]));
+    }
+    return 0;
+}
+
+// Maps the input file into memory, or reads it into _buffer if that is not possible,
+// and checks the header and the name dictionary.
+// \return /true/ on success
+// Private
+bool BinaryReader::open(const std::string& infname)
+{
+    bool mapped = false;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(infname, ec);
+    if (!ec && size > 0)
+    {
+        try
+        {
+            namespace bip = boost::interprocess;
+            bip::file_mapping mapping(infname.c_str(), bip::read_only);
+            bip::mapped_region region(mapping, bip::read_only);
+            _region.swap(region);
+            _data = static_cast<const unsigned char*>(_region.get_address());
+            _size = _region.get_size();
+            mapped = true;
+        }
+        catch (const boost::interprocess::interprocess_exception&)
+        {
+            // fall back to reading
+        }
+    }
+    if (!mapped)
+    {
+        std::ifstream inf(infname.c_str(), std::ios::binary);
+        if (!inf)
+        {
+            add_error("Cannot open input file: " + infname);
+            return false;
+        }
+        _buffer.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+        _data = reinterpret_cast<const unsigned char*>(_buffer.data());
+        _size = _buffer.size();
+    }
+    
+    if (_size < MTB_HEADERLEN || !std::equal(MTB_MAGIC, MTB_MAGIC + 8, _data))
+    {
+        add_error("Not a binary track file: " + infname);
+        return false;
+    }
+    if (get_le(_data + 8, 4) != MTB_VERSION)
+    {
+        add_error("Unsupported binary track file version: " + infname);
+        return false;
+    }
+    _chromcnt = get_le(_data + 12, 4);
+    _indexoff = get_le(_data + 24, 8);
+    _dictoff = get_le(_data + 32, 8);
+    bool ok = (get_le(_data + 40, 8) == _size && _indexoff == MTB_HEADERLEN &&
+        _dictoff <= _size - 8 && _chromcnt <= (_dictoff - _indexoff) / MTB_INDEXLEN);
+    if (ok)
+    {
+        _namecnt = get_le(_data + _dictoff, 8);
+        std::uint64_t charsoff = _dictoff + 8 + 8 * (_namecnt + 1);
+        ok = (_namecnt < (_size - _dictoff) / 8 && charsoff <= _size &&
+            get_le(_data + charsoff - 8, 8) == _size - charsoff);
+    }
+    if (!ok)
+    {
+        add_error("Corrupt binary track file: " + infname);
+        return false;
+    }
+    return true;
+}
+
+// Sets up /cursor/ to decode the block of chromosome /chromidx/.
+// \return /false/ if the index entry is invalid
+// Private
+bool BinaryReader::start_chrom(std::uint64_t chromidx, Cursor& cursor) const
+{
+    const unsigned char* entry = _data + _indexoff + chromidx * MTB_INDEXLEN;
+    std::uint64_t offs[5];
+    for (unsigned int i = 0; i < 5; ++i) {
+        offs[i] = get_le(entry + 16 + 8 * i, 8);
+    }
+    cursor.index = cursor.regcnt = 0;
+    cursor.prevstart = 0;
+    std::uint64_t regcnt = get_le(entry + 8, 8);
+    bool ok = (offs[0] >= _indexoff + _chromcnt * MTB_INDEXLEN && offs[4] <= _dictoff);
+    for (unsigned int i = 1; ok && i < 5; ++i) {
+        ok = (offs[i - 1] <= offs[i]);
+    }
+    // each region takes at least 1 byte in the varint columns
+    if (!ok || regcnt > offs[1] - offs[0] || offs[3] - offs[2] < (regcnt + 3) / 4 ||
+        !name(get_le(entry, 8), cursor.chrom))
+        return false;
+    
+    cursor.starts = _data + offs[0];
+    cursor.startsend = cursor.lengths = _data + offs[1];
+    cursor.lengthsend = cursor.strands = _data + offs[2];
+    cursor.names = _data + offs[3];
+    cursor.namesend = _data + offs[4];
+    cursor.regcnt = regcnt;
+    return true;
+}
+
+// Decodes the next region of the block /cursor/ points to into /reg/,
+// /namebuf/ holds the region name temporarily.
+// \return /false/ if the block is corrupt
+// Private
+bool BinaryReader::next_region(Cursor& cursor, BaseRegion& reg, std::string& namebuf) const
+{
+    std::uint64_t delta, len, nameid;
+    if (!get_varint(cursor.starts, cursor.startsend, delta) ||
+        !get_varint(cursor.lengths, cursor.lengthsend, len) ||
+        !get_varint(cursor.names, cursor.namesend, nameid))
+        return false;
+    std::int64_t first = cursor.prevstart + unzigzag(delta);
+    std::string_view nm;
+    if (first < 0 || first > UINT_MAX || len > UINT_MAX - std::uint64_t(first) || !name(nameid, nm))
+        return false;
+    
+    static const char STRANDS[4] = { '.', '+', '-', '.' };
+    unsigned int code = (cursor.strands[cursor.index / 4] >> (2 * (cursor.index % 4))) & 3;
+    reg.set_coords(first, first + len);
+    reg.strand(STRANDS[code]);
+    namebuf.assign(nm);
+    reg.name(namebuf);
+    cursor.prevstart = first;
+    ++cursor.index;
+    return true;
+}
+
+// Looks up the name /nameid/ in the name dictionary.
+// \return /false/ if /nameid/ or its dictionary entry is invalid
+// Private
+bool BinaryReader::name(std::uint64_t nameid, std::string_view& nm) const
+{
+    if (nameid >= _namecnt)
+        return false;
+    const unsigned char* offs = _data + _dictoff + 8;
+    const char* chars = reinterpret_cast<const char*>(offs + 8 * (_namecnt + 1));
+    std::uint64_t from = get_le(offs + 8 * nameid, 8), to = get_le(offs + 8 * (nameid + 1), 8),
+        charcnt = get_le(offs + 8 * _namecnt, 8);
+    if (from > to || to > charcnt)
+        return false;
+    nm = std::string_view(chars + from, to - from);
+    return true;
+}
+
+// Records a decoding error and stops reading
+// \return the error message
+// Private
+std::string BinaryReader::corrupt()
+{
+    std::string msg = "Corrupt binary track file: " + _infname;
+    add_error(msg);
+    _chromidx = _chromcnt;
+    _cursor.index = _cursor.regcnt = 0;
+    return msg;
+}
+
+// -- BinaryWriter methods --
+
+BinaryWriter::BinaryWriter():
+    _chroms(),
+    _blocks(),
+    _names(),
+    _regcnt(0)
+{}
+
+void BinaryWriter::add(std::string_view chrom, const BaseRegion& reg)
+{
+    unsigned int chromid = _chroms.intern(chrom);
+    if (chromid == _blocks.size())
+    {
+        _blocks.emplace_back();
+        _blocks.back().nameid = _names.intern(chrom);
+    }
+    Block& block = _blocks[chromid];
+    put_varint(block.starts, zigzag(static_cast<std::int64_t>(reg.first()) - block.prevstart));
+    block.prevstart = reg.first();
+    put_varint(block.lengths, reg.last() - reg.first());
+    unsigned int slot = block.regcnt % 4;
+    if (slot == 0)
+        block.strands += '\0';
+    unsigned int code = (reg.strand() == '+')? 1: (reg.strand() == '-')? 2: 0;
+    block.strands.back() = static_cast<char>(block.strands.back() | (code << (2 * slot)));
+    put_varint(block.names, _names.intern(reg.name()));
+    ++block.regcnt;
+    ++_regcnt;
+}
+
+bool BinaryWriter::write(const std::string& outfname) const
+{
+    // lay out the blocks after the chromosome index
+    std::string index;
+    std::uint64_t offset = MTB_HEADERLEN + MTB_INDEXLEN * _blocks.size();
+    for (const auto& block : _blocks) {
+        put_le(index, block.nameid, 8);
+        put_le(index, block.regcnt, 8);
+        for (const std::string* column : { &block.starts, &block.lengths, &block.strands, &block.names }) {
+            put_le(index, offset, 8);
+            offset += column->size();
+        }
+        put_le(index, offset, 8);
+    }
+    
+    // the name dictionary
+    std::string dictoffs;
+    std::uint64_t charcnt = 0;
+    put_le(dictoffs, _names.size(), 8);
+    for (unsigned int i = 0; i < _names.size(); ++i) {
+        put_le(dictoffs, charcnt, 8);
+        charcnt += _names[i].size();
+    }
+    put_le(dictoffs, charcnt, 8);
+    
+    std::string header(MTB_MAGIC, 8);
+    put_le(header, MTB_VERSION, 4);
+    put_le(header, _blocks.size(), 4);
+    put_le(header, _regcnt, 8);
+    put_le(header, MTB_HEADERLEN, 8);
+    put_le(header, offset, 8);
+    put_le(header, offset + dictoffs.size() + charcnt, 8);
+    
+    std::ofstream out(outfname.c_str(), std::ios::binary);
+    out << header << index;
+    for (const auto& block : _blocks) {
+        out << block.starts << block.lengths << block.strands << block.names;
+    }
+    out << dictoffs;
+    for (unsigned int i = 0; i < _names.size(); ++i) {
+        out << _names[i];
+    }
+    out.close();
+    return !out.fail();
+}
+
+}   // namespace io
+}   // namespace multovl
@@ -0,0 +1,338 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE charscan.cc ==
+
+// -- Own header --
+
+#include "multovl/io/charscan.hh"
+
+// -- Standard headers --
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define MULTOVL_CHARSCAN_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// GCC and Clang can compile the AVX2 kernels without global compiler flags
+// and detect AVX2 support at runtime
+#define MULTOVL_CHARSCAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__)
+// The SSE2 kernels scan the tails of the AVX2 kernels. They must be inlined there
+// so that they are VEX-encoded, otherwise the AVX-SSE transitions cost more than the scan.
+#define MULTOVL_CHARSCAN_INLINE inline __attribute__((always_inline))
+#else
+#define MULTOVL_CHARSCAN_INLINE inline
+#endif
+
+// == Implementation ==
+
+namespace {
+
+// -- Bit twiddling --
+
+// Index of the lowest set bit of /mask/ which must not be 0
+inline unsigned int lowbit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return idx;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Number of set bits in /mask/
+inline unsigned int bitcount(unsigned int mask)
+{
+    unsigned int cnt = 0;
+    for (; mask != 0; mask &= mask - 1)
+        ++cnt;
+    return cnt;
+}
+
+// Records the positions of the set bits of /mask/ in the find_all() kernels.
+// /base/ is the offset of bit 0.
+inline void record_bits(unsigned int mask, std::uint32_t base, 
+    std::uint32_t* offsets, std::size_t maxcnt, std::size_t& cnt)
+{
+    for (; mask != 0 && cnt < maxcnt; mask &= mask - 1)
+        offsets[cnt++] = base + lowbit(mask);
+    cnt += bitcount(mask);
+}
+
+inline bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+// -- Scalar kernels --
+
+const char* find_scalar(const char* first, const char* last, char c)
+{
+    // the C library's memchr is already as fast as it gets on most platforms
+    auto pos = static_cast<const char*>(std::memchr(first, c, last - first));
+    return (pos == nullptr)? last: pos;
+}
+
+std::size_t find_all_scalar(const char* first, const char* last, char c,
+    std::uint32_t* offsets, std::size_t maxcnt)
+{
+    std::size_t cnt = 0;
+    for (const char* p = first; p < last; ++p)
+    {
+        if (*p == c)
+        {
+            if (cnt < maxcnt) offsets[cnt] = p - first;
+            ++cnt;
+        }
+    }
+    return cnt;
+}
+
+MULTOVL_CHARSCAN_INLINE
+const char* skip_blanks_scalar(const char* first, const char* last)
+{
+    while (first < last && is_blank(*first))
+        ++first;
+    return first;
+}
+
+#ifdef MULTOVL_CHARSCAN_SSE2
+
+// -- SSE2 kernels: 16 bytes at a time --
+
+MULTOVL_CHARSCAN_INLINE
+const char* find_sse2(const char* first, const char* last, char c)
+{
+    const __m128i vc = _mm_set1_epi8(c);
+    const char* p = first;
+    for (; last - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, vc));
+        if (mask != 0)
+            return p + lowbit(mask);
+    }
+    for (; p < last; ++p)
+        if (*p == c) return p;
+    return last;
+}
+
+MULTOVL_CHARSCAN_INLINE
+std::size_t find_all_sse2(const char* first, const char* last, char c,
+    std::uint32_t* offsets, std::size_t maxcnt)
+{
+    const __m128i vc = _mm_set1_epi8(c);
+    std::size_t cnt = 0;
+    const char* p = first;
+    for (; last - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, vc));
+        record_bits(mask, p - first, offsets, maxcnt, cnt);
+    }
+    for (; p < last; ++p)
+    {
+        if (*p == c)
+        {
+            if (cnt < maxcnt) offsets[cnt] = p - first;
+            ++cnt;
+        }
+    }
+    return cnt;
+}
+
+MULTOVL_CHARSCAN_INLINE
+const char* skip_blanks_sse2(const char* first, const char* last)
+{
+    const __m128i vblank = _mm_set1_epi8(' '), vtab = _mm_set1_epi8('\t'), 
+        vnl = _mm_set1_epi8('\n');
+    const char* p = first;
+    for (; last - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i isblank = _mm_or_si128(_mm_cmpeq_epi8(block, vblank), 
+            _mm_or_si128(_mm_cmpeq_epi8(block, vtab), _mm_cmpeq_epi8(block, vnl)));
+        unsigned int mask = ~_mm_movemask_epi8(isblank) & 0xFFFFu;
+        if (mask != 0)
+            return p + lowbit(mask);
+    }
+    return skip_blanks_scalar(p, last);
+}
+
+#endif  // MULTOVL_CHARSCAN_SSE2
+
+#ifdef MULTOVL_CHARSCAN_AVX2
+
+// -- AVX2 kernels: 32 bytes at a time --
+
+__attribute__((target("avx2")))
+const char* find_avx2(const char* first, const char* last, char c)
+{
+    const __m256i vc = _mm256_set1_epi8(c);
+    const char* p = first;
+    for (; last - p >= 32; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, vc));
+        if (mask != 0)
+            return p + lowbit(mask);
+    }
+    return find_sse2(p, last, c);
+}
+
+__attribute__((target("avx2")))
+std::size_t find_all_avx2(const char* first, const char* last, char c,
+    std::uint32_t* offsets, std::size_t maxcnt)
+{
+    const __m256i vc = _mm256_set1_epi8(c);
+    std::size_t cnt = 0;
+    const char* p = first;
+    for (; last - p >= 32; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, vc));
+        record_bits(mask, p - first, offsets, maxcnt, cnt);
+    }
+    
+    // the tail is scanned by the SSE2 kernel, its offsets are relative to /p/
+    std::size_t tailmax = (cnt < maxcnt)? maxcnt - cnt: 0;
+    std::size_t tailcnt = find_all_sse2(p, last, c, offsets + (cnt < maxcnt? cnt: 0), tailmax);
+    for (std::size_t i = 0; i < tailcnt && i < tailmax; ++i)
+        offsets[cnt + i] += p - first;
+    return cnt + tailcnt;
+}
+
+__attribute__((target("avx2")))
+const char* skip_blanks_avx2(const char* first, const char* last)
+{
+    const __m256i vblank = _mm256_set1_epi8(' '), vtab = _mm256_set1_epi8('\t'), 
+        vnl = _mm256_set1_epi8('\n');
+    const char* p = first;
+    for (; last - p >= 32; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i isblank = _mm256_or_si256(_mm256_cmpeq_epi8(block, vblank), 
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, vtab), _mm256_cmpeq_epi8(block, vnl)));
+        unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(isblank));
+        if (mask != 0)
+            return p + lowbit(mask);
+    }
+    return skip_blanks_sse2(p, last);
+}
+
+#endif  // MULTOVL_CHARSCAN_AVX2
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+bool Charscan::supported(Kernel kind)
+{
+    switch (kind)
+    {
+        case SCALAR:
+            return true;
+#ifdef MULTOVL_CHARSCAN_SSE2
+        case SSE2:
+            return true;
+#endif
+#ifdef MULTOVL_CHARSCAN_AVX2
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool Charscan::select(Kernel kind)
+{
+    if (!supported(kind))
+        return false;
+    kernels() = make_kernels(kind);
+    return true;
+}
+
+const char* Charscan::to_string(Kernel kind)
+{
+    switch (kind)
+    {
+        case SSE2: return "SSE2";
+        case AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+// The kernel table, set up with the widest kernels the CPU supports upon first use.
+// Private
+Charscan::Kernels& Charscan::kernels()
+{
+    static Kernels best = make_kernels(
+        supported(AVX2)? AVX2: (supported(SSE2)? SSE2: SCALAR));
+    return best;
+}
+
+// Private
+Charscan::Kernels Charscan::make_kernels(Kernel kind)
+{
+    switch (kind)
+    {
+#ifdef MULTOVL_CHARSCAN_AVX2
+        case AVX2:
+            return Kernels{AVX2, find_avx2, find_all_avx2, skip_blanks_avx2};
+#endif
+#ifdef MULTOVL_CHARSCAN_SSE2
+        case SSE2:
+            return Kernels{SSE2, find_sse2, find_all_sse2, skip_blanks_sse2};
+#endif
+        default:
+            return Kernels{SCALAR, find_scalar, find_all_scalar, skip_blanks_scalar};
+    }
+}
+
+}   // namespace io
+}   // namespace multovl
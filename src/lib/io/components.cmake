@@ -5,9 +5,18 @@
 target_sources(movl
     PRIVATE
     ${CMAKE_CURRENT_LIST_DIR}/bamio.cc
+    ${CMAKE_CURRENT_LIST_DIR}/binio.cc
+    ${CMAKE_CURRENT_LIST_DIR}/charscan.cc
     ${CMAKE_CURRENT_LIST_DIR}/fileformat.cc
     ${CMAKE_CURRENT_LIST_DIR}/fileio.cc
+    ${CMAKE_CURRENT_LIST_DIR}/inflater.cc
     ${CMAKE_CURRENT_LIST_DIR}/linereader.cc
     ${CMAKE_CURRENT_LIST_DIR}/linewriter.cc
+    ${CMAKE_CURRENT_LIST_DIR}/outbuffer.cc
+    ${CMAKE_CURRENT_LIST_DIR}/readahead.cc
+    ${CMAKE_CURRENT_LIST_DIR}/snapshot.cc
+    ${CMAKE_CURRENT_LIST_DIR}/spillstore.cc
     ${CMAKE_CURRENT_LIST_DIR}/textio.cc
+    ${CMAKE_CURRENT_LIST_DIR}/trackbuffer.cc
+    ${CMAKE_CURRENT_LIST_DIR}/trackcache.cc
 )
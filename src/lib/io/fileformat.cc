@@ -55,6 +55,13 @@ Fileformat::Kind Fileformat::from_filename(const std::string& filenm)
 {
     std::filesystem::path filepath(filenm);
     std::string ext = filepath.extension().string();
+    if (boost::algorithm::iequals(ext, ".gz"))
+    {
+        // gzip-compressed text files, BAM files are compressed anyway
+        ext = filepath.stem().extension().string();
+        Kind kind = (ext[0] == '.')? from_string(ext.substr(1)): UNKNOWN;
+        return (kind == BAM || kind == MTB)? UNKNOWN: kind;
+    }
 
     if (ext[0] == '.')
         return from_string(ext.substr(1));
@@ -70,13 +77,15 @@ std::string Fileformat::to_string(Fileformat::Kind format)
         return "BED";
     else if (format == BAM)
         return "BAM";
+    else if (format == MTB)
+        return "MTB";
     else
         return "UNKNOWN";
 }
 
 std::string Fileformat::known_extensions()
 {
-    std::string extensions = ".bed, .gff, .gtf, .bam";
+    std::string extensions = ".bed, .gff, .gtf, .bam, .mtb, .bed.gz, .gff.gz, .gtf.gz";
     return extensions;
 }
 
@@ -90,6 +99,8 @@ Fileformat::Kind Fileformat::from_string(const std::string& fstr)
         return BED;
     else if (formstr == "bam")
         return BAM;
+    else if (formstr == "mtb")
+        return MTB;
     else
         return UNKNOWN;
 }
@@ -39,9 +39,21 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "multovl/io/fileio.hh"
 #include "multovl/io/textio.hh"
 #include "multovl/io/bamio.hh"
+#include "multovl/io/binio.hh"
+#include "multovl/io/trackcache.hh"
 
 #include "multovl/multioverlap.hh"
 
+// -- Standard headers --
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <utility>
+
 // == Implementation ==
 
 namespace multovl {
@@ -49,9 +61,15 @@ namespace io {
 
 FileReader::FileReader(
     const std::string& infname,
-    Fileformat::Kind format
+    Fileformat::Kind format,
+    const std::string& cachedir
 ):
     _reader(nullptr),
+    _cache(),
+    _cacheentry(),
+    _chrom(),
+    _chroms(),
+    _filter(false),
     _finished(false)
 {
     // figure out the file format
@@ -60,10 +78,18 @@ FileReader::FileReader(
          fmt = Fileformat::from_filename(infname);
 
     // select the appropriate track reader (factory pattern)
-    if (fmt == Fileformat::BAM)
-        _reader = new BamReader(infname);
-    else
-        _reader = new TextReader(infname, fmt);
+    // unless the regions can be read from the cache
+    if (cachedir != "" && fmt != Fileformat::MTB)
+        open_cached(infname, cachedir);
+    if (_reader == nullptr)
+    {
+        if (fmt == Fileformat::BAM)
+            _reader = new BamReader(infname);
+        else if (fmt == Fileformat::MTB)
+            _reader = new BinaryReader(infname);
+        else
+            _reader = new TextReader(infname, fmt);
+    }
 
     // maybe something went wrong...
     if (!errors().ok())
@@ -79,25 +105,159 @@ FileReader::~FileReader()
     }
 }
 
+void FileReader::restrict_chroms(const std::set<std::string>& chroms)
+{
+    // a new cache entry must hold all regions, so the track reader cannot skip any
+    _chroms = chroms;
+    _filter = !_chroms.empty() && (_cache != nullptr || !_reader->restrict_chroms(_chroms));
+}
+
 bool FileReader::read_into(std::string& chrom, BaseRegion& reg)
 {
     if (finished()) return true;
     
-    std::string msg = _reader->read_into(chrom, reg);
-    if (msg != "")
+    while (true)
     {
-        if (msg == "EOF")
+        std::string msg = _reader->read_into(chrom, reg);
+        if (msg != "")
         {
-            _finished = true;
-            return true;
+            if (msg == "EOF")
+            {
+                _finished = true;
+                store_cached();
+                return true;
+            }
+            _cache.reset();     // regions with problems are not cached
+            return false;
         }
-        return false;
+        if (_cache != nullptr)
+            _cache->add(chrom, reg);
+        if (!_filter || _chroms.count(chrom) > 0)
+            return true;
+    }
+}
+
+bool FileReader::read_into(StringPool& chroms, unsigned int& chromid, BaseRegion& reg)
+{
+    bool ok = read_into(_chrom, reg);
+    if (ok && !finished())
+        chromid = chroms.intern(_chrom);
+    return ok;
+}
+
+unsigned int FileReader::read_all(TrackBuffer& track, unsigned int threads)
+{
+    if (finished()) return 0;
+    
+    unsigned int problemcnt = 0;
+    if (_filter || _cache != nullptr)
+    {
+        TrackBuffer all;
+        problemcnt = _reader->read_all(all, threads);
+        if (problemcnt > 0)
+            _cache.reset();
+        all.for_each([this, &track](std::string_view chrom, const BaseRegion& reg) {
+            if (_cache != nullptr)
+                _cache->add(chrom, reg);
+            if (!_filter || _chroms.count(std::string(chrom)) > 0)
+                track.add(chrom, reg);
+        });
+        store_cached();
+    }
+    else
+    {
+        problemcnt = _reader->read_all(track, threads);
     }
-    return true;
+    _finished = true;
+    return problemcnt;
 }
 
 const Errors& FileReader::errors() const { return _reader->errors(); }
 void FileReader::add_error(const std::string& msg) { _reader->add_error(msg); }
 
+// Reads from the cache entry of /infname/ if there is one,
+// otherwise prepares the collection of the regions for a new entry.
+// Private
+void FileReader::open_cached(const std::string& infname, const std::string& cachedir)
+{
+    _cacheentry = cache_entry(cachedir, infname);
+    if (_cacheentry == "")
+        return;     // /infname/ cannot be cached, the errors will be reported by the track reader
+    
+    std::error_code ec;
+    if (std::filesystem::exists(_cacheentry, ec))
+    {
+        auto reader = std::make_unique<BinaryReader>(_cacheentry);
+        if (reader->errors().ok())
+        {
+            _reader = reader.release();
+            return;
+        }
+        // a damaged entry is replaced
+    }
+    _cache = std::make_unique<BinaryWriter>();
+}
+
+// Stores the regions collected so far in the cache if all of them could be read.
+// Private
+void FileReader::store_cached()
+{
+    if (_cache != nullptr && errors().perfect())
+        store_cache_entry(*_cache, _cacheentry);   // caching is best effort, failures are ignored
+    _cache.reset();
+}
+
+std::vector<LoadedTrack> read_all_tracks(
+    const std::vector<std::string>& infnames, unsigned int threads,
+    const std::set<std::string>& chroms, const std::string& cachedir)
+{
+    std::vector<LoadedTrack> tracks(infnames.size());
+    if (tracks.empty())
+        return tracks;
+    
+    // start with the largest files so that a big one picked up last
+    // does not keep the other threads waiting
+    std::vector<std::pair<std::uintmax_t, std::size_t>> order;    // size, index
+    for (std::size_t i = 0; i < infnames.size(); ++i)
+    {
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(infnames[i], ec);
+        order.emplace_back(ec? 0: size, i);
+    }
+    std::stable_sort(order.begin(), order.end(), 
+        [](const auto& o1, const auto& o2) { return o1.first > o2.first; });
+    
+    unsigned int threadcnt = std::max(1u, std::min<unsigned int>(threads, infnames.size()));
+    unsigned int chunkthreads = std::max(1u, threads / threadcnt);
+    std::atomic<std::size_t> next(0);
+    auto worker = [&infnames, &tracks, &order, &next, &chroms, &cachedir, chunkthreads]() {
+        for (std::size_t o = next++; o < order.size(); o = next++)
+        {
+            std::size_t i = order[o].second;
+            LoadedTrack& track = tracks[i];
+            track.reader = std::make_unique<FileReader>(infnames[i], Fileformat::UNKNOWN, cachedir);
+            track.opened = track.reader->errors().ok();
+            if (track.opened)
+            {
+                track.reader->restrict_chroms(chroms);
+                track.problemcnt = track.reader->read_all(track.regions, chunkthreads);
+            }
+        }
+    };
+    if (threadcnt == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threadcnt; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w : workers) { w.join(); }
+    }
+    return tracks;
+}
+
 }   // namespace io
 }   // namespace multovl
@@ -0,0 +1,282 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE inflater.cc ==
+
+// -- Own header --
+
+#include "multovl/io/inflater.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// -- Zlib header --
+
+#include "zlib.h"
+
+// == Implementation ==
+
+namespace {
+
+// BGZF block layout, see the SAM/BAM format specification:
+// 18-byte gzip header with the "BC" extra subfield holding the block size - 1,
+// raw deflate data, CRC32 and the uncompressed size in the 8-byte footer.
+const std::size_t BGZF_HEADERLEN = 18, BGZF_FOOTERLEN = 8;
+
+inline unsigned int le16(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+inline std::uint32_t le32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+// \return the length of the BGZF block starting at /p/
+// or 0 if there is no complete BGZF block in [p, end)
+std::size_t bgzf_blocklen(const unsigned char* p, const unsigned char* end)
+{
+    std::size_t avail = end - p;
+    if (avail < BGZF_HEADERLEN + BGZF_FOOTERLEN)
+        return 0;
+    if (p[0] != 31 || p[1] != 139 || p[2] != Z_DEFLATED || (p[3] & 4) == 0 ||
+        le16(p + 10) != 6 || p[12] != 'B' || p[13] != 'C' || le16(p + 14) != 2)
+        return 0;
+    std::size_t len = le16(p + 16) + 1;
+    return (len >= BGZF_HEADERLEN + BGZF_FOOTERLEN && len <= avail)? len: 0;
+}
+
+// A BGZF block to be decompressed into its place in the output
+struct Block
+{
+    const unsigned char* data;
+    std::size_t len, outoff;
+    std::uint32_t outlen;
+};
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+bool Inflater::is_gzip(const char* first, const char* last)
+{
+    return (last - first >= 2 && 
+        static_cast<unsigned char>(first[0]) == 31 && static_cast<unsigned char>(first[1]) == 139);
+}
+
+Inflater::Inflater(const char* first, const char* last):
+    _pos(reinterpret_cast<const unsigned char*>(first)),
+    _end(reinterpret_cast<const unsigned char*>(last)),
+    _zs(nullptr),
+    _bgzf(false),
+    _finished(first == last),
+    _err()
+{
+    _bgzf = (bgzf_blocklen(_pos, _end) > 0);
+}
+
+Inflater::~Inflater()
+{
+    if (_zs != nullptr)
+    {
+        inflateEnd(_zs);
+        delete _zs;
+        _zs = nullptr;
+    }
+}
+
+std::size_t Inflater::inflate(std::string& out, std::size_t size, unsigned int threads)
+{
+    if (finished())
+        return 0;
+    std::size_t len = _bgzf? inflate_bgzf(out, size, threads): inflate_stream(out, size);
+    if (len == 0)
+        _finished = true;
+    return len;
+}
+
+// Decompresses whole BGZF blocks until at least /size/ bytes have been appended to /out/.
+// The uncompressed size of each block is known from its footer, so the blocks
+// can be decompressed independently directly into their places in /out/.
+// Private
+std::size_t Inflater::inflate_bgzf(std::string& out, std::size_t size, unsigned int threads)
+{
+    std::vector<Block> blocks;
+    std::size_t start = out.size(), total = 0;
+    bool invalid = false;
+    while (_pos < _end && total < size)
+    {
+        std::size_t len = bgzf_blocklen(_pos, _end);
+        if (len == 0)
+        {
+            // the blocks before this one are still decompressed
+            invalid = true;
+            break;
+        }
+        std::uint32_t outlen = le32(_pos + len - 4);
+        blocks.push_back(Block{_pos, len, start + total, outlen});
+        total += outlen;
+        _pos += len;
+    }
+    if (_pos == _end)
+        _finished = true;
+    out.resize(start + total);
+    
+    // the index of the first block that could not be decompressed
+    std::atomic<std::size_t> next(0), firstbad(blocks.size());
+    auto worker = [&out, &blocks, &next, &firstbad]() {
+        z_stream zs{};
+        bool ok = (inflateInit2(&zs, 15 + 16) == Z_OK);     // gzip wrapper
+        for (std::size_t i = next++; i < blocks.size(); i = next++)
+        {
+            const Block& block = blocks[i];
+            if (ok)
+            {
+                inflateReset(&zs);
+                zs.next_in = const_cast<unsigned char*>(block.data);
+                zs.avail_in = block.len;
+                zs.next_out = reinterpret_cast<unsigned char*>(&out[0]) + block.outoff;
+                zs.avail_out = block.outlen;
+                if (::inflate(&zs, Z_FINISH) == Z_STREAM_END && zs.avail_out == 0)
+                    continue;
+            }
+            std::size_t bad = firstbad;
+            while (i < bad && !firstbad.compare_exchange_weak(bad, i))
+                ;
+        }
+        if (ok)
+            inflateEnd(&zs);
+    };
+    unsigned int threadcnt = std::max(1u, std::min<unsigned int>(threads, blocks.size()));
+    if (threadcnt == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threadcnt; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w : workers) { w.join(); }
+    }
+    
+    // keep the output up to the first bad block
+    if (firstbad < blocks.size())
+    {
+        total = blocks[firstbad].outoff - start;
+        out.resize(start + total);
+        fail("Corrupt BGZF block");
+    }
+    else if (invalid)
+    {
+        fail("Invalid BGZF block");
+    }
+    return total;
+}
+
+// Decompresses a gzip stream until /size/ bytes have been appended to /out/
+// or the input ends. Concatenated gzip members are decompressed one after the other.
+// Private
+std::size_t Inflater::inflate_stream(std::string& out, std::size_t size)
+{
+    if (_zs == nullptr)
+    {
+        _zs = new z_stream{};
+        if (inflateInit2(_zs, 15 + 16) != Z_OK)     // gzip wrapper
+        {
+            fail("Cannot initialise zlib");
+            return 0;
+        }
+    }
+    
+    std::size_t start = out.size();
+    out.resize(start + size);
+    _zs->next_out = reinterpret_cast<unsigned char*>(&out[0]) + start;
+    _zs->avail_out = size;
+    while (_zs->avail_out > 0)
+    {
+        if (_zs->avail_in == 0)
+        {
+            if (_pos == _end)
+            {
+                fail("Truncated gzip input");
+                break;
+            }
+            // zlib takes at most UINT_MAX bytes at a time
+            std::size_t len = std::min<std::size_t>(_end - _pos, UINT_MAX);
+            _zs->next_in = const_cast<unsigned char*>(_pos);
+            _zs->avail_in = len;
+            _pos += len;
+        }
+        int ret = ::inflate(_zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END)
+        {
+            if (_zs->avail_in == 0 && _pos == _end)
+            {
+                _finished = true;
+                break;
+            }
+            inflateReset(_zs);  // another gzip member follows
+        }
+        else if (ret != Z_OK)
+        {
+            fail(std::string("Corrupt gzip input") + 
+                (_zs->msg != nullptr? std::string(": ") + _zs->msg: ""));
+            break;
+        }
+    }
+    std::size_t len = size - _zs->avail_out;
+    out.resize(start + len);
+    return len;
+}
+
+// Records an error and stops decompression
+// Private
+void Inflater::fail(const std::string& msg)
+{
+    _err = msg;
+    _finished = true;
+}
+
+}   // namespace io
+}   // namespace multovl
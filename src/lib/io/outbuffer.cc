@@ -0,0 +1,212 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE outbuffer.cc ==
+
+// -- Own header --
+
+#include "multovl/io/outbuffer.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <cstring>
+
+// == Implementation ==
+
+namespace multovl {
+namespace io {
+
+// -- OutputBuffer methods --
+
+OutputBuffer::OutputBuffer(std::ostream* out, std::size_t capacity):
+    _out(out), _buf(), _cap(std::max<std::size_t>(capacity, 64)), _len(0)
+{
+    _buf.reset(new char[_cap]);
+}
+
+void OutputBuffer::flush()
+{
+    if (_out != nullptr && _len > 0)
+    {
+        _out->write(_buf.get(), _len);
+        _len = 0;
+    }
+}
+
+// Makes room for at least /n/ more bytes: writes the contents to the stream
+// or enlarges the buffer if there is no stream or the contents are too large.
+// Private
+void OutputBuffer::make_room(std::size_t n)
+{
+    flush();
+    if (_len + n <= _cap)
+        return;
+    std::size_t newcap = std::max(2 * _cap, _len + n);
+    std::unique_ptr<char[]> newbuf(new char[newcap]);
+    std::memcpy(newbuf.get(), _buf.get(), _len);
+    _buf = std::move(newbuf);
+    _cap = newcap;
+}
+
+// -- MultiregionWriter methods --
+
+MultiregionWriter::MultiregionWriter(bool cache):
+    _chrom(), _source(), _gff(false), _cache(cache), _sep(' '),
+    _pool(), _fragpos(), _frags(nullptr, 1 << 16)
+{}
+
+MultiregionWriter::MultiregionWriter(const std::string& source, unsigned int version, bool cache):
+    _chrom(), _source(source), _gff(true), _cache(cache), _sep(version <= 2? ' ': '='),
+    _pool(), _fragpos(), _frags(nullptr, 1 << 16)
+{}
+
+void MultiregionWriter::write(const MultiRegion& reg, OutputBuffer& buf)
+{
+    buf.put(_chrom);
+    buf.put('\t');
+    if (_gff)
+    {
+        buf.put(_source);
+        buf.put('\t');
+        buf.put(reg.name());
+        buf.put('\t');
+        buf.put(reg.first());
+        buf.put('\t');
+        buf.put(reg.last());
+        buf.put('\t');
+        if (reg.multiplicity() > 0)
+            buf.put(reg.multiplicity());
+        else
+            buf.put('.');
+        buf.put('\t');
+        buf.put(reg.strand());
+        if (reg.ancestor_count() == 0)
+        {
+            buf.put(std::string_view("\t.\t."));   // no frame, no group info
+        }
+        else
+        {
+            buf.put(std::string_view("\t.\tANCESTORS"));
+            buf.put(_sep);
+            write_ancestors(reg, buf);
+        }
+    }
+    else
+    {
+        buf.put(reg.first());
+        buf.put('\t');
+        buf.put(reg.last());
+        buf.put('\t');
+        write_ancestors(reg, buf);
+        buf.put('\t');
+        buf.put(reg.multiplicity());
+        buf.put('\t');
+        buf.put(reg.strand());
+    }
+    buf.put('\n');
+}
+
+void MultiregionWriter::reset_cache()
+{
+    _pool.reset();
+    _fragpos.clear();
+    _fragpos.shrink_to_fit();
+    _frags.clear();
+}
+
+// Writes the ancestors of /reg/ like MultiRegion::anc_str() does. Private
+void MultiregionWriter::write_ancestors(const MultiRegion& reg, OutputBuffer& buf)
+{
+    const ancregvec_t& pool = *reg.ancestor_pool();
+    if (_cache && reg.ancestor_pool() != _pool)
+    {
+        // a new pool, the old fragments cannot be used
+        reset_cache();
+        _pool = reg.ancestor_pool();
+        _fragpos.resize(pool.size(), Fragment{0, 0});
+    }
+    
+    unsigned int i = 0, n = reg.ancestor_count();
+    while (i < n)
+    {
+        if (i > 0) buf.put('|');
+        unsigned int idx = reg.ancestor_index(i);
+        
+        // equal ancestors are written once with a "<cnt>*" prefix
+        unsigned int cnt;
+        for (cnt = 1; i + cnt < n && pool.equal(idx, reg.ancestor_index(i + cnt)); ++cnt);
+        if (cnt > 1)
+        {
+            buf.put(cnt);
+            buf.put('*');
+        }
+        
+        if (_cache)
+        {
+            Fragment& frag = _fragpos[idx];
+            if (frag.length == 0)
+            {
+                frag.offset = _frags.size();
+                write_fragment(pool, idx, _frags);
+                frag.length = _frags.size() - frag.offset;
+            }
+            buf.put(std::string_view(_frags.data() + frag.offset, frag.length));
+        }
+        else
+        {
+            write_fragment(pool, idx, buf);
+        }
+        i += cnt;
+    }
+}
+
+// Writes the /i/-th entry of /pool/ like AncestorTable::to_attrstring() does.
+// Private
+void MultiregionWriter::write_fragment(const ancregvec_t& pool, unsigned int i, OutputBuffer& buf)
+{
+    const RegRecord& rec = pool.record(i);
+    buf.put(rec.track_id());
+    buf.put(':');
+    buf.put(pool.name(i));
+    buf.put(':');
+    buf.put(rec.strand());
+    buf.put(':');
+    buf.put(rec.first());
+    buf.put('-');
+    buf.put(rec.last());
+}
+
+}   // namespace io
+}   // namespace multovl
@@ -0,0 +1,148 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == MODULE readahead.cc ==
+
+// -- Own header --
+
+#include "multovl/io/readahead.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <cstring>
+
+// == Implementation ==
+
+namespace multovl {
+namespace io {
+
+Readahead::Readahead(const char* first, const char* last, unsigned int threads,
+    std::size_t partsize, unsigned int depth):
+    _inflater(first, last),
+    _threads(std::max(1u, threads)),
+    _partsize(std::max<std::size_t>(1, partsize)),
+    _parts(std::max(2u, depth)),
+    _head(0),
+    _count(0),
+    _done(false),
+    _stop(false),
+    _mutex(),
+    _ready(),
+    _free(),
+    _curr(nullptr),
+    _off(0),
+    _producer(&Readahead::produce, this)
+{}
+
+Readahead::~Readahead()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _free.notify_one();
+    _producer.join();
+}
+
+std::size_t Readahead::read(char* dest, std::size_t len)
+{
+    std::size_t copied = 0;
+    while (copied < len)
+    {
+        if (_curr == nullptr || _off == _curr->size())
+        {
+            if (!next_part())
+                break;
+        }
+        std::size_t n = std::min(len - copied, _curr->size() - _off);
+        std::memcpy(dest + copied, _curr->data() + _off, n);
+        _off += n;
+        copied += n;
+    }
+    return copied;
+}
+
+// Releases the part the consumer has finished and waits for the next one.
+// \return /false/ if there are no more parts
+// Private
+bool Readahead::next_part()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_curr != nullptr)
+    {
+        _head = (_head + 1) % _parts.size();
+        --_count;
+        _curr = nullptr;
+        _free.notify_one();
+    }
+    _ready.wait(lock, [this]() { return _count > 0 || _done; });
+    if (_count == 0)
+        return false;
+    _curr = &_parts[_head];
+    _off = 0;
+    return true;
+}
+
+// The background thread's loop: decompresses the input part by part
+// into the free slots of the ring.
+// Private
+void Readahead::produce()
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _free.wait(lock, [this]() { return _stop || _count < _parts.size(); });
+        if (_stop)
+            break;
+        // the consumer does not touch the free slots
+        std::string& part = _parts[(_head + _count) % _parts.size()];
+        lock.unlock();
+        
+        part.clear();
+        std::size_t len = _inflater.inflate(part, _partsize, _threads);
+        
+        lock.lock();
+        if (len > 0)
+            ++_count;
+        if (len == 0 || _inflater.finished())
+            _done = true;
+        _ready.notify_one();
+        if (_done)
+            break;
+    }
+}
+
+}   // namespace io
+}   // namespace multovl
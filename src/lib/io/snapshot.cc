@@ -0,0 +1,355 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+
+// == MODULE snapshot.cc ==
+
+// -- Own header --
+
+#include "multovl/io/snapshot.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <type_traits>
+
+// -- Boost headers --
+
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/interprocess/exceptions.hpp"
+
+// == Implementation ==
+
+namespace {
+
+using multovl::RegRecord;
+
+// the region arrays are the RegRecord-s themselves
+static_assert(std::is_trivially_copyable<RegRecord>::value && sizeof(RegRecord) == 16,
+    "RegRecord cannot be stored in snapshot files");
+
+const char SNAP_MAGIC[8] = { 'M', 'U', 'L', 'T', 'O', 'V', 'L', 'S' };
+const std::uint32_t SNAP_VERSION = 1, SNAP_BYTEORDER = 0x01020304;
+const std::uint64_t SNAP_HEADERLEN = 56, SNAP_INPUTLEN = 16, SNAP_CHROMLEN = 24;
+
+template <typename T>
+void put(std::string& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+// -- SnapshotReader methods --
+
+SnapshotReader::SnapshotReader(const std::string& infname):
+    _storage(),
+    _data(nullptr),
+    _size(0),
+    _chromoff(0),
+    _stroff(0),
+    _strcnt(0),
+    _inputcnt(0),
+    _chromcnt(0),
+    _stroffs(nullptr),
+    _chars(nullptr),
+    _error()
+{
+    if (!open(infname))
+    {
+        // nothing can be read
+        _inputcnt = _chromcnt = 0;
+    }
+}
+
+SnapshotReader::Input SnapshotReader::input(unsigned int i) const
+{
+    std::uint64_t offset = SNAP_HEADERLEN + SNAP_INPUTLEN * i;
+    return Input{ string(get32(offset)), get32(offset + 4), get32(offset + 8) };
+}
+
+std::string_view SnapshotReader::chrom(unsigned int i) const
+{
+    return string(get32(_chromoff + SNAP_CHROMLEN * i));
+}
+
+AncestorTable SnapshotReader::regions(unsigned int i) const
+{
+    std::uint64_t offset = _chromoff + SNAP_CHROMLEN * i;
+    auto names = std::make_shared<StringPool>(_storage, _chars, 
+        _stroffs + get32(offset + 8), get32(offset + 12));
+    return AncestorTable(_storage, 
+        reinterpret_cast<const RegRecord*>(_data + get64(offset + 16)), 
+        get32(offset + 4), names);
+}
+
+// Maps the file into memory and checks the header and the tables.
+// Private
+bool SnapshotReader::open(const std::string& infname)
+{
+    std::error_code ec;
+    auto size = std::filesystem::file_size(infname, ec);
+    if (!ec && size > 0)
+    {
+        try
+        {
+            namespace bip = boost::interprocess;
+            bip::file_mapping mapping(infname.c_str(), bip::read_only);
+            auto region = std::make_shared<bip::mapped_region>(mapping, bip::read_only);
+            _data = static_cast<const unsigned char*>(region->get_address());
+            _size = region->get_size();
+            _storage = region;
+        }
+        catch (const boost::interprocess::interprocess_exception&)
+        {
+            // fall back to reading
+        }
+    }
+    if (_storage == nullptr)
+    {
+        std::ifstream inf(infname.c_str(), std::ios::binary);
+        if (!inf)
+        {
+            _error = "Cannot open snapshot file: " + infname;
+            return false;
+        }
+        // the string is allocated with new, its data are suitably aligned
+        auto buffer = std::make_shared<std::string>(
+            std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+        _data = reinterpret_cast<const unsigned char*>(buffer->data());
+        _size = buffer->size();
+        _storage = buffer;
+    }
+    
+    if (_size < SNAP_HEADERLEN || !std::equal(SNAP_MAGIC, SNAP_MAGIC + 8, _data))
+    {
+        _error = "Not a snapshot file: " + infname;
+        return false;
+    }
+    if (get32(8) != SNAP_VERSION)
+    {
+        _error = "Unsupported snapshot file version: " + infname;
+        return false;
+    }
+    if (get32(12) != SNAP_BYTEORDER)
+    {
+        _error = "Snapshot file was written on a machine with a different byte order: " + infname;
+        return false;
+    }
+    if (!check_tables())
+    {
+        _error = "Corrupt snapshot file: " + infname;
+        return false;
+    }
+    return true;
+}
+
+// Checks that the tables lie within the file and that they refer to existing data.
+// Does not look at the region records, so that this is fast even for huge snapshots.
+// Private
+bool SnapshotReader::check_tables()
+{
+    _inputcnt = get32(16);
+    _chromcnt = get32(20);
+    _chromoff = get64(32);
+    _stroff = get64(40);
+    if (get64(48) != _size || _chromoff != SNAP_HEADERLEN + SNAP_INPUTLEN * _inputcnt ||
+        _stroff % 8 != 0 || _stroff > _size - 8 || 
+        _chromcnt > (_stroff - _chromoff) / SNAP_CHROMLEN)
+        return false;
+    
+    _strcnt = get64(_stroff);
+    if (_strcnt >= (_size - _stroff) / 8 - 1)
+        return false;
+    std::uint64_t charsoff = _stroff + 8 * (_strcnt + 2);
+    _stroffs = reinterpret_cast<const std::uint64_t*>(_data + _stroff + 8);
+    _chars = reinterpret_cast<const char*>(_data + charsoff);
+    if (_stroffs[_strcnt] != _size - charsoff)
+        return false;
+    
+    // the strings are looked up without checks later
+    auto check_string = [this](std::uint64_t id) {
+        return id < _strcnt && _stroffs[id] <= _stroffs[id + 1] && _stroffs[id + 1] <= _stroffs[_strcnt];
+    };
+    for (unsigned int i = 0; i < _inputcnt; ++i)
+    {
+        if (!check_string(get32(SNAP_HEADERLEN + SNAP_INPUTLEN * i)))
+            return false;
+    }
+    std::uint64_t regend = SNAP_HEADERLEN + SNAP_INPUTLEN * _inputcnt + SNAP_CHROMLEN * _chromcnt;
+    for (unsigned int i = 0; i < _chromcnt; ++i)
+    {
+        std::uint64_t offset = _chromoff + SNAP_CHROMLEN * i;
+        std::uint64_t regcnt = get32(offset + 4), namebase = get32(offset + 8),
+            namecnt = get32(offset + 12), regoff = get64(offset + 16);
+        if (!check_string(get32(offset)) || namebase + namecnt > _strcnt ||
+            regoff % 8 != 0 || regoff < regend || regcnt > (_stroff - regoff) / sizeof(RegRecord))
+            return false;
+        regend = regoff + regcnt * sizeof(RegRecord);
+    }
+    return true;
+}
+
+// Private
+std::uint32_t SnapshotReader::get32(std::uint64_t offset) const
+{
+    std::uint32_t value;
+    std::memcpy(&value, _data + offset, 4);
+    return value;
+}
+
+// Private
+std::uint64_t SnapshotReader::get64(std::uint64_t offset) const
+{
+    std::uint64_t value;
+    std::memcpy(&value, _data + offset, 8);
+    return value;
+}
+
+// Private
+std::string_view SnapshotReader::string(std::uint64_t id) const
+{
+    return std::string_view(_chars + _stroffs[id], _stroffs[id + 1] - _stroffs[id]);
+}
+
+// -- SnapshotWriter methods --
+
+SnapshotWriter::SnapshotWriter():
+    _strings(),
+    _inputs(),
+    _chroms()
+{}
+
+void SnapshotWriter::add_input(std::string_view name, unsigned int trackid, unsigned int regcnt)
+{
+    _inputs.push_back(Input{ static_cast<unsigned int>(_strings.size()), trackid, regcnt });
+    _strings.emplace_back(name);
+}
+
+void SnapshotWriter::add_chrom(std::string_view chrom, const AncestorTable& regions)
+{
+    _chroms.push_back(Chrom{ static_cast<unsigned int>(_strings.size()), &regions });
+    _strings.emplace_back(chrom);
+}
+
+bool SnapshotWriter::write(const std::string& outfname) const
+{
+    std::string tables;
+    for (const auto& inp : _inputs)
+    {
+        put<std::uint32_t>(tables, inp.nameid);
+        put<std::uint32_t>(tables, inp.trackid);
+        put<std::uint32_t>(tables, inp.regcnt);
+        put<std::uint32_t>(tables, 0);
+    }
+    
+    // the region arrays follow the chromosome table,
+    // the region names are appended to the input and chromosome names
+    std::uint64_t chromoff = SNAP_HEADERLEN + tables.size();
+    std::uint64_t offset = chromoff + SNAP_CHROMLEN * _chroms.size();
+    std::uint64_t regcnt = 0, strcnt = _strings.size();
+    for (const auto& chrom : _chroms)
+    {
+        unsigned int cnt = chrom.regions->size(), namecnt = chrom.regions->names().size();
+        put<std::uint32_t>(tables, chrom.nameid);
+        put<std::uint32_t>(tables, cnt);
+        put<std::uint32_t>(tables, strcnt);
+        put<std::uint32_t>(tables, namecnt);
+        put<std::uint64_t>(tables, offset);
+        offset += cnt * sizeof(RegRecord);
+        regcnt += cnt;
+        strcnt += namecnt;
+    }
+    
+    // the string table offsets
+    std::string stroffs;
+    std::uint64_t charcnt = 0;
+    put<std::uint64_t>(stroffs, strcnt);
+    for (const auto& str : _strings)
+    {
+        put<std::uint64_t>(stroffs, charcnt);
+        charcnt += str.size();
+    }
+    for (const auto& chrom : _chroms)
+    {
+        const StringPool& names = chrom.regions->names();
+        for (unsigned int i = 0; i < names.size(); ++i)
+        {
+            put<std::uint64_t>(stroffs, charcnt);
+            charcnt += names[i].size();
+        }
+    }
+    put<std::uint64_t>(stroffs, charcnt);
+    
+    std::string header(SNAP_MAGIC, 8);
+    put<std::uint32_t>(header, SNAP_VERSION);
+    put<std::uint32_t>(header, SNAP_BYTEORDER);
+    put<std::uint32_t>(header, _inputs.size());
+    put<std::uint32_t>(header, _chroms.size());
+    put<std::uint64_t>(header, regcnt);
+    put<std::uint64_t>(header, chromoff);
+    put<std::uint64_t>(header, offset);
+    put<std::uint64_t>(header, offset + stroffs.size() + charcnt);
+    
+    std::ofstream out(outfname.c_str(), std::ios::binary);
+    out << header << tables;
+    for (const auto& chrom : _chroms)
+    {
+        out.write(reinterpret_cast<const char*>(chrom.regions->records()), 
+            chrom.regions->size() * sizeof(RegRecord));
+    }
+    out << stroffs;
+    for (const auto& str : _strings)
+        out << str;
+    for (const auto& chrom : _chroms)
+    {
+        const StringPool& names = chrom.regions->names();
+        for (unsigned int i = 0; i < names.size(); ++i)
+            out << names[i];
+    }
+    out.close();
+    return !out.fail();
+}
+
+}   // namespace io
+}   // namespace multovl
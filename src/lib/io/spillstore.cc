@@ -0,0 +1,354 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+
+// == MODULE spillstore.cc ==
+
+// -- Own header --
+
+#include "multovl/io/spillstore.hh"
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <system_error>
+#include <utility>
+
+// == Implementation ==
+
+namespace {
+
+// A region record in the files and buffers, in native byte order:
+// uint32 first, uint32 last, uint32 track ID, uint32 name length, char strand, the name.
+const std::size_t RECHEADLEN = 17;
+
+// the regions are read back in chunks of this size if they need not be sorted
+const std::size_t READCHUNK = 1 << 20;
+
+void put_record(std::string& out, const multovl::BaseRegion& reg, unsigned int trackid)
+{
+    std::uint32_t head[4] = { reg.first(), reg.last(), trackid, 
+        static_cast<std::uint32_t>(reg.name().size()) };
+    out.append(reinterpret_cast<const char*>(head), sizeof(head));
+    out += reg.strand();
+    out += reg.name();
+}
+
+// \return the first position of the record at /rec/
+inline unsigned int record_first(const char* rec)
+{
+    std::uint32_t first;
+    std::memcpy(&first, rec, 4);
+    return first;
+}
+
+// Decodes the record at /rec/ into /reg/ and /trackid/, /name/ is a buffer
+void get_record(const char* rec, multovl::BaseRegion& reg, unsigned int& trackid, std::string& name)
+{
+    std::uint32_t head[4];
+    std::memcpy(head, rec, sizeof(head));
+    reg.set_coords(head[0], head[1]);
+    reg.strand(rec[16]);
+    name.assign(rec + RECHEADLEN, head[3]);
+    reg.name(name);
+    trackid = head[2];
+}
+
+// Reads the next record from /in/ and appends it to /out/
+// \return /false/ at the end of the input or if the record is truncated
+bool read_record(std::ifstream& in, std::string& out)
+{
+    char head[RECHEADLEN];
+    if (!in.read(head, RECHEADLEN))
+        return false;
+    std::uint32_t namelen;
+    std::memcpy(&namelen, head + 12, 4);
+    std::size_t offset = out.size();
+    out.append(head, RECHEADLEN);
+    out.resize(offset + RECHEADLEN + namelen);
+    return namelen == 0 || in.read(&out[offset + RECHEADLEN], namelen);
+}
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+SpillStore::SpillStore(std::size_t budget, const std::string& tmpdir):
+    _budget(std::max<std::size_t>(budget, 1 << 20)),
+    _buffered(0),
+    _dir(),
+    _chroms(),
+    _error()
+{
+    std::error_code ec;
+    std::filesystem::path base = (tmpdir == "")? 
+        std::filesystem::temp_directory_path(ec): std::filesystem::path(tmpdir);
+    std::random_device rnd;
+    for (unsigned int attempt = 0; attempt < 10 && _dir.empty(); ++attempt)
+    {
+        auto dir = base / ("multovl-spill-" + std::to_string(rnd()));
+        if (std::filesystem::create_directories(dir, ec))
+            _dir = dir;
+    }
+    if (_dir.empty())
+        fail("Cannot create temporary directory in " + base.string());
+}
+
+SpillStore::~SpillStore()
+{
+    if (!_dir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(_dir, ec);
+    }
+}
+
+bool SpillStore::add(std::string_view chrom, const BaseRegion& reg, unsigned int trackid)
+{
+    auto it = _chroms.find(chrom);
+    if (it == _chroms.end())
+    {
+        it = _chroms.emplace(std::string(chrom), Chrom()).first;
+        it->second.path = _dir / ("chrom" + std::to_string(_chroms.size()) + ".tmp");
+    }
+    Chrom& ch = it->second;
+    std::size_t oldsize = ch.buffer.size();
+    put_record(ch.buffer, reg, trackid);
+    ++ch.regcnt;
+    ch.bytecnt += ch.buffer.size() - oldsize;
+    _buffered += ch.buffer.size() - oldsize;
+    return _buffered <= _budget || flush();
+}
+
+bool SpillStore::flush()
+{
+    if (!_error.empty())
+        return false;
+    for (auto& cm : _chroms)
+    {
+        Chrom& ch = cm.second;
+        if (ch.buffer.empty())
+            continue;
+        std::ofstream out(ch.path, std::ios::binary | std::ios::app);
+        out.write(ch.buffer.data(), ch.buffer.size());
+        out.close();
+        if (out.fail())
+            return fail("Cannot write temporary file " + ch.path.string());
+        std::string().swap(ch.buffer);  // release the memory
+    }
+    _buffered = 0;
+    return true;
+}
+
+std::vector<std::string> SpillStore::chroms() const
+{
+    std::vector<std::string> names;
+    for (const auto& cm : _chroms) {
+        names.push_back(cm.first);
+    }
+    return names;
+}
+
+std::uint64_t SpillStore::region_count(const std::string& chrom) const
+{
+    auto it = _chroms.find(chrom);
+    return it == _chroms.end()? 0: it->second.regcnt;
+}
+
+std::uint64_t SpillStore::byte_count(const std::string& chrom) const
+{
+    auto it = _chroms.find(chrom);
+    return it == _chroms.end()? 0: it->second.bytecnt;
+}
+
+bool SpillStore::read(const std::string& chrom, const sink_t& sink)
+{
+    auto it = _chroms.find(chrom);
+    if (it == _chroms.end() || it->second.regcnt == 0)
+        return true;
+    std::ifstream in(it->second.path, std::ios::binary);
+    if (!in)
+        return fail("Cannot read temporary file " + it->second.path.string());
+    
+    std::string chunk;
+    std::vector<SortKey> keys;
+    BaseRegion reg;
+    unsigned int trackid;
+    std::string name;
+    std::uint64_t regcnt = 0;
+    while (read_chunk(in, chunk, keys, READCHUNK))
+    {
+        for (const auto& key : keys)
+        {
+            get_record(chunk.data() + key.offset, reg, trackid, name);
+            sink(reg, trackid);
+        }
+        regcnt += keys.size();
+    }
+    if (regcnt != it->second.regcnt)
+        return fail("Truncated temporary file " + it->second.path.string());
+    return true;
+}
+
+bool SpillStore::read_sorted(const std::string& chrom, const sink_t& sink)
+{
+    auto it = _chroms.find(chrom);
+    if (it == _chroms.end() || it->second.regcnt == 0)
+        return true;
+    const Chrom& ch = it->second;
+    std::ifstream in(ch.path, std::ios::binary);
+    if (!in)
+        return fail("Cannot read temporary file " + ch.path.string());
+    
+    // sort the file chunk by chunk, a chunk takes up at most half of the budget,
+    // the sort keys the other half
+    std::string chunk;
+    std::vector<SortKey> keys;
+    BaseRegion reg;
+    unsigned int trackid;
+    std::string name;
+    auto less = [](const SortKey& k1, const SortKey& k2) { return k1.first < k2.first; };
+    std::vector<std::filesystem::path> runs;
+    std::uint64_t regcnt = 0;
+    while (read_chunk(in, chunk, keys, _budget / 2))
+    {
+        std::stable_sort(keys.begin(), keys.end(), less);
+        regcnt += keys.size();
+        if (runs.empty() && in.peek() == std::ifstream::traits_type::eof())
+        {
+            // all regions fit into the budget
+            for (const auto& key : keys)
+            {
+                get_record(chunk.data() + key.offset, reg, trackid, name);
+                sink(reg, trackid);
+            }
+            return regcnt == ch.regcnt || fail("Truncated temporary file " + ch.path.string());
+        }
+        
+        // write a sorted run
+        runs.push_back(ch.path.string() + ".run" + std::to_string(runs.size()));
+        std::ofstream out(runs.back(), std::ios::binary);
+        for (const auto& key : keys)
+        {
+            std::uint32_t namelen;
+            std::memcpy(&namelen, chunk.data() + key.offset + 12, 4);
+            out.write(chunk.data() + key.offset, RECHEADLEN + namelen);
+        }
+        out.close();
+        if (out.fail())
+            return fail("Cannot write temporary file " + runs.back().string());
+    }
+    if (regcnt != ch.regcnt)
+        return fail("Truncated temporary file " + ch.path.string());
+    std::string().swap(chunk);
+    std::vector<SortKey>().swap(keys);
+    
+    // merge the runs: the smallest first position comes first,
+    // the earlier run on ties so that the order of addition is kept
+    std::vector<std::ifstream> runins;
+    std::vector<std::string> recs(runs.size());
+    typedef std::pair<unsigned int, std::size_t> head_t;  // first position, run index
+    std::priority_queue<head_t, std::vector<head_t>, std::greater<head_t>> heads;
+    for (std::size_t r = 0; r < runs.size(); ++r)
+    {
+        runins.emplace_back(runs[r], std::ios::binary);
+        if (read_record(runins[r], recs[r]))
+            heads.emplace(record_first(recs[r].data()), r);
+    }
+    while (!heads.empty())
+    {
+        std::size_t r = heads.top().second;
+        heads.pop();
+        get_record(recs[r].data(), reg, trackid, name);
+        sink(reg, trackid);
+        recs[r].clear();
+        if (read_record(runins[r], recs[r]))
+            heads.emplace(record_first(recs[r].data()), r);
+    }
+    
+    std::error_code ec;
+    for (const auto& run : runs) {
+        std::filesystem::remove(run, ec);
+    }
+    return true;
+}
+
+void SpillStore::release(const std::string& chrom)
+{
+    auto it = _chroms.find(chrom);
+    if (it != _chroms.end())
+    {
+        std::error_code ec;
+        std::filesystem::remove(it->second.path, ec);
+        _chroms.erase(it);
+    }
+}
+
+// Records an error, always returns /false/. Private
+bool SpillStore::fail(const std::string& msg)
+{
+    _error = msg;
+    return false;
+}
+
+// Reads the next chunk of records from /in/.
+// \param chunk the records are stored here
+// \param keys the sort keys of the records in /chunk/ in their original order
+// \param limit the chunk and the keys take up about this many bytes at most
+// \return /false/ if there were no more records
+// Private
+bool SpillStore::read_chunk(std::ifstream& in, std::string& chunk, 
+    std::vector<SortKey>& keys, std::size_t limit)
+{
+    chunk.clear();
+    keys.clear();
+    while (chunk.size() + keys.size() * sizeof(SortKey) < limit)
+    {
+        std::size_t offset = chunk.size();
+        if (!read_record(in, chunk))
+        {
+            chunk.resize(offset);
+            break;
+        }
+        keys.push_back(SortKey{ record_first(chunk.data() + offset), offset });
+    }
+    return !keys.empty();
+}
+
+}   // namespace io
+}   // namespace multovl
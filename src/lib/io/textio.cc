@@ -38,17 +38,24 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "multovl/io/textio.hh"
 #include "multovl/io/linereader.hh"
+#include "multovl/io/charscan.hh"
+#include "multovl/io/inflater.hh"
 
 // -- Standard library --
 
-#include <sstream>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
-#include <stdexcept>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <thread>
 
 // -- Boost headers --
 
-#include "boost/algorithm/string.hpp"
-#include "boost/lexical_cast.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/exceptions.hpp"
 
 // == Implementation ==
 
@@ -62,16 +69,20 @@ TextReader::TextReader(
     Fileformat::Kind format
 ):
     TrackReader(),
+    _format(format),
     _lrp(nullptr),
-    _inf(),
+    _region(),
+    _buffer(),
+    _inflater(nullptr),
+    _text(),
+    _pos(nullptr), _end(nullptr),
     _linecount(0),
-    _valid(false)
+    _valid(false),
+    _inflateerr(false)
 {
     
-    // input line reader (parser) factory
-    if (format == Fileformat::BED) _lrp = new BedLinereader();
-    else if (format == Fileformat::GFF) _lrp = new GffLinereader();
-    else
+    _lrp = make_linereader();
+    if (_lrp == nullptr)
     {
         // invalid state
     	// use parent class' add_error as there's no meaningful linecount to store
@@ -82,8 +93,7 @@ TextReader::TextReader(
         return;
     }
     
-    _inf.open(infname.c_str());
-    if (!_inf)  // could not open
+    if (!open(infname))
     {
     	// invalid state
         TrackReader::add_error("Cannot open input file: " + infname);
@@ -99,10 +109,11 @@ std::string TextReader::read_into(std::string& chrom, BaseRegion& reg)
     if (!is_valid())
         return "Cannot read";
         
-    while (std::getline(_inf, _line))
+    std::string_view line;
+    while (read_line(line))
     {
         ++_linecount;
-        Linereader::Status status = _lrp->parse(_line);
+        Linereader::Status status = _lrp->parse(line);
         if (status & Linereader::ERROR)
         {
             add_error(_lrp->error_msg());
@@ -125,12 +136,51 @@ std::string TextReader::read_into(std::string& chrom, BaseRegion& reg)
         }
         // anything else (comments etc.) get ignored, keep reading...
     }
+    if (_inflateerr)
+    {
+        // the decompression error is reported once, the input ends there
+        _inflateerr = false;
+        add_error("Cannot decompress input: " + _inflater->error());
+        return errors().last_error();
+    }
     return "EOF";
 }
 
+unsigned int TextReader::read_all(TrackBuffer& track, unsigned int threads)
+{
+    if (!is_valid())
+        return 0;
+    
+    // compressed input is decompressed and parsed in large batches
+    threads = std::max(1u, threads);
+    std::size_t batchsize = std::max<std::size_t>(BATCHSIZE, threads * MINCHUNK);
+    unsigned int problemcnt = 0;
+    while (true)
+    {
+        // parse the complete lines available so far
+        bool more = (_inflater != nullptr && !_inflater->finished());
+        const char* last = _end;
+        if (more)
+        {
+            std::string_view::size_type nl = std::string_view(_pos, _end - _pos).rfind('\n');
+            last = (nl == std::string_view::npos)? _pos: _pos + nl + 1;
+        }
+        problemcnt += parse_lines(last, track, threads);
+        if (!more)
+            break;
+        refill(batchsize, threads);
+    }
+    if (_inflateerr)
+    {
+        _inflateerr = false;
+        add_error("Cannot decompress input: " + _inflater->error());
+        ++problemcnt;
+    }
+    return problemcnt;
+}
+
 TextReader::~TextReader()
 {
-    _inf.close();
     if (_lrp != nullptr)
     {
         delete _lrp;
@@ -141,9 +191,198 @@ TextReader::~TextReader()
 void TextReader::add_error(const std::string& msg)
 {
     std::string err = 
-        "At line " + boost::lexical_cast<std::string>(_linecount) + ": " + msg;
+        "At line " + std::to_string(_linecount) + ": " + msg;
     TrackReader::add_error(err);
 }
 
+// \return a new line parser for the input format, or nullptr if the format is not a text format
+// Private
+Linereader* TextReader::make_linereader() const
+{
+    if (_format == Fileformat::BED) return new BedLinereader();
+    if (_format == Fileformat::GFF) return new GffLinereader();
+    return nullptr;
+}
+
+// Maps the input file into memory. Files which cannot be mapped 
+// (e.g. empty files or pipes) are read into an internal buffer instead.
+// Gzip-compressed files are decompressed part by part into _text while reading.
+// \return /true/ on success
+// Private
+bool TextReader::open(const std::string& infname)
+{
+    bool mapped = false;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(infname, ec);
+    if (!ec && size > 0)
+    {
+        try
+        {
+            namespace bip = boost::interprocess;
+            bip::file_mapping mapping(infname.c_str(), bip::read_only);
+            bip::mapped_region region(mapping, bip::read_only);
+            region.advise(bip::mapped_region::advice_sequential);
+            _region.swap(region);
+            _pos = static_cast<const char*>(_region.get_address());
+            _end = _pos + _region.get_size();
+            mapped = true;
+        }
+        catch (const boost::interprocess::interprocess_exception&)
+        {
+            // fall back to reading
+        }
+    }
+    
+    if (!mapped)
+    {
+        std::ifstream inf(infname.c_str(), std::ios::binary);
+        if (!inf)
+            return false;
+        _buffer.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+        _pos = _buffer.data();
+        _end = _pos + _buffer.size();
+    }
+    
+    if (Inflater::is_gzip(_pos, _end))
+    {
+        _inflater = std::make_unique<Inflater>(_pos, _end);
+        _pos = _end = _text.data();
+    }
+    return true;
+}
+
+// Parses the lines from the current position up to /last/ into /track/ like read_into() does.
+// Large inputs are split into chunks which are parsed in parallel by up to /threads/ threads,
+// the chunks are joined in input order.
+// \return the number of lines that could not be parsed
+// Private
+unsigned int TextReader::parse_lines(const char* last, TrackBuffer& track, unsigned int threads)
+{
+    // split the input into chunks of about the same size,
+    // each chunk starts at the beginning of a line
+    std::size_t size = last - _pos;
+    std::size_t chunkcnt = std::max<std::size_t>(1, std::min<std::size_t>(threads, size / MINCHUNK));
+    std::vector<const char*> bounds{_pos};
+    for (std::size_t i = 1; i < chunkcnt; ++i)
+    {
+        const char* approx = std::max(_pos + size * i / chunkcnt, bounds.back());
+        const char* nl = Charscan::find(approx, last, '\n');
+        bounds.push_back((nl == last)? last: nl + 1);
+    }
+    bounds.push_back(last);
+    
+    std::vector<Chunk> chunks(chunkcnt);
+    if (chunkcnt == 1)
+    {
+        parse_chunk(_pos, last, chunks[0]);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < chunkcnt; ++i)
+        {
+            workers.emplace_back(&TextReader::parse_chunk, this, 
+                bounds[i], bounds[i + 1], std::ref(chunks[i]));
+        }
+        for (auto& w : workers) { w.join(); }
+    }
+    
+    // join the chunks in input order, the line numbers of the errors
+    // are offset by the number of lines in the preceding chunks
+    unsigned int problemcnt = 0, linebase = _linecount;
+    for (auto& chunk : chunks)
+    {
+        for (const auto& err : chunk.errors)
+        {
+            _linecount = linebase + err.first;
+            add_error(err.second);
+            ++problemcnt;
+        }
+        linebase += chunk.linecount;
+        track.append(std::move(chunk.regions));
+    }
+    _linecount = linebase;
+    _pos = last;
+    return problemcnt;
+}
+
+// Parses the lines in [pos, end) into /chunk/ like read_into() does.
+// Invoked in parallel for different chunks, uses a parser of its own.
+// Private
+void TextReader::parse_chunk(const char* pos, const char* end, Chunk& chunk) const
+{
+    std::unique_ptr<Linereader> lrp(make_linereader());
+    BaseRegion reg;
+    std::string_view line;
+    while (next_line(pos, end, line))
+    {
+        ++chunk.linecount;
+        Linereader::Status status = lrp->parse(line);
+        if (status & Linereader::ERROR)
+        {
+            chunk.errors.emplace_back(chunk.linecount, lrp->error_msg());
+            continue;
+        }
+        if (status & Linereader::DATA)
+        {
+            if (lrp->read_into(reg))
+                chunk.regions.add(lrp->chrom(), reg);
+            else
+                chunk.errors.emplace_back(chunk.linecount, lrp->error_msg());
+        }
+    }
+}
+
+// Sets /line/ to the next line of the input without the line terminator.
+// Compressed input is decompressed as needed.
+// \return /false/ if the input has been exhausted
+// Private
+bool TextReader::read_line(std::string_view& line)
+{
+    const char* nl = Charscan::find(_pos, _end, '\n');
+    while (nl == _end && refill(BATCHSIZE, 1))
+    {
+        nl = Charscan::find(_pos, _end, '\n');   // the partial line is scanned again
+    }
+    if (_pos == _end)
+        return false;
+    line = std::string_view(_pos, nl - _pos);
+    _pos = (nl == _end)? _end: nl + 1;
+    return true;
+}
+
+// Decompresses the next part of a compressed input and appends it to the unread text.
+// Decompression errors are flagged in _inflateerr, they are reported
+// after the text decompressed before the error has been parsed.
+// \param size about this many bytes are decompressed
+// \param threads the number of threads decompressing BGZF blocks
+// \return /true/ if new text has been appended
+// Private
+bool TextReader::refill(std::size_t size, unsigned int threads)
+{
+    if (_inflater == nullptr || _inflater->finished())
+        return false;
+    _text.erase(0, _pos - _text.data());
+    std::size_t len = _inflater->inflate(_text, size, threads);
+    _pos = _text.data();
+    _end = _pos + _text.size();
+    _inflateerr = !_inflater->error().empty();
+    return len > 0;
+}
+
+// Sets /line/ to the line starting at /pos/ without the line terminator
+// and advances /pos/ to the beginning of the next line.
+// \return /false/ if the input [pos, end) has been exhausted
+// Private
+bool TextReader::next_line(const char*& pos, const char* end, std::string_view& line)
+{
+    if (pos == end)
+        return false;
+    const char* nl = Charscan::find(pos, end, '\n');
+    line = std::string_view(pos, nl - pos);
+    pos = (nl == end)? end: nl + 1;
+    return true;
+}
+
 }   // namespace io
 }   // namespace multovl
@@ -32,34 +32,55 @@ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
 THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 </LICENSE> */
-// == MODULE region.cc ==
+// == MODULE trackbuffer.cc ==
 
 // -- Own header --
 
-#include "multovl/region.hh"
+#include "multovl/io/trackbuffer.hh"
 
-// -- Implementation --
+// -- Standard headers --
 
-namespace multovl {
+#include <iterator>
 
-// -- BaseRegion methods
+// == Implementation ==
 
-// by default the region limits are not extended
-unsigned int Region::_extension = 0;
+namespace multovl {
+namespace io {
 
-unsigned int Region::first() const {
-    unsigned int realfirst = BaseRegion::first();
-    return extension() > realfirst? 0: realfirst - extension(); 
+void TrackBuffer::add(std::string_view chrom, const BaseRegion& reg)
+{
+    if (_parts.empty())
+        _parts.emplace_back();
+    Part& part = _parts.back();
+    const std::string& name = reg.name();
+    part.records.push_back(Record{reg.first(), reg.last(), part.names.size(), 
+        static_cast<unsigned int>(name.size()), part.chroms.intern(chrom), reg.strand()});
+    part.names += name;
 }
 
-unsigned int Region::last() const {
-    return BaseRegion::last() + extension();
+void TrackBuffer::append(TrackBuffer&& other)
+{
+    if (_parts.empty())
+    {
+        _parts = std::move(other._parts);
+    }
+    else
+    {
+        _parts.insert(_parts.end(), 
+            std::make_move_iterator(other._parts.begin()), 
+            std::make_move_iterator(other._parts.end()));
+    }
+    other._parts.clear();
 }
 
-void Region::set_coords(unsigned int f, unsigned int l) {
-    unsigned int truefirst = f + extension();
-    unsigned int truelast = l - extension();
-    BaseRegion::set_coords(truefirst, truelast);
+std::size_t TrackBuffer::size() const
+{
+    std::size_t cnt = 0;
+    for (const auto& part : _parts) {
+        cnt += part.records.size();
+    }
+    return cnt;
 }
 
+}   // namespace io
 }   // namespace multovl
@@ -0,0 +1,161 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+
+// == MODULE trackcache.cc ==
+
+// -- Own header --
+
+#include "multovl/io/trackcache.hh"
+#include "multovl/io/binio.hh"
+
+// -- Standard headers --
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// == Implementation ==
+
+namespace {
+
+// Mixes a 64-bit word into the hash value.
+// One multiplication per word keeps hashing much faster than reading the file.
+inline std::uint64_t mix(std::uint64_t h, std::uint64_t word)
+{
+    h ^= word * 0x9E3779B97F4A7C15ull;
+    h = (h << 31) | (h >> 33);
+    return h * 0xC2B2AE3D27D4EB4Full;
+}
+
+std::uint64_t hash_bytes(std::uint64_t h, const char* data, std::size_t len)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = mix(h, word);
+    }
+    if (i < len)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + i, len - i);
+        h = mix(h, word);
+    }
+    return mix(h, len);
+}
+
+}   // end of unnamed namespace
+
+namespace multovl {
+namespace io {
+
+std::uint64_t content_hash(const std::string& fname)
+{
+    std::ifstream inf(fname.c_str(), std::ios::binary);
+    if (!inf)
+        return 0;
+    
+    // the chunk size is a multiple of 8 so that the words do not depend on it
+    std::vector<char> buffer(1 << 20);
+    std::uint64_t h = 0;
+    while (inf)
+    {
+        inf.read(buffer.data(), buffer.size());
+        h = hash_bytes(h, buffer.data(), inf.gcount());
+    }
+    return inf.bad()? 0: h;
+}
+
+std::string cache_entry(const std::string& cachedir, const std::string& infname)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path path = fs::canonical(infname, ec);
+    if (ec || !fs::is_regular_file(path, ec))
+        return "";
+    std::uintmax_t size = fs::file_size(path, ec);
+    if (ec)
+        return "";
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec)
+        return "";
+    
+    std::string pathstr = path.string();
+    std::uint64_t key = hash_bytes(0, pathstr.data(), pathstr.size());
+    key = mix(key, size);
+    key = mix(key, mtime.time_since_epoch().count());
+    key = mix(key, content_hash(pathstr));
+    
+    std::ostringstream name;
+    name << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << key << ".mtb";
+    return (fs::path(cachedir) / name.str()).string();
+}
+
+bool store_cache_entry(const BinaryWriter& regions, const std::string& entry)
+{
+    // write a temporary file which is unique among concurrent processes and threads,
+    // then rename it, which is atomic
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(entry).parent_path(), ec);
+    std::ostringstream tmpname;
+    tmpname << entry << '.' << std::random_device()() << '.' 
+        << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+    if (!regions.write(tmpname.str()))
+    {
+        fs::remove(tmpname.str(), ec);
+        return false;
+    }
+    fs::rename(tmpname.str(), entry, ec);
+    if (ec)
+    {
+        fs::remove(tmpname.str(), ec);
+        return false;
+    }
+    return true;
+}
+
+}   // namespace io
+}   // namespace multovl
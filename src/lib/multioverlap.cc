@@ -38,10 +38,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "multovl/multioverlap.hh"
 
-// -- Boost headers --
-
-#include "boost/lexical_cast.hpp"
-
 // -- System headers --
 
 #include <sstream>
@@ -52,337 +48,84 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace multovl {
 
-namespace impl {
-    /**
-     * Encapsulates the parameters according to which the generated multiregions
-     * should be filtered: the minimal overlap length, the minimal and maximal
-     * multiplicity. Provides a method to filter nascent multiregions.
-     */
-    class Filter
-    {
-    public:
-        
-        /**
-         * Constructs a Filter.
-         * \param ovlen must be >=1, adjusted silently
-         * \param minmult minimal multiplicity, must be >=1 
-         * \param maxmult must be >=0, 0 means any multiplicity >= minmult is accepted; 
-         * if /minmult/ > /maxmult/ then they are swapped silently
-         * \param checksoli if /true/, then only solitary regions will be accepted
-         * if /minmult/ == 1
-         * (this sets /intrack/ to /true/, and /ovlen/ to 1)
-         * \param intrack if /true/, then overlaps within the same track are accepted as well,
-         * otherwise overlaps within the same track only are filtered out.
-         */
-        Filter(unsigned int ovlen, unsigned int minmult, 
-                unsigned int maxmult, bool checksoli, bool intrack=true):
-            _ovlen((ovlen<1)? 1: ovlen),
-            _minmult((minmult<1)? 1: minmult),
-            _maxmult(maxmult), _intrack(intrack)
-        {
-            // silent swapping: note _maxmult == 0 means _maxmult == infinity
-            if (_maxmult > 0 && _minmult > _maxmult) std::swap(_minmult, _maxmult);
-    
-            // do we detect solitary regions?
-            _solitary = checksoli && minmult == 1;
-            if (_solitary)
-            {
-                _ovlen = 1;   // longer ovlen wouldn't make sense
-                _intrack = true;   // do check intra-track overlaps
-            }
-        }
-
-        /**
-         * Checks whether a "nascent" multiregion (not yet constructed)
-         * should be accepted as new multiregion.
-         * \param mrstart the first position of the new multiregion
-         * \param mrend the last position of the new multiregion
-         * \param ancestors the set of ancestor regions
-         * \param mult the desired multiplicity of the new multiregion.
-         * This is usually ancestors.size(), but you need to specify a different value
-         * for union regions. Moreover, this method may override /mult/ if
-         * intra-track filtering is switched on.
-         * \return /true/ if the multiregion may be accepted.
-         */
-        bool accept_new_region(unsigned int mrstart, unsigned int mrend,
-            const ancregset_t& ancestors, unsigned int& mult) const
-        {
-            // solitary region required
-            // accept if there is only one ancestor with equal position
-            if (_solitary && ancestors.size() == 1)
-            {
-                const Region& anc = *ancestors.begin();
-                return (anc.first() == mrstart && anc.last() == mrend);
-            }
-    
-            // generic non-solitary case
-            if (!_intrack)
-            {
-                unsigned int distrcnt = distinct_track_count(ancestors);
-                if (distrcnt == 1)
-                {
-                    // do not accept overlaps within the same track only
-                    return false;
-                }
-                else
-                {
-                    // override the multiplicity: use the number of distinct tracks
-                    // contributing to the overlap
-                    // this is a lame workaround for track-filtered complex overlaps
-                    mult = distrcnt;
-                }
-            }
-    
-            unsigned int mlen = mrend - mrstart + 1;
-            return (_minmult <= mult && mlen >= _ovlen && 
-                (_maxmult == 0 || mult <= _maxmult));
-        }
-            
-    private:
-        
-        // Count the distinct tracks that make up an ancestry.
-        // \param ancestors the set of ancestors of a candidate multiregion.
-        // \return the number of distinct tracks in the ancestry. If there were no intra-track
-        // overlaps, then this is equal to ancestors.size(), otherwise it is less because
-        // some tracks occur in the ancestor set more than once.
-        static
-        unsigned int distinct_track_count(const ancregset_t& ancestors)
-        {
-            std::set<unsigned int> trackidset;
-            for (const auto& anc : ancestors) {
-                unsigned int trackid = anc.track_id();
-                trackidset.insert(trackid);
-            }
-            return trackidset.size();
-        }
-
-        unsigned int _ovlen, _minmult, _maxmult;
-        bool _solitary, _intrack;
-        
-    };  // class Filter
+MultiOverlap::MultiOverlap(const MultiOverlap& other):
+    _ancregions(other._ancregions),
+    _work(std::make_unique<Workspace>()),
+    _reglimext(other._reglimext),
+    _events(other._events),
+    _multiregions(other._multiregions),
+    _engine(other._engine)
+{
+    nonconst_reglims().insert(other.reglims().begin(), other.reglims().end());
+}
 
-}   // namespace impl
+MultiOverlap& MultiOverlap::operator=(const MultiOverlap& other)
+{
+    if (this != &other) {
+        MultiOverlap tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
 
-typedef std::pair<unsigned int, unsigned int> uintpair_t;
-typedef std::vector<uintpair_t> uintpairvec_t;
+void MultiOverlap::release_workspace()
+{
+    // the pool releases its memory when destroyed
+    _work = std::make_unique<Workspace>();
+    _reglimext = 0;
+    regeventvec_t().swap(_events);
+}
 
-void MultiOverlap::setup_reglims() {
-    _reglims.clear();
+void MultiOverlap::setup_reglims(unsigned int ext) {
+    nonconst_reglims().clear();
+    _reglimext = ext;
     
-    // Stores ancregions twice in the region limit map `_reglims`
-    for (const auto& ancreg : _ancregions) {
-        add_reglimit(ancreg);
+    // Stores ancregions twice in the RegLimit multiset
+    for (unsigned int idx = 0; idx < ancregions().size(); ++idx) {
+        add_reglimit(ancregions().record(idx), idx, ext);
     }
 }
 
-void MultiOverlap::add_reglimit(const AncestorRegion& ancreg) {
+void MultiOverlap::add_reglimit(const RegRecord& ancreg, unsigned int idx, unsigned int ext) {
     // add once as a "first position"
-    RegLimit limfirst(ancreg, true);
-    _reglims.insert(limfirst);
+    RegLimit limfirst(ancreg, true, idx, ext);
+    nonconst_reglims().insert(limfirst);
     // ... and then as "last position"
-    RegLimit limlast(ancreg, false);
-    _reglims.insert(limlast);
+    RegLimit limlast(ancreg, false, idx, ext);
+    nonconst_reglims().insert(limlast);
 }
 
-unsigned int MultiOverlap::find_overlaps(
-        unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
-        unsigned int ext, bool intrack)
+void MultiOverlap::setup_events(unsigned int ext) {
+    RegEvent::check_size(ancregions().size());
+    _events.clear();
+    _events.reserve(2 * ancregions().size());
+    for (unsigned int idx = 0; idx < ancregions().size(); ++idx) {
+        add_events(_events, ancregions().record(idx), idx, ext);
+    }
+    std::sort(_events.begin(), _events.end());
+}
+
+void MultiOverlap::add_events(regeventvec_t& events, 
+    const RegRecord& ancreg, unsigned int idx, unsigned int ext)
 {
-    // Extend the region limits if required
-    Region::set_extension(ext);
-    
-    // Set up the region limits based on the current contents of `_ancregions`
-    setup_reglims();
-    
-    // generate the overlaps
-    unsigned int regcount = generate_overlaps(ovlen, minmult, maxmult, intrack);
-    
-    // reset the extensions
-    Region::set_extension(0);
-    return regcount;
+    events.emplace_back(ancreg.extended_first(ext), true, idx);
+    events.emplace_back(ancreg.extended_last(ext), false, idx);
 }
 
-unsigned int MultiOverlap::generate_overlaps(
-        unsigned int ovlen, unsigned int minmult, unsigned int maxmult, bool intrack)
+unsigned int MultiOverlap::find_overlaps(
+        unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+        unsigned int ext, bool intrack)
 {
-    // set up filter params with solitary checking
-    impl::Filter filter(ovlen, minmult, maxmult, true, intrack);
-    
-    unsigned int pos = 0, mrstart = 0, mrend = 0, mult = 0, regcount = 0;
-    bool istempthere = false;
-    ancregset_t ancestors;  // set of ancestors
     _multiregions.clear();
-    
-    // iterate over the region limits which have already been set up
-    reglimset_t::const_iterator lowbound = reglims().begin(), upbound;
-    while (reglims().end() != lowbound)
-    {
-        pos = lowbound->this_pos(); // current region limit position
-        upbound = reglims().upper_bound(*lowbound);
-
-        // the lowbound/upbound pair corresponds to the STL range
-        // of all RegLimit objects in reglims()
-        // that were at position pos        
-        // iterate over them all
-        for (reglimset_t::const_iterator rmiter = lowbound;
-                rmiter != upbound; ++rmiter)
-        {
-#ifndef NDEBUG
-            std::cerr << "** pos = " << pos << ", other = " << rmiter->other_pos()
-                <<": track = " << rmiter->track_id() << " isfirst = " << rmiter->is_first() << ": ";
-            for (const auto& anc : ancestors) {
-                std::cerr << anc.to_attrstring() << '|';
-            }
-            std::cerr << std::endl;
-#endif
-            if (rmiter->is_first())
-            {
-                // Region starts here
-                // finish prev region if applicable, 1 pos before current
-                // and start new one at current pos
-                if (istempthere && pos>mrstart)
-                {
-                    mrend = pos-1;
-                    mult = ancestors.size();    // can be overwritten when filtering intra-track ovls
-                    if (filter.accept_new_region(mrstart, mrend, ancestors, mult))
-                    {
-                        _multiregions.emplace_back(mrstart, mrend, ancestors, mult);
-                        ++regcount;
-                    }
-                }
-                mrstart = pos;
-                ancestors.insert(rmiter->region());   // save ancestor
-#ifndef NDEBUG
-				std::cerr << "** mrstart = " << pos << std::endl;
-				std::cerr << "** save ancestor: " << 
-				    rmiter->region().to_attrstring() << std::endl;
-				std::cerr << "** ancestorcnt = " << ancestors.size() << std::endl;
-#endif
-                istempthere = true;
-            }
-            else
-            {
-                // region ends here
-                // finish prev region if applicable at current pos
-                // start new one at current pos+1 if Idset is not empty
-                if (istempthere && mrend<pos)
-                {
-                    mrend = pos;
-                    mult = ancestors.size();
-                    if (filter.accept_new_region(mrstart, mrend, ancestors, mult))
-                    {
-                        _multiregions.emplace_back(mrstart, mrend, ancestors, mult);
-                        ++regcount;
-                    }
-                    mrstart = pos+1;
-                }
-                
-                // remove the ancestor rmiter is pointing to
-                // rmiter->is_first() == false, its _otherpos is the end pos
-                // NOTE: remove_if() cannot be used on associative containers!
-                // (my SGI STL description didn't tell me *that*...)
-                ancestors.erase(rmiter->region());
-                istempthere = !ancestors.empty();
-            }
-        }
-        lowbound = upbound;  // move on
-    }
-    return regcount;
+    return find_overlaps(ovlen, minmult, maxmult, ext, intrack, overlap_sink());
 }
 
 unsigned int MultiOverlap::find_unionoverlaps(
         unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
         unsigned int ext)
 {
-    // Extend the region limits if required
-    Region::set_extension(ext);
-    
-    // Set up the region limits
-    setup_reglims();
-    
-    // generate the union overlaps
-    unsigned int regcount = generate_unionoverlaps(ovlen, minmult, maxmult);
-        
-    // reset the extensions
-    Region::set_extension(0);
-    return regcount;
-}
-
-unsigned int MultiOverlap::generate_unionoverlaps(
-        unsigned int ovlen, unsigned int minmult, unsigned int maxmult)
-{
-    // set up filter params without solitary checking
-    // intra-track overlaps are always allowed
-    impl::Filter filter(ovlen, minmult, maxmult, false);
-
-    unsigned int pos = 0, mrstart = 0, mrend = 0, mult = 0, multmax = 0, regcount = 0;
-    ancregset_t ancestors;  // set of ancestors
     _multiregions.clear();
-    
-    // iterate over the region limit multimap which was set up already
-    reglimset_t::const_iterator lowbound = reglims().begin(), upbound;
-    while (reglims().end() != lowbound )
-    {
-        pos = lowbound->this_pos();    // this is the new position
-        upbound = reglims().upper_bound(*lowbound);
-
-        // the lowbound/upbound pair corresponds to the STL range
-        // of all RegLimit objects in reglims()
-        // that were at position pos
-        // iterate over them all
-        for (reglimset_t::const_iterator rmiter = lowbound;
-                rmiter!= upbound; ++rmiter)
-        {
-#ifndef NDEBUG
-            std::cerr << "** pos = " << pos << ", other = " << rmiter->other_pos()
-                <<": track = " << rmiter->track_id() << " isfirst = " << rmiter->is_first() << ": ";
-            for (const auto& anc : ancestors) {
-                std::cerr << anc.to_attrstring() << '|';
-            }
-            std::cerr << std::endl;
-#endif
-            if (rmiter->is_first())
-            {
-                // Region starts here
-                if (mult == 0)   // remember if a new union region is started here
-                    mrstart = pos;
-                ancestors.insert(rmiter->region());   // save ancestor
-#ifndef NDEBUG
-				std::cerr << "** mrstart = " << pos << std::endl;
-				std::cerr << "** save ancestor: " << 
-				    rmiter->region().to_attrstring() << std::endl;
-				std::cerr << "** save track: " << rmiter->track_id() << std::endl;
-				std::cerr << "** ancestorcnt = " << ancestors.size() << std::endl;
-#endif
-                mult += 1;  // add to (maximal) multiplicity
-                if (mult > multmax) multmax = mult;
-            }
-            else
-            {
-                // region ends here
-                mult -= 1;
-                // finish if there are no overlapping regions left
-                if (mult == 0)
-                {
-                    mrend = pos;
-                    
-                    // check if this currently ended region needs to be saved
-                    if (filter.accept_new_region(mrstart, mrend, ancestors, multmax))
-                    {
-                        MultiRegion newregion(mrstart, mrend, ancestors, multmax);
-                        _multiregions.push_back(newregion);
-                        ++regcount;
-                    }
-                    
-                    // forget multiplicity, ancestors
-                    multmax = 0;
-                    ancestors.clear();
-                }
-            }
-        }
-        lowbound = upbound;  // move on
-    }
-    return regcount;
+    return find_unionoverlaps(ovlen, minmult, maxmult, ext, overlap_sink());
 }
 
 void MultiOverlap::overlap_stats(Counter& counter) const
@@ -396,20 +139,27 @@ void MultiOverlap::overlap_stats(Counter& counter) const
 
 void MultiOverlap::Counter::count(const MultiRegion& mr)
 {
-    std::vector<int> ancids = mr.ancestor_trackids();    // local copy!
-    std::sort(ancids.begin(), ancids.end());
-    std::vector<int>::iterator ancidsend =      // new end after unique-ing
-        std::unique(ancids.begin(), ancids.end());
-    std::string key = get_key(ancids.begin(), ancidsend);
+    // set one bit per contributing track, no need to sort or deduplicate
+    std::uint64_t bits = 0;
+    unsigned int maxid = 0;
+    for (unsigned int i = 0; i < mr.ancestor_count(); ++i) {
+        unsigned int trackid = mr.ancestor_record(i).track_id();
+        if (trackid < 64) {
+            bits |= std::uint64_t(1) << trackid;
+        }
+        maxid = std::max(maxid, trackid);
+    }
     
-    histo_t::iterator it = _histo.find(key);
-    if (it != _histo.end())
-    {
-        // val already present, increase count
-        it->second++;
+    if (maxid < 64) {
+        ++_histo[bits];
     } else {
-        // add val with a count of 1
-        _histo[key] = 1;
+        // rare: very many tracks
+        widekey_t key(maxid / 64 + 1, 0);
+        for (unsigned int i = 0; i < mr.ancestor_count(); ++i) {
+            unsigned int trackid = mr.ancestor_record(i).track_id();
+            key[trackid / 64] |= std::uint64_t(1) << (trackid % 64);
+        }
+        ++_widehisto[key];
     }
     _total++;
 }
@@ -417,52 +167,57 @@ void MultiOverlap::Counter::count(const MultiRegion& mr)
 MultiOverlap::Counter& MultiOverlap::Counter::operator+=(const Counter& other)
 {
     this->_total += other.total();  // easy :-)
-    
-    // for each entry in /other/, check if the key is already available in this.
-    // if yes, then add the count, if not, then insert
     for (const auto& oth : other._histo) {
-        std::string otherkey = oth.first;
-        histo_t::iterator thisit = _histo.find(otherkey);
-        if (thisit == _histo.end())
-        {
-            // otherkey is not in this, so insert
-            _histo[otherkey] = oth.second;
-        }
-        else
-        {
-            // otherkey already present, increase count
-            thisit->second += oth.second;
-        }
+        _histo[oth.first] += oth.second;
+    }
+    for (const auto& oth : other._widehisto) {
+        _widehisto[oth.first] += oth.second;
     }
-    
     return *this;
 }
 
 std::string MultiOverlap::Counter::to_string() const
 {
-    if (_histo.empty()) return "(empty)";
+    if (_histo.empty() && _widehisto.empty()) return "(empty)";
+    
+    // the entries are listed in the order of their keys as strings
+    std::vector<std::pair<std::string, unsigned int>> entries;
+    entries.reserve(_histo.size() + _widehisto.size());
+    for (const auto& h : _histo) {
+        entries.emplace_back(key_str(&h.first, 1), h.second);
+    }
+    for (const auto& h : _widehisto) {
+        entries.emplace_back(key_str(h.first.data(), h.first.size()), h.second);
+    }
+    std::sort(entries.begin(), entries.end());
+    
     std::string str;
-    for (histo_t::const_iterator cit = _histo.begin();
-            cit != _histo.end(); ++cit)
-    {
-        if (cit != _histo.begin()) str += ' ';
-        str += cit->first + ':' +
-            boost::lexical_cast<std::string>(cit->second);
+    for (const auto& entry : entries) {
+        if (!str.empty()) str += ' ';
+        str += entry.first + ':' + std::to_string(entry.second);
     }
     return str;
 }
 
-std::string MultiOverlap::Counter::get_key(
-    const std::vector<int>::const_iterator& from,
-    const std::vector<int>::const_iterator& to
-)
+std::size_t MultiOverlap::Counter::WideKeyHash::operator()(const widekey_t& key) const
+{
+    std::size_t h = key.size();
+    for (auto word : key) {
+        h ^= std::hash<std::uint64_t>()(word) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+std::string MultiOverlap::Counter::key_str(const std::uint64_t* words, std::size_t wordcnt)
 {
     std::string keystr = "";
-    for (std::vector<int>::const_iterator it = from;
-        it != to; ++it)
-    {
-        if (it != from) keystr += ',';
-        keystr += boost::lexical_cast<std::string>(*it);
+    for (std::size_t w = 0; w < wordcnt; ++w) {
+        for (unsigned int b = 0; b < 64; ++b) {
+            if (words[w] & (std::uint64_t(1) << b)) {
+                if (!keystr.empty()) keystr += ',';
+                keystr += std::to_string(w * 64 + b);
+            }
+        }
     }
     return keystr;
 }
@@ -36,6 +36,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // -- Standard headers --
 
+#include <algorithm>
 #ifndef NDEBUG
 #include <iostream>
 #endif
@@ -50,77 +51,120 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace multovl {
 
+const char MultiRegion::STRAND = '.';
+const std::string MultiRegion::NAME = "overlap";
+
 MultiRegion::MultiRegion():
-    BaseRegion(0, 0, '.', "overlap"),
-    _ancestors(),
+    _first(0), _last(0),
+    _ancpool(),
+    _ancidx(),
     _solitary(false),
     _mult(0)
 {}
 
 MultiRegion::MultiRegion(unsigned int first, unsigned int last, 
     const ancregset_t& ancestors, unsigned int mult):
-    BaseRegion(first, last, '.', "overlap"), 
-    _ancestors(ancestors),
+    _first(std::min(first, last)), _last(std::max(first, last)), 
+    _ancpool(std::make_shared<ancregvec_t>(ancestors.begin(), ancestors.end())),
+    _ancidx(),
     _mult(mult>0? mult: ancestors.size())
 {
+    // the pool contains the ancestors in ascending order
+    for (unsigned int i = 0; i < ancestors.size(); ++i) {
+        _ancidx.push_back(i);
+    }
     update_solitary();
 #ifndef NDEBUG
-    std::cerr << "MultiRegion: anclen = " << _ancestors.size() << ", ancstr = \"" << anc_str() << "\"" << std::endl;
+    std::cerr << "MultiRegion: anclen = " << _ancidx.size() << ", ancstr = \"" << anc_str() << "\"" << std::endl;
+#endif
+}
+
+MultiRegion::MultiRegion(unsigned int first, unsigned int last, 
+    const ancregpool_t& ancpool, const ancidxvec_t& ancidx, unsigned int mult,
+    unsigned int ext):
+    _first(std::min(first, last)), _last(std::max(first, last)), 
+    _ancpool(ancpool),
+    _ancidx(ancidx),
+    _mult(mult>0? mult: ancidx.size())
+{
+    update_solitary(ext);
+#ifndef NDEBUG
+    std::cerr << "MultiRegion: anclen = " << _ancidx.size() << ", ancstr = \"" << anc_str() << "\"" << std::endl;
 #endif
 }
 
 void MultiRegion::add_ancestor(const AncestorRegion& anc)
 {
-    _ancestors.insert(anc);
+    // the pool may be shared, so copy the current ancestors into a new one
+    // and insert the new ancestor at the end of its equal range
+    std::vector<AncestorRegion> ancs;
+    ancs.reserve(ancestor_count() + 1);
+    for (unsigned int i = 0; i < ancestor_count(); ++i) {
+        ancs.push_back(ancestor(i));
+    }
+    auto pos = std::upper_bound(ancs.begin(), ancs.end(), anc);
+    ancs.insert(pos, anc);
+    auto pool = std::make_shared<ancregvec_t>(ancs.begin(), ancs.end());
+    
+    _ancidx.clear();
+    for (unsigned int i = 0; i < pool->size(); ++i) {
+        _ancidx.push_back(i);
+    }
+    _ancpool = pool;
     _mult++;
     update_solitary();
 }
 
+ancregset_t MultiRegion::ancestors() const
+{
+    ancregset_t ancs;
+    for (unsigned int i = 0; i < ancestor_count(); ++i) {
+        ancs.insert(ancs.end(), ancestor(i));
+    }
+    return ancs;
+}
+
 std::vector<int> MultiRegion::ancestor_trackids() const
 {
     std::vector<int> ancids;
-    ancids.reserve(ancestors().size());
-    for (const auto& anc : ancestors()) {
-        ancids.push_back(anc.track_id());
+    ancids.reserve(ancestor_count());
+    for (unsigned int i = 0; i < ancestor_count(); ++i) {
+        ancids.push_back(ancestor_record(i).track_id());
     }
     return ancids;
 }
 
 std::string MultiRegion::anc_str() const
 {
-    if (ancestors().size() == 0) {
-        // only relevant for empty
-        return "";
-    }
     std::string ancstr = "";
-    auto ait = ancestors().begin();
-    auto nextit = ait;
-    while(ait != ancestors().end()) {
+    unsigned int i = 0, n = ancestor_count();
+    while (i < n) {
         // compose the ancestor attribute string
-        if (ait != ancestors().begin()) ancstr += '|';
-        // find first element not equal to *ait
+        if (i > 0) ancstr += '|';
+        // find first element not equal to the i-th
         unsigned int cnt;
-        for(cnt = 0; nextit != ancestors().end() && *ait == *nextit; ++cnt, nextit++);
+        for (cnt = 1; i + cnt < n && _ancpool->equal(_ancidx[i], _ancidx[i + cnt]); ++cnt);
         if (cnt > 1) {
             // ancestor attribute string gets a prefix "<cnt>*"
             ancstr += std::to_string(cnt);
             ancstr += "*"; // avoid temporaries with +=
         }
-        ancstr += ait->to_attrstring();
-        ait = nextit;   // stepper
+        ancstr += _ancpool->to_attrstring(_ancidx[i]);
+        i += cnt;   // stepper
     }
     return ancstr;
 }
 
 // a MultiRegion is solitary if it has only one single ancestor
 // that is not part of any overlap: in this case the coords
-// of the ancestor are the same as those of the present region
+// of the (possibly extended) ancestor are the same as those of the present region
 // private
-bool MultiRegion::update_solitary()
+bool MultiRegion::update_solitary(unsigned int ext)
 {
-    if (ancestors().size() == 1) {
-        const auto& ancit = ancestors().begin(); // points to the one and only ancestor
-        _solitary = (ancit->first() == this->first() && ancit->last() == this->last());
+    if (ancestor_count() == 1) {
+        const RegRecord& anc = ancestor_record(0); // the one and only ancestor
+        _solitary = (anc.extended_first(ext) == this->first() && 
+            anc.extended_last(ext) == this->last());
     } else {
         _solitary = false;
     }
@@ -128,4 +172,3 @@ bool MultiRegion::update_solitary()
 }
 
 }   // namespace multovl
-
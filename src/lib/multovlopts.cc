@@ -37,6 +37,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <algorithm>
+#include <thread>
 
 // -- Own header --
 
@@ -68,6 +69,14 @@ MultovlOptbase::MultovlOptbase():
         "Do not detect overlaps within the same track, ignored if -c 1 or -u is set", 'n');
     add_bool_switch("timing", &_timing,
         "List execution times only, no region output", 't');
+    add_bool_switch("flatsweep", &_flatsweep,
+        "Detect overlaps with the flat sorted event-array engine (faster, less memory)");
+    add_option<std::string>("chroms", &_chromlist, "",
+        "Comma-separated list of the chromosomes to be analysed (default: all), "
+        "indexed BAM files are read only where they hold these chromosomes");
+    add_option<std::string>("cache", &_cachedir, "",
+        "Directory of the parsed-track cache, input files found there are not parsed again "
+        "(default: no caching)");
 }
 
 std::string MultovlOptbase::param_str() const 
@@ -78,6 +87,9 @@ std::string MultovlOptbase::param_str() const
         outstr += " -E " + boost::lexical_cast<std::string>(extension());
     if (uniregion()) outstr += " -u";
     if (nointrack()) outstr += " -n";
+    if (flatsweep()) outstr += " --flatsweep";
+    if (!_chroms.empty()) outstr += " --chroms " + _chromlist;
+    if (!_cachedir.empty()) outstr += " --cache " + _cachedir;
     if (option_seen("common-mult"))
         outstr += " -c " + boost::lexical_cast<std::string>(_copt);
     else
@@ -119,9 +131,28 @@ bool MultovlOptbase::check_variables()
         if (_uniregion) _nointrack = false;
     }
     
+    // the chromosome list, empty items are ignored
+    _chroms.clear();
+    std::string::size_type pos = 0;
+    while (pos <= _chromlist.size())
+    {
+        std::string::size_type comma = std::min(_chromlist.find(',', pos), _chromlist.size());
+        if (comma > pos)
+            _chroms.insert(_chromlist.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    
 	return (!error_status());
 }
 
+unsigned int MultovlOptbase::core_count()
+{
+    unsigned int corecount = std::thread::hardware_concurrency();
+    if (corecount == 0)
+        corecount = 1;  // could not find out core count, assume 1
+    return corecount;
+}
+
 std::ostream& MultovlOptbase::print_version(std::ostream& out) const
 {
     version_info(out);
@@ -45,7 +45,6 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <algorithm>
-#include <thread>
 
 // == Implementation ==
 
@@ -54,20 +53,12 @@ namespace prob {
 
 const unsigned int ParProbOpts::DEFAULT_THREADS = ParProbOpts::core_count();
 
-unsigned int ParProbOpts::core_count()
-{
-    unsigned int corecount = std::thread::hardware_concurrency();
-    if (corecount == 0)
-        corecount = 1;  // could not find out core count, assume 1
-    return corecount;
-}
-
 ParProbOpts::ParProbOpts():
 	ProbOpts(),
     _threads(DEFAULT_THREADS)
 {
 	add_option<unsigned int>("threads", &_threads, DEFAULT_THREADS, 
-		"Number of threads, default to use all cores", 'T');
+		"Number of threads reading the input tracks and reshuffling, default to use all cores", 'T');
 }
 
 bool ParProbOpts::check_variables()
@@ -95,7 +86,7 @@ std::ostream& ParProbOpts::print_help(std::ostream& out) const
         << "file1, file2, ... will be reshuffled, there must be at least one" << std::endl
         << "Reshuffling can be done in parallel on multicore machines" << std::endl
         << "Default number of threads on this machine is " << DEFAULT_THREADS << std::endl
-		<< "Accepted input file formats: BED, GFF/GTF, BAM (detected from extension)" << std::endl
+		<< "Accepted input file formats: BED, GFF/GTF (optionally gzipped), BAM, MTB (detected from extension)" << std::endl
 		<< "Output goes to stdout" << std::endl;
 	Polite::print_help(out);
 	return out;
@@ -68,6 +68,12 @@ unsigned int ParProbPipeline::detect_overlaps()
     // first calculate the actual overlaps without shuffling
     unsigned int acts = calc_actual_overlaps();
     
+    // the worker threads copy the ShuffleOvl objects, their sweep data need not be copied
+    for (auto& cs : csovl())
+    {
+        cs.second.release_workspace();
+    }
+    
     // optional ASCII progress bar to stderr
     boost::timer::progress_display *progress = nullptr;
     if (opt_ptr()->progress())
@@ -108,14 +114,14 @@ void ParProbPipeline::shuffle(
         {
             ShuffleOvl& sovl = cs.second;
             
-            // generate and store overlaps
+            // generate the overlaps and sum up their lengths
             if (opt_ptr()->uniregion())
             {
                 sovl.shuffle_unionoverlaps(rng,
                     opt_ptr()->ovlen(), 
                     opt_ptr()->minmult(), 
                     opt_ptr()->maxmult(),
-                    opt_ptr()->extension());
+                    opt_ptr()->extension(), rndcounter);
             }
             else
             {
@@ -124,9 +130,8 @@ void ParProbPipeline::shuffle(
                     opt_ptr()->minmult(), 
                     opt_ptr()->maxmult(),
                     opt_ptr()->extension(),
-                    !opt_ptr()->nointrack());
+                    !opt_ptr()->nointrack(), rndcounter);
             }
-            rndcounter.update(sovl.overlaps()); // update actual counts
         }
         
         // update the empirical distributions
@@ -121,7 +121,7 @@ std::ostream& ProbOpts::print_help(std::ostream& out) const
 	out << "Multiple Region Overlap Probabilities" << std::endl
 		<< "Usage: multovlprob [options] file1 [file2...]" << std::endl
         << "file1, file2, ... will be reshuffled, there must be at least one" << std::endl
-		<< "Accepted input file formats: BED, GFF/GTF, BAM (detected from extension)" << std::endl
+		<< "Accepted input file formats: BED, GFF/GTF (optionally gzipped), BAM, MTB (detected from extension)" << std::endl
 		<< "Output goes to stdout" << std::endl;
 	Polite::print_help(out);
 	return out;
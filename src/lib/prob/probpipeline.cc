@@ -47,6 +47,10 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <utility>
 #include <fstream>
+#include <memory>
+#include <set>
+#include <string_view>
+#include <vector>
 
 // == Implementation ==
 
@@ -113,13 +117,15 @@ unsigned int ProbPipeline::read_input()
 // \return the number of free regions successfully read (0 on error)
 unsigned int ProbPipeline::read_free_regions(const std::string& freefile)
 {
-    io::FileReader reader(freefile);    // automatic format detection
+    io::FileReader reader(freefile,     // automatic format detection
+        io::Fileformat::UNKNOWN, opt_ptr()->cachedir());
     if (!reader.errors().ok())
     {
         // make a note
         add_all_errors(reader.errors());
         return 0;
     }
+    reader.restrict_chroms(opt_ptr()->chroms());
     
     std::string chrom;
     BaseRegion reg; // temp input
@@ -187,11 +193,38 @@ unsigned int ProbPipeline::read_tracks(
 {
     unsigned int totalregcnt = 0;
     
-    for (const auto& inputfilenm : inputfiles)
+    // only the chromosomes with free regions are needed,
+    // the regions on the others are skipped by the readers
+    std::set<std::string> freechroms;
+    for (const auto& cs : csovl()) {
+        freechroms.insert(cs.first);
+    }
+    
+    // With several threads the track files are read concurrently into memory first,
+    // then they are processed one after the other as in the serial case
+    std::vector<io::LoadedTrack> loaded;
+    if (opt_ptr()->threads() > 1)
+        loaded = io::read_all_tracks(inputfiles, opt_ptr()->threads(), freechroms,
+            opt_ptr()->cachedir());
+    
+    for (std::size_t i = 0; i < inputfiles.size(); ++i)
     {
-        Input currinp(inputfilenm);
-        io::FileReader reader(currinp.name);    // automatic format detection
-        if (!reader.errors().ok())
+        Input currinp(inputfiles[i]);
+        io::LoadedTrack track;
+        if (loaded.empty())
+        {
+            track.reader = std::make_unique<io::FileReader>(currinp.name,    // automatic format detection
+                io::Fileformat::UNKNOWN, opt_ptr()->cachedir());
+            track.opened = track.reader->errors().ok();
+            if (track.opened)
+                track.reader->restrict_chroms(freechroms);
+        }
+        else
+        {
+            track = std::move(loaded[i]);
+        }
+        io::FileReader& reader = *track.reader;
+        if (!track.opened)
         {
             // make a note
             add_all_errors(reader.errors());
@@ -200,20 +233,9 @@ unsigned int ProbPipeline::read_tracks(
         }
         
         const std::string ERRPREFIX = "While parsing file " + currinp.name;
-        std::string chrom;
-        Region reg;
-        unsigned int regcnt = 0, problemcnt = 0;
-        while (true)
-        {
-            bool ok = reader.read_into(chrom, reg);
-            if (reader.finished())
-                break;
-            if (!ok)
-            {
-                ++problemcnt;
-                continue;
-            }
-            
+        unsigned int regcnt = 0, problemcnt = track.problemcnt;
+        auto add_region = [this, &ERRPREFIX, &regcnt, &problemcnt, trackid, shuffle](
+            const std::string& chrom, const Region& reg) {
             // /chrom/, /reg/ now contain a chromosome and a successfully parsed region
             // check if /reg/ fits into the free regions previously defined for /chrom/
             chrom_shufovl_map::iterator csit = csovl().find(chrom);
@@ -221,7 +243,7 @@ unsigned int ProbPipeline::read_tracks(
             {
                 add_warning(ERRPREFIX, "Chromosome '" + chrom + "' not in free regions");
                 ++problemcnt;
-                continue;
+                return;
             }
             if (! csit->second.fit_into_frees(reg))
             {
@@ -230,13 +252,40 @@ unsigned int ProbPipeline::read_tracks(
 							boost::lexical_cast<std::string>(reg.last()) +
 							"] not in free regions");
                 ++problemcnt;
-                continue;
+                return;
             }
             
             // OK, add the region to its chromosome's ShuffleOvl instance
             // note the shuffleability
             csit->second.add(reg, trackid + 1, shuffle);
             ++regcnt;
+        };
+        
+        std::string chrom;
+        if (loaded.empty())
+        {
+            Region reg;
+            while (true)
+            {
+                bool ok = reader.read_into(chrom, reg);
+                if (reader.finished())
+                    break;
+                if (!ok)
+                {
+                    ++problemcnt;
+                    continue;
+                }
+                add_region(chrom, reg);
+            }
+        }
+        else
+        {
+            // the buffered regions are processed in input order
+            track.regions.for_each([&chrom, &add_region](std::string_view chromview, const BaseRegion& reg) {
+                chrom.assign(chromview);
+                add_region(chrom, reg);
+            });
+            track.regions.clear();
         }
         if (problemcnt > 0)
         {
@@ -286,14 +335,14 @@ unsigned int ProbPipeline::detect_overlaps()
         {
             ShuffleOvl& sovl = csit.second;
             
-            // generate and store overlaps
+            // generate the overlaps and sum up their lengths
             if (opt_ptr()->uniregion())
             {
                 sovl.shuffle_unionoverlaps(rng,
                     opt_ptr()->ovlen(), 
                     opt_ptr()->minmult(), 
                     opt_ptr()->maxmult(),
-                    opt_ptr()->extension());
+                    opt_ptr()->extension(), rndcounter);
             }
             else
             {
@@ -302,9 +351,8 @@ unsigned int ProbPipeline::detect_overlaps()
                     opt_ptr()->minmult(), 
                     opt_ptr()->maxmult(),
                     opt_ptr()->extension(),
-                    !opt_ptr()->nointrack());
+                    !opt_ptr()->nointrack(), rndcounter);
             }
-            rndcounter.update(sovl.overlaps()); // update actual counts
         }
         
         // update the empirical distributions
@@ -320,6 +368,12 @@ unsigned int ProbPipeline::detect_overlaps()
         }
     }   // end of reshufflings
     
+    // the sweep data of the reshufflings are released in one step per chromosome
+    for (auto& csit : csovl())
+    {
+        csit.second.release_workspace();
+    }
+    
     if (opt_ptr()->progress())
     {
         delete progress;
@@ -339,14 +393,16 @@ unsigned int ProbPipeline::calc_actual_overlaps()
     for (auto& csit : csovl())
     {
         ShuffleOvl& sovl = csit.second;      // "current overlap"
+        sovl.engine(opt_ptr()->flatsweep()? 
+            MultiOverlap::FLATSWEEP: MultiOverlap::TREESWEEP);
         
-        // generate and store overlaps
+        // generate the overlaps and sum up their lengths
         if (opt_ptr()->uniregion())
         {
             acts += sovl.find_unionoverlaps(opt_ptr()->ovlen(), 
                 opt_ptr()->minmult(), 
                 opt_ptr()->maxmult(),
-                opt_ptr()->extension());
+                opt_ptr()->extension(), actcounter);
         }
         else
         {
@@ -354,9 +410,8 @@ unsigned int ProbPipeline::calc_actual_overlaps()
                 opt_ptr()->minmult(), 
                 opt_ptr()->maxmult(),
                 opt_ptr()->extension(),
-                !opt_ptr()->nointrack());
+                !opt_ptr()->nointrack(), actcounter);
         }
-        actcounter.update(sovl.overlaps()); // update actual counts
     }
     
     // add actual counts to statistics
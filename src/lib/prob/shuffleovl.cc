@@ -56,7 +56,12 @@ namespace prob {
 ShuffleOvl::ShuffleOvl(const freeregvec_t& frees):
     MultiOverlap(),
     _freeregions(frees),
-    _shuffleables(),
+    _shuffled(),
+    _shuffleidx(),
+    _fixedevents(),
+    _sweepevents(),
+    _fixedext(0),
+    _fixedready(false),
     _shufflecount(0)
 {}
 
@@ -64,120 +69,166 @@ unsigned int ShuffleOvl::shuffle_overlaps(UniformGen& rng,
         unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
         unsigned int ext, bool intrack)
 {
-    // Extend the region limits if required
-    Region::set_extension(ext);
-    
-    // shuffle the movable regions
-    shuffle(rng);
-    
-    // generate the overlaps
-    unsigned int regcount = generate_overlaps(ovlen, minmult, maxmult, intrack);
-    
-    // reset the extensions
-    Region::set_extension(0);
-    return regcount;
+    // shuffle the movable regions, extending the region limits if required,
+    // and store the overlaps
+    return shuffle_overlaps(rng, ovlen, minmult, maxmult, ext, intrack, overlap_sink());
 }
 
 unsigned int ShuffleOvl::shuffle_unionoverlaps(UniformGen& rng,
         unsigned int ovlen, unsigned int minmult, unsigned int maxmult,
         unsigned int ext)
 {
-    // Extend the region limits if required
-    Region::set_extension(ext);
-    
-    // shuffle the movable regions
-    shuffle(rng);
-    
-    // generate the union overlaps
-    unsigned int regcount = generate_unionoverlaps(ovlen, minmult, maxmult);
-        
-    // reset the extensions
-    Region::set_extension(0);
-    return regcount;
+    // shuffle the movable regions, extending the region limits if required,
+    // and store the union overlaps
+    return shuffle_unionoverlaps(rng, ovlen, minmult, maxmult, ext, overlap_sink());
 }
 
 #ifndef NDEBUG
 namespace debug {
     // ad-hoc debug functions
-    std::ostream& operator<<(std::ostream& ostr, const Region& reg) {
-        ostr << "*** " << reg.first() << "-" << reg.last() << ":" << reg.name();
+    std::ostream& operator<<(std::ostream& ostr, const RegRecord& rec) {
+        ostr << "*** " << rec.first() << "-" << rec.last() << ":" << rec.name_id();
         return ostr;
     }
     std::ostream& operator<<(std::ostream& ostr, const RegLimit& rl) {
         ostr << "*** this_pos()=" << rl.this_pos()
-            << " --> " << rl.region();
+            << " --> " << rl.index();
         return ostr;
     }
     // end of ad-hoc debug functions
 }
 #endif
 
+// Sets up the table of shuffled regions as a copy of the ancestor regions
+// and remembers where the shuffleable regions are.
+// Private
+void ShuffleOvl::setup_shuffled()
+{
+    _shuffled = std::make_shared<ancregionvec_t>(ancregions());
+    RegEvent::check_size(_shuffled->size());
+    _shuffleidx.clear();
+    for (unsigned int idx = 0; idx < _shuffled->size(); ++idx) {
+        if (_shuffled->record(idx).is_shuffleable()) {
+            _shuffleidx.push_back(idx);
+        }
+    }
+    _fixedevents.clear();
+    _fixedready = false;
+}
+
+// Caches the sorted events of the fixed (non-shuffleable) regions for the flat sweep engine.
+// \param ext the region limits are extended by this much
+// Private
+void ShuffleOvl::setup_fixedevents(unsigned int ext)
+{
+    _fixedevents.clear();
+    for (unsigned int idx = 0; idx < _shuffled->size(); ++idx) {
+        if (!_shuffled->record(idx).is_shuffleable()) {
+            add_events(_fixedevents, _shuffled->record(idx), idx, ext);
+        }
+    }
+    std::sort(_fixedevents.begin(), _fixedevents.end());
+    _fixedext = ext;
+    _fixedready = true;
+}
+
 // Shuffle the "shufflable" tracks
 // \param rng a uniform[0,1) random number generator
+// \param ext the region limits are extended by this much
 // \return the new shuffle count
 // Private
-unsigned int ShuffleOvl::shuffle(UniformGen& rng)
+unsigned int ShuffleOvl::shuffle(UniformGen& rng, unsigned int ext)
 {
 #ifndef NDEBUG
     using namespace debug;
     std::cerr << "** The contents of _ancregions upon entering shuffle:" << std::endl;
-    for (const auto& reg : ancregions()) {
-        std::cerr << reg << std::endl;
+    for (unsigned int i = 0; i < ancregions().size(); ++i) {
+        std::cerr << ancregions().record(i) << std::endl;
     }
 #endif
 
-    // cache the shuffleable regions
-    if (_shuffleables.size() == 0) {
-        for (const auto& ancreg : ancregions()) {
-            if (ancreg.is_shuffleable()) {
-                _shuffleables.push_back(ancreg);
-            }
-        }
+    // the previous overlaps refer to the shuffled region table, forget them
+    clear_overlaps();
+    
+    // set up the shuffled region table the first time we get here
+    // (or if regions have been added since)
+    if (!_shuffled || _shuffled->size() != ancregions().size()) {
+        setup_shuffled();
+    } else if (_shuffled.use_count() > 1) {
+        // shared with a copy of this object or with someone's old overlaps
+        _shuffled = std::make_shared<ancregionvec_t>(*_shuffled);
+    }
+    bool flat = (engine() == FLATSWEEP);
+    if (flat && (!_fixedready || _fixedext != ext)) {
+        setup_fixedevents(ext);
     }
 #ifndef NDEBUG
-    std::cerr << "** The contents of _shuffleables upon entering shuffle:" << std::endl;
-    for (const auto& reg : _shuffleables) {
-        std::cerr << reg << std::endl;
+    std::cerr << "** The contents of the shuffleable regions upon entering shuffle:" << std::endl;
+    for (auto idx : _shuffleidx) {
+        std::cerr << _shuffled->record(idx) << std::endl;
     }
 #endif
 
-    // remove all RegLimit-s referring to the regions in the reshufflable tracks
-    for (auto rlit = nonconst_reglims().begin(); rlit != nonconst_reglims().end(); ) {
-        if ( rlit->region().is_shuffleable() ) {
-            // RegLimit of reshufflable AncRegion, remove
-            rlit = nonconst_reglims().erase(rlit);
-        } else {
-            ++rlit;
+    if (flat) {
+        _sweepevents.clear();
+    } else {
+        // the fixed RegLimit-s must be extended the same way as the shuffled ones
+        if (reglims().empty() || reglim_extension() != ext) {
+            setup_reglims(ext);
+        }
+        // remove all RegLimit-s referring to the regions in the reshufflable tracks
+        for (auto rlit = nonconst_reglims().begin(); rlit != nonconst_reglims().end(); ) {
+            if ( rlit->is_shuffleable() ) {
+                // RegLimit of reshufflable AncRegion, remove
+                rlit = nonconst_reglims().erase(rlit);
+            } else {
+                ++rlit;
+            }
         }
     }
     
     // shuffle the reshufflable regions
-    // and add their changed limits to reglimits()
-    for (auto& sreg : _shuffleables) {
-        if (!place_randomly(rng, sreg))
+    // and add their changed limits to reglimits() or to the event array
+    for (auto idx : _shuffleidx) {
+        RegRecord& sreg = _shuffled->record(idx);
+        if (!place_randomly(rng, sreg, ext))
             continue;
-        add_reglimit(sreg);
+        if (flat)
+            add_events(_sweepevents, sreg, idx, ext);
+        else
+            add_reglimit(sreg, idx, ext);
+    }
+    
+    if (flat) {
+        // sort the shuffled events only, then merge them with the cached fixed events
+        auto mid = _sweepevents.size();
+        std::sort(_sweepevents.begin(), _sweepevents.end());
+        _sweepevents.insert(_sweepevents.end(), _fixedevents.begin(), _fixedevents.end());
+        std::inplace_merge(_sweepevents.begin(), _sweepevents.begin() + mid, _sweepevents.end());
     }
     
 #ifndef NDEBUG
-    std::cerr << "** Reglims contents after adding reshuffled limits:" << std::endl;
-    for (const auto& rl : reglims()) {
-        std::cerr << rl << std::endl;
+    if (!flat) {
+        std::cerr << "** Reglims contents after adding reshuffled limits:" << std::endl;
+        for (const auto& rl : reglims()) {
+            std::cerr << rl << std::endl;
+        }
     }
 #endif
 
     return ++_shufflecount;
 }
 
-// Shifts the coordinates of an AncestorRegion randomly so that it still fits
+// Shifts the coordinates of a region record randomly so that it still fits
 // into one of the randomly picked free regions.
 // \param rng Uniform random number generator
-// \param sreg An AncestorRegion. Its coordinates will be randomly shifted.
+// \param sreg A region record. Its coordinates will be randomly shifted.
+// \param ext The extended region must fit into the free region.
 // \return /true/ if the shift operation was successful, /false/ otherwise.
 // Private
-bool ShuffleOvl::place_randomly(UniformGen& rng, AncestorRegion& sreg) const {
+bool ShuffleOvl::place_randomly(UniformGen& rng, RegRecord& sreg, unsigned int ext) const {
     try {
-        unsigned int reglen = sreg.length();
+        unsigned int reglen = sreg.extended_length(ext);
         const auto& free = _freeregions.select_free_region(rng, reglen);
         unsigned int free1 = free.first(), freeN = free.last() - reglen;
         double rnd = rng();
@@ -187,7 +238,7 @@ bool ShuffleOvl::place_randomly(UniformGen& rng, AncestorRegion& sreg) const {
         std::cerr << "** free1=" << free1 << ", freeN=" << freeN
             << ", rnd=" << rnd << ", beg=" << newbeg << ", end=" << newend << std::endl;
 #endif
-        sreg.set_coords(newbeg, newend);
+        sreg.set_extended_coords(newbeg, newend, ext);
         return true;
     } catch(const std::length_error&) {
         return false;
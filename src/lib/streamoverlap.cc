@@ -0,0 +1,214 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == Module streamoverlap.cc ==
+
+// -- Own header --
+
+#include "multovl/streamoverlap.hh"
+
+// -- System headers --
+
+#include <algorithm>
+
+// == Implementation ==
+
+namespace multovl {
+
+namespace impl {
+    // Sweep kernel interface, so that the kernel can be chosen
+    // once for the whole stream
+    class AnySweep
+    {
+    public:
+        virtual ~AnySweep() = default;
+        virtual void first_limit(unsigned int pos, unsigned int idx) = 0;
+        virtual void last_limit(unsigned int pos, unsigned int idx) = 0;
+    };
+    
+    template <class Sweep>
+    class AnySweepImpl: public AnySweep
+    {
+    public:
+        AnySweepImpl(const Filter& filter, const ancregpool_t& regions, AppendSink sink):
+            _sweep(filter, regions, sink)
+        {}
+        void first_limit(unsigned int pos, unsigned int idx) override { _sweep.first_limit(pos, idx); }
+        void last_limit(unsigned int pos, unsigned int idx) override { _sweep.last_limit(pos, idx); }
+    private:
+        Sweep _sweep;
+    };
+}   // namespace impl
+
+StreamOverlap::StreamOverlap(unsigned int ovlen, unsigned int minmult, unsigned int maxmult, 
+        unsigned int ext, bool intrack, bool uniregion):
+    _ext(ext), _uniregion(uniregion),
+    _filter(uniregion?
+        new impl::Filter(ovlen, minmult, maxmult, false, true, ext):   // same as find_unionoverlaps
+        new impl::Filter(ovlen, minmult, maxmult, true, intrack, ext)), // same as find_overlaps
+    _sweep(),
+    _slots(std::make_shared<ancregvec_t>()), _pool(_slots),
+    _freeslots(), _closedslots(), _doneslots(), _ends(), _multiregions(),
+    _lastfirst(0), _maxdepth(0)
+{
+    reset();
+}
+
+StreamOverlap::~StreamOverlap() = default;
+
+bool StreamOverlap::add(const BaseRegion& reg, unsigned int trackid)
+{
+    // the caller has seen the overlaps of the previous call
+    _multiregions.clear();
+    recycle_slots();
+    if (reg.first() < _lastfirst)
+        return false;
+    _lastfirst = reg.first();
+    
+    // the regions ending before this one starts cannot overlap with anything that comes
+    Region anc(reg);
+    unsigned int pos = anc.extended_first(_ext);
+    close_until(pos);
+    if (_uniregion && _ends.empty()) {
+        // the union region is complete, the sweep has forgotten its ancestors
+        _doneslots.insert(_doneslots.end(), _closedslots.begin(), _closedslots.end());
+        _closedslots.clear();
+    }
+    
+    // store the new region in a free slot
+    unsigned int slot;
+    if (_freeslots.empty()) {
+        slot = _slots->size();
+        _slots->push_back(anc, trackid);
+    } else {
+        slot = _freeslots.back();
+        _freeslots.pop_back();
+        _slots->assign(slot, anc, trackid);
+    }
+    _ends.emplace(anc.extended_last(_ext), slot);
+    if (_ends.size() > _maxdepth)
+        _maxdepth = _ends.size();
+    
+    _sweep->first_limit(pos, slot);
+    return true;
+}
+
+void StreamOverlap::finish()
+{
+    _multiregions.clear();
+    recycle_slots();
+    while (!_ends.empty()) {
+        close_top();
+    }
+    reset();
+}
+
+// Sets up a fresh sweep when the pileup is empty.
+// The slots are kept, they will be recycled by the next add() call.
+// Private
+void StreamOverlap::reset()
+{
+    _lastfirst = 0;
+    using impl::AppendSink;
+    impl::AnySweep* sweep;
+    if (_uniregion)
+        sweep = new impl::AnySweepImpl<impl::UnionSweep<AppendSink>>(*_filter, _pool, 
+            AppendSink(_multiregions));
+    else if (_filter->solitary())
+        sweep = new impl::AnySweepImpl<impl::OverlapSweep<AppendSink, true, true>>(*_filter, _pool, 
+            AppendSink(_multiregions));
+    else if (_filter->intrack())
+        sweep = new impl::AnySweepImpl<impl::OverlapSweep<AppendSink, false, true>>(*_filter, _pool, 
+            AppendSink(_multiregions));
+    else
+        sweep = new impl::AnySweepImpl<impl::OverlapSweep<AppendSink, false, false>>(*_filter, _pool, 
+            AppendSink(_multiregions));
+    _sweep.reset(sweep);
+}
+
+// Closes the regions in the pileup that end before /pos/.
+// Private
+void StreamOverlap::close_until(unsigned int pos)
+{
+    while (!_ends.empty() && _ends.top().first < pos) {
+        close_top();
+    }
+}
+
+// Closes the region in the pileup that ends first.
+// This way the "last" limits are processed in ascending order, as in MultiOverlap.
+// Private
+void StreamOverlap::close_top()
+{
+    auto end = _ends.top();
+    _ends.pop();
+    _sweep->last_limit(end.first, end.second);
+    
+    // the overlaps found in this call may still refer to this slot
+    _closedslots.push_back(end.second);
+}
+
+// The slots of closed regions can be reused
+// if the sweep does not remember them any more
+// (the union sweep forgets its ancestors only when the pileup becomes empty,
+// add() moves their slots to _doneslots then).
+// The slot table itself is cleared whenever the pileup is empty.
+// Otherwise the names of the overwritten slots are dropped from the name pool
+// when they outnumber the slots, so that the pool does not keep the names
+// of all the regions seen so far.
+// Private
+void StreamOverlap::recycle_slots()
+{
+    // the name pool may hold this many names more than twice the slot count
+    const unsigned int NAMESLACK = 1024;
+    
+    if (_ends.empty()) {
+        // empty pileup: start over
+        _slots->clear();
+        _freeslots.clear();
+        _closedslots.clear();
+        _doneslots.clear();
+        return;
+    }
+    if (_slots->names().size() > 2 * _slots->size() + NAMESLACK)
+        _slots->compact_names();
+    if (!_uniregion) {
+        _doneslots.insert(_doneslots.end(), _closedslots.begin(), _closedslots.end());
+        _closedslots.clear();
+    }
+    _freeslots.insert(_freeslots.end(), _doneslots.begin(), _doneslots.end());
+    _doneslots.clear();
+}
+
+}   // namespace multovl
@@ -0,0 +1,168 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == Module strpool.cc ==
+
+// -- Own header --
+
+#include "multovl/strpool.hh"
+
+// -- System headers --
+
+#include <cstring>
+
+// == Implementation ==
+
+namespace multovl {
+
+StringPool::StringPool():
+    _blocks(), _longblocks(), _freepos(nullptr), _freelen(0),
+    _strs(), _ids(), _lastid(0),
+    _storage(), _extchars(nullptr), _extoffs(nullptr), _extcnt(0)
+{}
+
+StringPool::StringPool(const StringPool& other):
+    StringPool()
+{
+    unsigned int n = other.size();
+    _strs.reserve(n);
+    _ids.reserve(n);
+    for (unsigned int i = 0; i < n; ++i)
+        intern(other[i]);
+}
+
+StringPool::StringPool(std::shared_ptr<const void> storage, const char* chars, 
+        const std::uint64_t* offsets, unsigned int count):
+    StringPool()
+{
+    _storage = std::move(storage);
+    _extchars = chars;
+    _extoffs = offsets;
+    _extcnt = count;
+}
+
+StringPool& StringPool::operator=(const StringPool& other)
+{
+    if (this != &other) {
+        StringPool tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+unsigned int StringPool::intern(std::string_view str)
+{
+    if (_extoffs != nullptr)
+        index_external();
+    
+    // consecutive lookups of the same string are very common
+    if (_lastid < _strs.size() && _strs[_lastid] == str)
+        return _lastid;
+    
+    auto it = _ids.find(str);
+    if (it != _ids.end()) {
+        _lastid = it->second;
+        return _lastid;
+    }
+    
+    char* mem = allocate(str.size());
+    std::memcpy(mem, str.data(), str.size());
+    std::string_view stored(mem, str.size());
+    _lastid = _strs.size();
+    _strs.push_back(stored);
+    _ids.emplace(stored, _lastid);
+    return _lastid;
+}
+
+void StringPool::clear()
+{
+    _storage.reset();
+    _extchars = nullptr;
+    _extoffs = nullptr;
+    _extcnt = 0;
+    _ids.clear();
+    _strs.clear();
+    _lastid = 0;
+    
+    // keep the first block so that a pool which is cleared often
+    // does not allocate again
+    _longblocks.clear();
+    if (_blocks.empty()) {
+        _freepos = nullptr;
+        _freelen = 0;
+    } else {
+        _blocks.resize(1);
+        _freepos = _blocks.front().get();
+        _freelen = BLOCKSIZE;
+    }
+}
+
+// Makes the external strings lookupable so that new strings can be interned.
+// The views keep pointing to the external storage.
+// Private
+void StringPool::index_external()
+{
+    _strs.reserve(_extcnt);
+    _ids.reserve(_extcnt);
+    for (unsigned int i = 0; i < _extcnt; ++i) {
+        std::string_view stored = (*this)[i];
+        _strs.push_back(stored);
+        _ids.emplace(stored, i);
+    }
+    _extoffs = nullptr;
+    _extchars = nullptr;
+    _extcnt = 0;
+}
+
+// Returns room for /len/ characters in the arena.
+// Private
+char* StringPool::allocate(std::size_t len)
+{
+    if (len > _freelen) {
+        // long strings get a block of their own, the current block stays open
+        if (len > BLOCKSIZE / 4) {
+            _longblocks.emplace_back(new char[len]);
+            return _longblocks.back().get();
+        }
+        _blocks.emplace_back(new char[BLOCKSIZE]);
+        _freepos = _blocks.back().get();
+        _freelen = BLOCKSIZE;
+    }
+    char* mem = _freepos;
+    _freepos += len;
+    _freelen -= len;
+    return mem;
+}
+
+}   // namespace multovl
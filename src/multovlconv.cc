@@ -0,0 +1,107 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+// == PROGRAM multovlconv.cc ==
+
+/** \file multovlconv.cc
+ * \brief Program to convert track files to the binary MTB format.
+ *
+ * Tracks which are analysed many times can be converted once
+ * to the MTB format which can be read without parsing.
+ *
+ * \author agent
+ * \date 2026-10-17
+ */
+
+// -- Standard headers --
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// -- Own headers --
+
+#include "multovl/convopts.hh"
+#include "multovl/io/fileio.hh"
+#include "multovl/io/binio.hh"
+
+// == MAIN ==
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        multovl::ConvOpts opts;
+        opts.process_commandline(argc, argv);
+        
+        multovl::io::FileReader reader(opts.input());
+        if (!reader.errors().ok())
+        {
+            reader.errors().print(std::cerr);
+            std::exit(EXIT_FAILURE);
+        }
+        multovl::io::TrackBuffer track;
+        unsigned int problemcnt = reader.read_all(track, opts.threads());
+        if (problemcnt > 0 || !reader.errors().ok())
+        {
+            reader.errors().print(std::cerr);
+            std::cerr << "! " << problemcnt << "x problem reading from file " 
+                << opts.input() << ", skipped" << std::endl;
+        }
+        
+        multovl::io::BinaryWriter writer;
+        track.for_each([&writer](std::string_view chrom, const multovl::BaseRegion& reg) {
+            writer.add(chrom, reg);
+        });
+        track.clear();
+        if (!writer.write(opts.output()))
+        {
+            std::cerr << "! Cannot write output file " << opts.output() << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        std::exit(EXIT_SUCCESS);
+    }
+    catch (const std::exception& exc)
+    {
+        std::cerr << "! " << exc.what() << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    catch (...)
+    {
+        std::cerr << "! Unexpected exception caught, exiting" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+// == END OF PROGRAM multovlconv.cc ==
@@ -0,0 +1,158 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE anctabletest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/anctable.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Boost headers --
+
+#include "boost/archive/text_iarchive.hpp"
+#include "boost/archive/text_oarchive.hpp"
+
+// -- Standard headers --
+
+#include <fstream>
+
+struct AncTableFixture
+{
+    AncTableFixture():
+        a1(Region(1, 5, '+', "a15")),   // track id = 0
+        a2(4, 6, '-', "a46", 9, false), // non-default track ID and shuffleability
+        a3(1, 3, '+', "a13")
+    {
+        table.push_back(a1);
+        table.push_back(a2);
+        table.push_back(a3);
+    }
+    
+    AncestorRegion a1, a2, a3;
+    AncestorTable table;
+};
+
+BOOST_FIXTURE_TEST_SUITE(anctablesuite, AncTableFixture)
+
+BOOST_AUTO_TEST_CASE(record_test)
+{
+    BOOST_CHECK_EQUAL(sizeof(RegRecord), 16);
+    
+    const RegRecord& rec = table.record(1);
+    BOOST_CHECK_EQUAL(rec.first(), 4);
+    BOOST_CHECK_EQUAL(rec.last(), 6);
+    BOOST_CHECK_EQUAL(rec.length(), 3);
+    BOOST_CHECK_EQUAL(rec.strand(), '-');
+    BOOST_CHECK_EQUAL(rec.track_id(), 9);
+    BOOST_CHECK(!rec.is_shuffleable());
+    BOOST_CHECK(table.record(0).is_shuffleable());
+    BOOST_CHECK_EQUAL(table.name(1), "a46");
+}
+
+BOOST_AUTO_TEST_CASE(roundtrip_test)
+{
+    BOOST_CHECK_EQUAL(table.size(), 3);
+    BOOST_CHECK(table[0] == a1);
+    BOOST_CHECK(table[1] == a2);
+    BOOST_CHECK_EQUAL(table[1].is_shuffleable(), a2.is_shuffleable());
+    BOOST_CHECK_EQUAL(table.to_attrstring(1), a2.to_attrstring());
+    
+    table.assign(0, Region(7, 8, '.', "longer_name"), 3);
+    BOOST_CHECK_EQUAL(table.to_attrstring(0), "3:longer_name:.:7-8");
+}
+
+BOOST_AUTO_TEST_CASE(names_test)
+{
+    // repeated names are stored once
+    table.push_back(a2);
+    BOOST_CHECK_EQUAL(table.record(3).name_id(), table.record(1).name_id());
+    
+    // a copy is independent of the original
+    AncestorTable copy(table);
+    copy.assign(1, Region(2, 3, '+', "new"), 1);
+    BOOST_CHECK_EQUAL(copy.to_attrstring(1), "1:new:+:2-3");
+    BOOST_CHECK_EQUAL(table.to_attrstring(1), "9:a46:-:4-6");
+    BOOST_CHECK_EQUAL(copy.to_attrstring(3), "9:a46:-:4-6");
+}
+
+BOOST_AUTO_TEST_CASE(compact_names_test)
+{
+    for (unsigned int i = 0; i < 100; ++i) {
+        table.assign(1, Region(2, 3, '+', "name" + std::to_string(i)), 1);
+    }
+    BOOST_CHECK(table.names().size() > 100);
+    table.compact_names();
+    BOOST_CHECK_EQUAL(table.names().size(), 3);
+    BOOST_CHECK_EQUAL(table.to_attrstring(1), "1:name99:+:2-3");
+    BOOST_CHECK_EQUAL(table.to_attrstring(0), "0:a15:+:1-5");
+    BOOST_CHECK_EQUAL(table.to_attrstring(2), "0:a13:+:1-3");
+}
+
+BOOST_AUTO_TEST_CASE(compare_test)
+{
+    // the table comparisons must agree with those of AncestorRegion
+    const AncestorRegion ancs[] = { a1, a2, a3 };
+    for (unsigned int i = 0; i < 3; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            BOOST_CHECK_EQUAL(table.less(i, j), ancs[i] < ancs[j]);
+            BOOST_CHECK_EQUAL(table.equal(i, j), ancs[i] == ancs[j]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(anctableser_test)
+{
+    Tempfile tempfile;
+    {
+        std::ofstream ofs(tempfile.name());
+        boost::archive::text_oarchive oa(ofs);
+        oa << table;
+    }
+    
+    {
+        std::ifstream ifs(tempfile.name());
+        boost::archive::text_iarchive ia(ifs);
+        AncestorTable intable;
+        ia >> intable;
+        BOOST_CHECK_EQUAL(intable.size(), 3);
+        BOOST_CHECK_EQUAL(intable.to_attrstring(0), "0:a15:+:1-5");
+        BOOST_CHECK_EQUAL(intable.to_attrstring(1), "9:a46:-:4-6");
+        BOOST_CHECK(!intable.record(1).is_shuffleable());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,213 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE biniotest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/binio.hh"
+#include "multovl/io/fileio.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Standard headers --
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// converts the contents of /track/ to strings, one per region
+static std::vector<std::string> track_tostr(const io::TrackBuffer& track)
+{
+    std::vector<std::string> strs;
+    track.for_each([&strs](std::string_view chrom, const BaseRegion& reg) {
+        std::ostringstream oss;
+        oss << chrom << ':' << reg.first() << '-' << reg.last() << reg.strand() << reg.name();
+        strs.push_back(oss.str());
+    });
+    return strs;
+}
+
+struct BinioFixture
+{
+    BinioFixture(): track(), tempfile(), fname(std::filesystem::path(tempfile.name()).string())
+    {
+        // unsorted, repeated names, all strands, a zero-length region
+        track.add("chr1", BaseRegion(1000, 2000, '+', "a"));
+        track.add("chr2", BaseRegion(30, 40, '-', ""));
+        track.add("chr1", BaseRegion(5, 8, '.', "a"));
+        track.add("chr1", BaseRegion(4000000000u, 4000000000u, '-', "far"));
+        track.add("chrX", BaseRegion(0, 1, '+', "b"));
+        track.add("chr2", BaseRegion(10, 11, '+', "b"));
+    }
+    
+    // writes /track/ to /fname/
+    void write_track()
+    {
+        io::BinaryWriter writer;
+        track.for_each([&writer](std::string_view chrom, const BaseRegion& reg) {
+            writer.add(chrom, reg);
+        });
+        BOOST_CHECK_EQUAL(writer.size(), track.size());
+        BOOST_REQUIRE(writer.write(fname));
+    }
+    
+    io::TrackBuffer track;
+    Tempfile tempfile;
+    std::string fname;
+    
+    // the regions of /track/ grouped by chromosome in the order of first appearance
+    const std::vector<std::string> exp{
+        "chr1:1000-2000+a", "chr1:5-8.a", "chr1:4000000000-4000000000-far",
+        "chr2:30-40-", "chr2:10-11+b", "chrX:0-1+b"
+    };
+};
+
+BOOST_FIXTURE_TEST_SUITE(biniosuite, BinioFixture)
+
+BOOST_AUTO_TEST_CASE(roundtrip_test)
+{
+    write_track();
+    
+    io::FileReader reader(fname, io::Fileformat::MTB);
+    BOOST_REQUIRE(reader.errors().ok());
+    io::TrackBuffer readback;
+    std::string chrom;
+    BaseRegion reg;
+    while (reader.read_into(chrom, reg) && !reader.finished())
+        readback.add(chrom, reg);
+    BOOST_CHECK(reader.errors().ok());
+    std::vector<std::string> strs = track_tostr(readback);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+}
+
+BOOST_AUTO_TEST_CASE(readall_test)
+{
+    write_track();
+    for (unsigned int threads : {1, 3})
+    {
+        io::FileReader reader(fname, io::Fileformat::MTB);
+        io::TrackBuffer readback;
+        BOOST_CHECK_EQUAL(reader.read_all(readback, threads), 0);
+        BOOST_CHECK(reader.errors().ok());
+        std::vector<std::string> strs = track_tostr(readback);
+        BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+    }
+    
+    // read_all() after read_into() continues where it stopped
+    io::FileReader reader(fname, io::Fileformat::MTB);
+    io::TrackBuffer readback;
+    std::string chrom;
+    BaseRegion reg;
+    reader.read_into(chrom, reg);
+    readback.add(chrom, reg);
+    reader.read_all(readback, 2);
+    std::vector<std::string> strs = track_tostr(readback);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+}
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+    io::BinaryWriter writer;
+    BOOST_REQUIRE(writer.write(fname));
+    io::FileReader reader(fname, io::Fileformat::MTB);
+    BOOST_REQUIRE(reader.errors().ok());
+    io::TrackBuffer readback;
+    BOOST_CHECK_EQUAL(reader.read_all(readback, 2), 0);
+    BOOST_CHECK(readback.empty());
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_test)
+{
+    write_track();
+    std::string contents;
+    {
+        std::ifstream inf(fname, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(inf), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [this](const std::string& data) {
+        std::ofstream outf(fname, std::ios::binary);
+        outf << data;
+    };
+    
+    // not a binary track file at all
+    rewrite("chr1\t10\t20\n");
+    {
+        io::FileReader reader(fname, io::Fileformat::MTB);
+        BOOST_CHECK(!reader.errors().ok());
+    }
+    
+    // truncated
+    rewrite(contents.substr(0, contents.size() - 3));
+    {
+        io::FileReader reader(fname, io::Fileformat::MTB);
+        BOOST_CHECK(!reader.errors().ok());
+    }
+    
+    // the varints in the starts column of chr1 (the first block after
+    // the header and 3 index entries, 9 bytes) run into the lengths column
+    std::string bad = contents;
+    const std::size_t blockstart = 48 + 3 * 56;
+    for (std::size_t i = blockstart; i < blockstart + 9; ++i)
+        bad[i] = static_cast<char>(0xFF);
+    rewrite(bad);
+    for (unsigned int threads : {0, 2})
+    {
+        io::FileReader reader(fname, io::Fileformat::MTB);
+        BOOST_REQUIRE(reader.errors().ok());
+        io::TrackBuffer readback;
+        if (threads == 0)
+        {
+            std::string chrom;
+            BaseRegion reg;
+            while (!reader.finished())
+            {
+                if (reader.read_into(chrom, reg) && !reader.finished())
+                    readback.add(chrom, reg);
+            }
+        }
+        else
+        {
+            BOOST_CHECK_EQUAL(reader.read_all(readback, threads), 1);
+        }
+        BOOST_CHECK(!reader.errors().ok());
+        BOOST_CHECK(readback.empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE charscantest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/charscan.hh"
+using namespace multovl::io;
+
+// -- Standard headers --
+
+#include <random>
+#include <string>
+#include <vector>
+
+// The reference implementations
+namespace {
+
+std::size_t ref_find(const std::string& str, std::size_t from, std::size_t to, char c)
+{
+    for (std::size_t i = from; i < to; ++i)
+        if (str[i] == c) return i;
+    return to;
+}
+
+std::vector<std::uint32_t> ref_find_all(const std::string& str, std::size_t from, std::size_t to, char c)
+{
+    std::vector<std::uint32_t> offs;
+    for (std::size_t i = from; i < to; ++i)
+        if (str[i] == c) offs.push_back(i - from);
+    return offs;
+}
+
+std::size_t ref_skip_blanks(const std::string& str, std::size_t from, std::size_t to)
+{
+    while (from < to && (str[from] == ' ' || str[from] == '\t' || str[from] == '\n'))
+        ++from;
+    return from;
+}
+
+}   // end of unnamed namespace
+
+struct CharscanFixture
+{
+    CharscanFixture():
+        text(), origkernel(Charscan::kernel())
+    {
+        // BED-like text with some long blank runs
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> chardistr(0, 19), lendistr(0, 70);
+        const char chars[] = "chr12345\t\t\n  #+-.ab";
+        for (unsigned int i = 0; i < 200; ++i) {
+            text.append(lendistr(rng), ' ');
+            for (int j = lendistr(rng); j > 0; --j)
+                text += chars[chardistr(rng)];
+        }
+    }
+    
+    ~CharscanFixture() { Charscan::select(origkernel); }
+    
+    std::string text;
+    Charscan::Kernel origkernel;
+};
+
+BOOST_FIXTURE_TEST_SUITE(charscansuite, CharscanFixture)
+
+BOOST_AUTO_TEST_CASE(kernel_test)
+{
+    BOOST_CHECK(Charscan::supported(Charscan::SCALAR));
+    BOOST_CHECK(Charscan::supported(Charscan::kernel()));
+    BOOST_TEST_MESSAGE("Default kernel: " << Charscan::to_string(Charscan::kernel()));
+}
+
+// all kernels must agree with the reference implementations
+// for all kinds of lengths and alignments
+BOOST_AUTO_TEST_CASE(scan_test)
+{
+    const char* data = text.data();
+    for (auto kind : {Charscan::SCALAR, Charscan::SSE2, Charscan::AVX2}) {
+        if (!Charscan::select(kind))
+            continue;
+        BOOST_TEST_MESSAGE("Testing kernel " << Charscan::to_string(kind));
+        for (std::size_t from = 0; from < 70; from += 3) {
+            for (std::size_t to = from; to < text.size(); to += 1 + to / 4) {
+                for (char c : {'\t', '\n', '#'}) {
+                    BOOST_CHECK_EQUAL(Charscan::find(data + from, data + to, c) - data, 
+                        ref_find(text, from, to, c));
+                    
+                    std::vector<std::uint32_t> expoffs = ref_find_all(text, from, to, c);
+                    std::uint32_t offs[5];
+                    std::size_t cnt = Charscan::find_all(data + from, data + to, c, offs, 5);
+                    BOOST_CHECK_EQUAL(cnt, expoffs.size());
+                    for (std::size_t i = 0; i < cnt && i < 5; ++i)
+                        BOOST_CHECK_EQUAL(offs[i], expoffs[i]);
+                }
+                BOOST_CHECK_EQUAL(Charscan::skip_blanks(data + from, data + to) - data,
+                    ref_skip_blanks(text, from, to));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -58,6 +58,25 @@ BOOST_AUTO_TEST_CASE(fromfile_test)
     BOOST_CHECK(f == Fileformat::BAM);
     BOOST_CHECK_EQUAL(Fileformat::to_string(f), "BAM");
     
+    f = Fileformat::from_filename("file.mtb");
+    BOOST_CHECK(f == Fileformat::MTB);
+    BOOST_CHECK_EQUAL(Fileformat::to_string(f), "MTB");
+    
+    f = Fileformat::from_filename("file.bed.gz");
+    BOOST_CHECK(f == Fileformat::BED);
+    
+    f = Fileformat::from_filename("file.GTF.GZ");
+    BOOST_CHECK(f == Fileformat::GFF);
+    
+    f = Fileformat::from_filename("file.bam.gz");
+    BOOST_CHECK(f == Fileformat::UNKNOWN);
+    
+    f = Fileformat::from_filename("file.mtb.gz");
+    BOOST_CHECK(f == Fileformat::UNKNOWN);
+    
+    f = Fileformat::from_filename("file.gz");
+    BOOST_CHECK(f == Fileformat::UNKNOWN);
+    
     f = Fileformat::from_filename("file.blabla");
     BOOST_CHECK(f == Fileformat::UNKNOWN);
     BOOST_CHECK_EQUAL(Fileformat::to_string(f), "UNKNOWN");
@@ -65,7 +84,7 @@ BOOST_AUTO_TEST_CASE(fromfile_test)
 
 BOOST_AUTO_TEST_CASE(knownextension_test)
 {
-    std::string knownext(".bed, .gff, .gtf, .bam");
+    std::string knownext(".bed, .gff, .gtf, .bam, .mtb, .bed.gz, .gff.gz, .gtf.gz");
     BOOST_CHECK_EQUAL(Fileformat::known_extensions(), knownext);
 }
 
@@ -52,6 +52,7 @@ using namespace multovl;
 
 // -- standard headers --
 
+#include <set>
 #include <vector>
 #include <string>
 #include <filesystem>
@@ -191,6 +192,18 @@ BOOST_AUTO_TEST_CASE(fromtextfile_test)
     test_goodfile("rega12.bed"); // hard-coded input file name!
 }
 
+BOOST_AUTO_TEST_CASE(fromgzipfile_test)
+{
+    BOOST_TEST_MESSAGE("Running gzipped BED file input test");
+    test_goodfile("rega12.bed.gz"); // same contents as rega12.bed
+}
+
+BOOST_AUTO_TEST_CASE(frombgzffile_test)
+{
+    BOOST_TEST_MESSAGE("Running BGZF-compressed BED file input test");
+    test_goodfile("rega12bgzf.bed.gz"); // same contents as rega12.bed, in 100-byte blocks
+}
+
 BOOST_AUTO_TEST_CASE(frombamfile_test)
 {
     BOOST_TEST_MESSAGE("Running BAM file input test");  // these are expected to be OK
@@ -254,4 +267,125 @@ BOOST_AUTO_TEST_CASE(badformat_test)
     );
 }
 
+BOOST_AUTO_TEST_CASE(readalltracks_test)
+{
+    BOOST_TEST_MESSAGE("Running concurrent track reading test");
+    std::vector<std::string> infnames{
+        locate_testfile("rega12.bed"), "unknown_format.xyz", locate_testfile("bad.bed")
+    };
+    std::vector<io::LoadedTrack> tracks = io::read_all_tracks(infnames, 3);
+    BOOST_REQUIRE_EQUAL(tracks.size(), 3);
+    
+    // the good file, regions in input order
+    BOOST_CHECK(tracks[0].opened);
+    BOOST_CHECK_EQUAL(tracks[0].problemcnt, 0);
+    std::vector<std::string> regs;
+    tracks[0].regions.for_each([this, &regs](std::string_view chrom, const BaseRegion& reg) {
+        regs.push_back(std::string(chrom) + ":" + reg_tostr(reg));
+    });
+    BOOST_REQUIRE_EQUAL(regs.size(), exps.size());
+    for (unsigned int i = 0; i < exps.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(regs[i], (i < 5? "chr1:": "chr2:") + reg_tostr(exps[i]));
+    }
+    
+    // could not be opened
+    BOOST_CHECK(!tracks[1].opened);
+    BOOST_CHECK(tracks[1].regions.empty());
+    BOOST_CHECK(!tracks[1].reader->errors().ok());
+    
+    // the bad lines are reported as with read_into()
+    BOOST_CHECK(tracks[2].opened);
+    BOOST_CHECK_EQUAL(tracks[2].problemcnt, 4);
+    BOOST_CHECK_EQUAL(tracks[2].regions.size(), 1);
+    BOOST_CHECK_EQUAL(tracks[2].reader->errors().last_error(), "ERROR: At line 5: Too few fields: 2");
+    BOOST_CHECK(tracks[2].reader->finished());
+}
+
+BOOST_AUTO_TEST_CASE(bamreadall_test)
+{
+    BOOST_TEST_MESSAGE("Running BAM file read-ahead test");
+    change_region_names("bam");
+    std::string inputname = locate_testfile("rega12.bam");
+    for (unsigned int threads : {1, 4})
+    {
+        io::FileReader fr(inputname);
+        BOOST_REQUIRE(fr.errors().ok());
+        io::TrackBuffer track;
+        BOOST_CHECK_EQUAL(fr.read_all(track, threads), 0);
+        BOOST_CHECK(fr.errors().ok());
+        BOOST_CHECK(fr.finished());
+        std::vector<std::string> regs;
+        track.for_each([this, &regs](std::string_view chrom, const BaseRegion& reg) {
+            regs.push_back(std::string(chrom) + ":" + reg_tostr(reg));
+        });
+        BOOST_REQUIRE_EQUAL(regs.size(), exps.size());
+        for (unsigned int i = 0; i < exps.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(regs[i], (i < 5? "chr1:": "chr2:") + reg_tostr(exps[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(restrictchroms_test)
+{
+    BOOST_TEST_MESSAGE("Running chromosome restriction test");
+    const std::set<std::string> chr2{"chr2"};
+    
+    // rega12.bed is filtered while reading, rega12.bam has an index
+    for (std::string filename : {"rega12.bed", "rega12.bam"})
+    {
+        if (filename == "rega12.bam")
+            change_region_names("bam");
+        for (unsigned int threads : {0, 1, 4})
+        {
+            io::FileReader fr(locate_testfile(filename));
+            fr.restrict_chroms(chr2);
+            std::vector<std::string> regs;
+            std::string chrom;
+            BaseRegion reg;
+            if (threads == 0)
+            {
+                while (fr.read_into(chrom, reg) && !fr.finished())
+                    regs.push_back(chrom + ":" + reg_tostr(reg));
+            }
+            else
+            {
+                io::TrackBuffer track;
+                BOOST_CHECK_EQUAL(fr.read_all(track, threads), 0);
+                track.for_each([this, &regs](std::string_view chrom, const BaseRegion& reg) {
+                    regs.push_back(std::string(chrom) + ":" + reg_tostr(reg));
+                });
+            }
+            BOOST_CHECK(fr.errors().ok());
+            BOOST_CHECK(fr.finished());
+            BOOST_REQUIRE_EQUAL(regs.size(), 5);
+            for (unsigned int i = 0; i < 5; ++i)
+            {
+                BOOST_CHECK_EQUAL(regs[i], "chr2:" + reg_tostr(exps[i + 5]));
+            }
+        }
+    }
+    
+    // regb12.bam has no index, its alignments are filtered while decoding
+    std::vector<std::string> all, restricted;
+    for (bool restrict : {false, true})
+    {
+        io::FileReader fr(locate_testfile("regb12.bam"));
+        if (restrict)
+            fr.restrict_chroms(chr2);
+        io::TrackBuffer track;
+        fr.read_all(track, 2);
+        track.for_each([this, restrict, &all, &restricted](std::string_view chrom, const BaseRegion& reg) {
+            std::string r = std::string(chrom) + ":" + reg_tostr(reg);
+            if (!restrict && chrom == "chr2")
+                all.push_back(r);
+            else if (restrict)
+                restricted.push_back(r);
+        });
+    }
+    BOOST_CHECK(!all.empty());
+    BOOST_CHECK(all == restricted);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,236 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE inflatertest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/inflater.hh"
+#include "multovl/io/readahead.hh"
+using namespace multovl::io;
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <string>
+
+// -- Zlib header --
+
+#include "zlib.h"
+
+// -- Helpers --
+
+// Compresses /data/ to a single gzip member
+static std::string gzip(const std::string& data)
+{
+    z_stream zs{};
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&zs, data.size()) + 32, '\0');
+    zs.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(data.data()));
+    zs.avail_in = data.size();
+    zs.next_out = reinterpret_cast<unsigned char*>(&out[0]);
+    zs.avail_out = out.size();
+    deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return out;
+}
+
+static void put_le(std::string& out, std::uint32_t value, unsigned int bytes)
+{
+    for (unsigned int i = 0; i < bytes; ++i, value >>= 8)
+        out += static_cast<char>(value & 0xFF);
+}
+
+// Compresses /data/ to BGZF blocks holding /blocksize/ bytes each, plus the EOF block
+static std::string bgzf(const std::string& data, std::size_t blocksize)
+{
+    std::string out;
+    for (std::size_t pos = 0; pos <= data.size(); pos += blocksize)
+    {
+        // the last round writes the empty EOF block
+        std::string chunk = (pos < data.size())? data.substr(pos, blocksize): "";
+        z_stream zs{};
+        deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        std::string comp(deflateBound(&zs, chunk.size()), '\0');
+        zs.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(chunk.data()));
+        zs.avail_in = chunk.size();
+        zs.next_out = reinterpret_cast<unsigned char*>(&comp[0]);
+        zs.avail_out = comp.size();
+        deflate(&zs, Z_FINISH);
+        comp.resize(zs.total_out);
+        deflateEnd(&zs);
+        
+        out += std::string("\x1f\x8b\x08\x04\0\0\0\0\0\xff\x06\0BC\x02\0", 16);
+        put_le(out, 18 + comp.size() + 8 - 1, 2);
+        out += comp;
+        put_le(out, crc32(0, reinterpret_cast<const unsigned char*>(chunk.data()), chunk.size()), 4);
+        put_le(out, chunk.size(), 4);
+        if (pos == data.size())
+            break;
+        if (pos + blocksize > data.size())
+            pos = data.size() - blocksize;  // the next round writes the EOF block
+    }
+    return out;
+}
+
+// Decompresses all of /comp/ in parts of /size/ bytes
+static std::string inflate_all(Inflater& inflater, std::size_t size, unsigned int threads)
+{
+    std::string out;
+    while (inflater.inflate(out, size, threads) > 0)
+        ;
+    return out;
+}
+
+struct InflaterFixture
+{
+    InflaterFixture(): text()
+    {
+        for (unsigned int i = 0; i < 20000; ++i)
+        {
+            text += "chr" + std::to_string(i % 7 + 1) + '\t' + std::to_string(i * 10) + '\t' 
+                + std::to_string(i * 10 + 5) + "\tname" + std::to_string(i) + '\n';
+        }
+    }
+    
+    std::string text;
+};
+
+BOOST_FIXTURE_TEST_SUITE(inflatersuite, InflaterFixture)
+
+BOOST_AUTO_TEST_CASE(isgzip_test)
+{
+    std::string comp = gzip(text);
+    BOOST_CHECK(Inflater::is_gzip(comp.data(), comp.data() + comp.size()));
+    BOOST_CHECK(!Inflater::is_gzip(text.data(), text.data() + text.size()));
+    BOOST_CHECK(!Inflater::is_gzip(comp.data(), comp.data() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(stream_test)
+{
+    // two gzip members, as produced by e.g. "cat a.gz b.gz"
+    std::string comp = gzip(text) + gzip(text);
+    Inflater inflater(comp.data(), comp.data() + comp.size());
+    BOOST_CHECK(!inflater.is_bgzf());
+    BOOST_CHECK_EQUAL(inflate_all(inflater, 1000, 1), text + text);
+    BOOST_CHECK(inflater.finished());
+    BOOST_CHECK_EQUAL(inflater.error(), "");
+}
+
+BOOST_AUTO_TEST_CASE(bgzf_test)
+{
+    std::string comp = bgzf(text, 5000);
+    for (unsigned int threads : {1, 4})
+    {
+        Inflater inflater(comp.data(), comp.data() + comp.size());
+        BOOST_CHECK(inflater.is_bgzf());
+        BOOST_CHECK(inflate_all(inflater, 12345, threads) == text);
+        BOOST_CHECK(inflater.finished());
+        BOOST_CHECK_EQUAL(inflater.error(), "");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+    std::string comp = bgzf("", 100);
+    Inflater inflater(comp.data(), comp.data() + comp.size());
+    std::string out;
+    BOOST_CHECK_EQUAL(inflater.inflate(out, 100), 0);
+    BOOST_CHECK(inflater.finished());
+    BOOST_CHECK_EQUAL(inflater.error(), "");
+}
+
+BOOST_AUTO_TEST_CASE(truncated_test)
+{
+    std::string comp = gzip(text);
+    comp.resize(comp.size() / 2);
+    Inflater inflater(comp.data(), comp.data() + comp.size());
+    std::string out = inflate_all(inflater, 1 << 20, 1);
+    BOOST_CHECK(inflater.finished());
+    BOOST_CHECK_EQUAL(inflater.error(), "Truncated gzip input");
+    BOOST_CHECK(out.size() < text.size());
+    BOOST_CHECK_EQUAL(out, text.substr(0, out.size()));
+    
+    comp = bgzf(text, 5000);
+    comp.resize(comp.size() - 40);
+    Inflater bgzfinflater(comp.data(), comp.data() + comp.size());
+    inflate_all(bgzfinflater, 1 << 20, 2);
+    BOOST_CHECK_EQUAL(bgzfinflater.error(), "Invalid BGZF block");
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_test)
+{
+    std::string comp = bgzf(text, 5000);
+    comp[comp.size() / 2] ^= 0x55;
+    Inflater inflater(comp.data(), comp.data() + comp.size());
+    inflate_all(inflater, 1 << 20, 2);
+    BOOST_CHECK(inflater.finished());
+    BOOST_CHECK_EQUAL(inflater.error(), "Corrupt BGZF block");
+}
+
+BOOST_AUTO_TEST_CASE(readahead_test)
+{
+    std::string comp = bgzf(text, 5000);
+    for (unsigned int threads : {1, 4})
+    {
+        // small parts and an odd read size so that the reads straddle parts
+        Readahead input(comp.data(), comp.data() + comp.size(), threads, 7000, 2);
+        std::string out;
+        char buf[999];
+        std::size_t len;
+        while ((len = input.read(buf, sizeof(buf))) > 0)
+            out.append(buf, len);
+        BOOST_CHECK(out == text);
+        BOOST_CHECK_EQUAL(input.error(), "");
+    }
+    
+    // stopping early must not block
+    {
+        Readahead input(comp.data(), comp.data() + comp.size(), 2, 1000, 2);
+        char buf[10];
+        BOOST_CHECK_EQUAL(input.read(buf, sizeof(buf)), sizeof(buf));
+    }
+    
+    comp[comp.size() / 2] ^= 0x55;
+    Readahead input(comp.data(), comp.data() + comp.size(), 2, 1000, 3);
+    std::string out(text.size(), '\0');
+    std::size_t len = input.read(&out[0], out.size());
+    BOOST_CHECK(len < text.size());
+    BOOST_CHECK(out.compare(0, len, text, 0, len) == 0);
+    BOOST_CHECK_EQUAL(input.error(), "Corrupt BGZF block");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
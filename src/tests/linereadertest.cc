@@ -101,6 +101,34 @@ BOOST_AUTO_TEST_CASE(bedreader_test)
     BOOST_CHECK_EQUAL(blr.error_msg(), "\"-99\": must not be negative");
 }
 
+BOOST_AUTO_TEST_CASE(bedfields_test)
+{
+    BaseRegion reg;
+    
+    // trailing control chars are ignored, so is whitespace around numbers
+    status = blr.parse("chr1\t 10 \t20\tregion\t0.8\t+\r");
+    BOOST_CHECK(status == io::Linereader::DATA);
+    BOOST_CHECK(blr.read_into(reg));
+    BOOST_CHECK(region == reg);
+    
+    // all fields are counted, even if only the first 6 are used
+    std::string line("chr1\t10\t20\tregion\t0.8\t+\t10\t20\t0\t1\t10\t0");
+    status = blr.parse(std::string_view(line));
+    BOOST_CHECK(status == io::Linereader::DATA);
+    BOOST_CHECK_EQUAL(blr.fieldcnt(), 12);
+    BOOST_CHECK_EQUAL(blr.name(), "region");
+    
+    status = blr.parse("chr1\t10\t99999999999");
+    BOOST_CHECK(status == (io::Linereader::ERROR | io::Linereader::DATA));
+    BOOST_CHECK_EQUAL(blr.error_msg(), "\"99999999999\": cannot parse to unsigned int");
+    status = blr.parse("chr1\t\t20");
+    BOOST_CHECK(status == (io::Linereader::ERROR | io::Linereader::DATA));
+    BOOST_CHECK_EQUAL(blr.error_msg(), "\"\": cannot parse to unsigned int");
+    status = blr.parse("chr1\t10");
+    BOOST_CHECK(status == (io::Linereader::ERROR | io::Linereader::DATA));
+    BOOST_CHECK_EQUAL(blr.error_msg(), "Too few fields: 2");
+}
+
 BOOST_AUTO_TEST_CASE(gffreader_test)
 {
     io::GffLinereader glr;
@@ -37,9 +37,11 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // 2011-01-26 AA
 
+#include <sstream>
 #include <string>
 
 #include "multovl/io/linewriter.hh"
+#include "multovl/io/outbuffer.hh"
 #include "multovl/multiregion.hh"
 using namespace multovl;
 
@@ -102,4 +104,70 @@ BOOST_AUTO_TEST_CASE(gffwriter_test)
     BOOST_CHECK_EQUAL(exps, obss);
 }
 
+BOOST_AUTO_TEST_CASE(outbuffer_test)
+{
+    // small buffer, flushed several times
+    std::ostringstream outs;
+    io::OutputBuffer buf(&outs, 16);    // actually 64
+    std::string exps = "chr1";
+    buf.put(std::string_view("chr1"));
+    for (unsigned int i = 0; i < 5; ++i) {
+        for (unsigned int n : {0u, 7u, 123456u, 4294967295u}) {
+            buf.put('\t');
+            buf.put(n);
+            exps += '\t' + std::to_string(n);
+        }
+    }
+    buf.put('\n');
+    exps += '\n';
+    BOOST_CHECK(!outs.str().empty());
+    BOOST_CHECK(buf.size() < 64);
+    buf.flush();
+    BOOST_CHECK_EQUAL(buf.size(), 0);
+    BOOST_CHECK_EQUAL(outs.str(), exps);
+    
+    // no stream: the buffer grows
+    io::OutputBuffer membuf(nullptr, 16);
+    exps.clear();
+    for (unsigned int i = 0; i < 100; ++i) {
+        membuf.put(i);
+        exps += std::to_string(i);
+    }
+    BOOST_CHECK_EQUAL(std::string(membuf.data(), membuf.size()), exps);
+}
+
+BOOST_AUTO_TEST_CASE(mregwriter_test)
+{
+    io::BedLinewriter blw(chrom);
+    io::GffLinewriter glw("src", 2, chrom), glw3("src", 3, chrom);
+    
+    // equal ancestors are counted
+    MultiRegion mreg2(mreg);
+    mreg2.add_ancestor(AncestorRegion(4, 6, '-', "a46", 9));
+    
+    for (bool cache : {true, false}) {
+        io::OutputBuffer buf;
+        io::MultiregionWriter bedw(cache), gffw("src", 1, cache), gff3w("src", 3, cache);
+        bedw.chrom(chrom);
+        gffw.chrom(chrom);
+        gff3w.chrom(chrom);
+        std::string exps;
+        for (const MultiRegion* mr : {&mreg, &mreg2, &mreg}) {
+            bedw.write(*mr, buf);
+            gffw.write(*mr, buf);
+            gff3w.write(*mr, buf);
+            exps += blw.write(*mr) + '\n' + glw.write(*mr) + '\n' + glw3.write(*mr) + '\n';
+        }
+        BOOST_CHECK_EQUAL(std::string(buf.data(), buf.size()), exps);
+    }
+    
+    // no ancestors
+    io::OutputBuffer buf;
+    io::MultiregionWriter gffw("src", 2);
+    gffw.chrom(chrom);
+    gffw.write(MultiRegion(10, 20), buf);
+    BOOST_CHECK_EQUAL(std::string(buf.data(), buf.size()), 
+        "chr1\tsrc\toverlap\t10\t20\t.\t.\t.\t.\n");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,9 +38,12 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // -- Standard headers --
 
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <random>
+#include <thread>
 using namespace std;
 
 // -- Own headers --
@@ -170,6 +173,51 @@ MultiOverlap setup_mo_ext(unsigned int extlen=0) {
     return mo;
 }
 
+// converts the overlaps found by the last operation to strings
+// so that the results of the two engines can be compared
+static
+vector<string> results_str(const MultiOverlap& mo)
+{
+    vector<string> strs;
+    for (const auto& mr : mo.overlaps()) {
+        strs.push_back(ExpectedResult::to_str(
+            mr.first(), mr.last(), mr.multiplicity(), mr.anc_str()));
+    }
+    return strs;
+}
+
+// runs all kinds of overlap detections on /mo/ with both engines,
+// and checks that the results are the same
+static
+void compare_engines(MultiOverlap& mo)
+{
+    static const unsigned int EXTS[] = {0, 25};
+    for (unsigned int ext : EXTS) {
+        for (unsigned int minmult = 1; minmult <= 3; ++minmult) {
+            for (bool intrack : {true, false}) {
+                mo.engine(MultiOverlap::TREESWEEP);
+                unsigned int treecnt = mo.find_overlaps(1, minmult, 0, ext, intrack);
+                vector<string> treeres = results_str(mo);
+                mo.engine(MultiOverlap::FLATSWEEP);
+                unsigned int flatcnt = mo.find_overlaps(1, minmult, 0, ext, intrack);
+                BOOST_CHECK_EQUAL(treecnt, flatcnt);
+                vector<string> flatres = results_str(mo);
+                BOOST_CHECK_EQUAL_COLLECTIONS(treeres.begin(), treeres.end(),
+                    flatres.begin(), flatres.end());
+            }
+            mo.engine(MultiOverlap::TREESWEEP);
+            unsigned int treecnt = mo.find_unionoverlaps(1, minmult+1, 0, ext);
+            vector<string> treeres = results_str(mo);
+            mo.engine(MultiOverlap::FLATSWEEP);
+            unsigned int flatcnt = mo.find_unionoverlaps(1, minmult+1, 0, ext);
+            BOOST_CHECK_EQUAL(treecnt, flatcnt);
+            vector<string> flatres = results_str(mo);
+            BOOST_CHECK_EQUAL_COLLECTIONS(treeres.begin(), treeres.end(),
+                flatres.begin(), flatres.end());
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_SUITE(multioverlapsuite, MultovlFixture)
 
 BOOST_AUTO_TEST_CASE(solitary_test)
@@ -236,6 +284,27 @@ BOOST_AUTO_TEST_CASE(mo2_withresults_serialization_test)
     }    
 }
 
+BOOST_AUTO_TEST_CASE(shared_ancestry_test)
+{
+    unsigned int regcnt = mo2.find_overlaps(1, 2, 2);
+    
+    // the overlaps refer to the region table of mo2
+    // which is copied when new regions are added
+    MultiOverlap::multiregvec_t mrs = mo2.overlaps();
+    mo2.add(Region(120, 130, '+', "REGc"), 3);
+    check_results(regcnt, exp2, mrs);
+    check_results(regcnt, exp2, mo2.overlaps());
+    
+    // copies of mo2 do not see each other's new regions
+    MultiOverlap mocopy(mo2);
+    mocopy.add(Region(100, 110, '+', "REGd"), 4);
+    regcnt = mo2.find_overlaps(1, 3, 3);
+    BOOST_CHECK_EQUAL(regcnt, 1);
+    BOOST_CHECK_EQUAL(mo2.overlaps()[0].anc_str(), "1:REGa:+:100-200|2:REGb:-:50-150|3:REGc:+:120-130");
+    regcnt = mocopy.find_overlaps(1, 3, 3);
+    BOOST_CHECK_EQUAL(regcnt, 2);
+}
+
 BOOST_AUTO_TEST_CASE(unionoverlap2_test)
 {
     // union overlap
@@ -303,6 +372,51 @@ BOOST_AUTO_TEST_CASE(extension_test)
     check_results(regcnt, expres, moex.overlaps());
 }
 
+// the extension is a per-call parameter,
+// so MultiOverlap objects with different extensions may work concurrently
+BOOST_AUTO_TEST_CASE(concurrent_extension_test)
+{
+    MultiOverlap mo0 = setup_mo_ext(), mo60 = setup_mo_ext();
+    unsigned int cnt0 = 0, cnt60 = 0;
+    std::thread t0([&mo0, &cnt0]() {
+        for (unsigned int i = 0; i < 200; ++i) cnt0 = mo0.find_overlaps(1, 2, 0, 0);
+    });
+    std::thread t60([&mo60, &cnt60]() {
+        for (unsigned int i = 0; i < 200; ++i) cnt60 = mo60.find_overlaps(1, 2, 0, 60);
+    });
+    t0.join();
+    t60.join();
+    
+    ExpectedResult expres;
+    expres.add(1450, 1500, 2, "1:r3:+:1400-1500|1:r4:+:1450-1600");
+    check_results(cnt0, expres, mo0.overlaps());
+    expres.reset();
+    expres.add(1140, 1160, 2, "1:r1:+:1000-1100|1:r2:+:1200-1300");
+    expres.add(1340, 1360, 2, "1:r2:+:1200-1300|1:r3:+:1400-1500");
+    expres.add(1390, 1560, 2, "1:r3:+:1400-1500|1:r4:+:1450-1600");
+    check_results(cnt60, expres, mo60.overlaps());
+}
+
+// Ancestors are ordered by their true coordinates even if their extended first
+// positions are clamped at 0. Before the extension became a parameter, A and B
+// had the same extended first position (0), and the longer B was listed first.
+BOOST_AUTO_TEST_CASE(clamped_extension_order_test)
+{
+    ExpectedResult expres;
+    expres.add(0, 9, 2, "1:A:+:3-50|1:B:+:5-100");
+    expres.add(10, 40, 3, "1:A:+:3-50|1:B:+:5-100|2:C:+:20-30");
+    expres.add(41, 60, 2, "1:A:+:3-50|1:B:+:5-100");
+    for (auto engine : {MultiOverlap::TREESWEEP, MultiOverlap::FLATSWEEP}) {
+        MultiOverlap mo;
+        mo.engine(engine);
+        mo.add(Region(3, 50, '+', "A"), 1);
+        mo.add(Region(5, 100, '+', "B"), 1);
+        mo.add(Region(20, 30, '+', "C"), 2);
+        unsigned int regcnt = mo.find_overlaps(1, 2, 0, 10);
+        check_results(regcnt, expres, mo.overlaps());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(unionoverlap3_test)
 {
     ExpectedResult expres;
@@ -358,6 +472,135 @@ BOOST_AUTO_TEST_CASE(complexintra_test)
     check_results(regcnt, expres, mo.overlaps());
 }
 
+// the flat sweep engine must produce the same results as the RegLimit-based engine
+BOOST_AUTO_TEST_CASE(flatsweep_test)
+{
+    BOOST_CHECK_EQUAL(mo2.engine(), MultiOverlap::TREESWEEP);  // default
+    
+    mo2.engine(MultiOverlap::FLATSWEEP);
+    unsigned int regcnt = mo2.find_overlaps(1, 2, 2);
+    check_results(regcnt, exp2, mo2.overlaps());
+    
+    compare_engines(mo2);
+    compare_engines(mo3);
+    
+    // random regions on 3 tracks, with lots of duplicates and shared limits
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned int> posdistr(100, 2000), lendistr(0, 150), 
+        trackdistr(1, 3);
+    MultiOverlap morand;
+    for (unsigned int i = 0; i < 300; ++i) {
+        unsigned int first = posdistr(rng) / 10 * 10, 
+            last = first + lendistr(rng) / 10 * 10;
+        unsigned int trackid = trackdistr(rng);
+        morand.add(Region(first, last, (i % 2)? '+': '-', "R" + std::to_string(i % 7)), trackid);
+    }
+    compare_engines(morand);
+}
+
+// the overlaps can be passed to a sink instead of being stored
+BOOST_AUTO_TEST_CASE(sink_test)
+{
+    for (auto eng : {MultiOverlap::TREESWEEP, MultiOverlap::FLATSWEEP}) {
+        mo3.engine(eng);
+        unsigned int regcnt = mo3.find_overlaps(1, 2, 0);
+        vector<string> stored = results_str(mo3);
+        
+        // lvalue sink, not copied
+        vector<string> sunk;
+        auto sink = [&sunk](MultiRegion&& mr) {
+            sunk.push_back(ExpectedResult::to_str(
+                mr.first(), mr.last(), mr.multiplicity(), mr.anc_str()));
+        };
+        BOOST_CHECK_EQUAL(mo3.find_overlaps(1, 2, 0, 0, true, sink), regcnt);
+        BOOST_CHECK_EQUAL_COLLECTIONS(stored.begin(), stored.end(),
+            sunk.begin(), sunk.end());
+        
+        // rvalue sink, the stored overlaps do not change
+        unsigned int total = 0;
+        BOOST_CHECK_EQUAL(mo3.find_unionoverlaps(1, 2, 0, 0, 
+            [&total](const MultiRegion& mr) { total += mr.length(); }), 3);
+        BOOST_CHECK_EQUAL(total, 501 + 101 + 301);
+        vector<string> after = results_str(mo3);
+        BOOST_CHECK_EQUAL_COLLECTIONS(stored.begin(), stored.end(),
+            after.begin(), after.end());
+    }
+}
+
+// the workspace can be released and the object copied at any time
+BOOST_AUTO_TEST_CASE(workspace_test)
+{
+    for (auto eng : {MultiOverlap::TREESWEEP, MultiOverlap::FLATSWEEP}) {
+        mo3.engine(eng);
+        unsigned int regcnt = mo3.find_overlaps(1, 2, 0);
+        vector<string> stored = results_str(mo3);
+        MultiOverlap mocopy(mo3);
+        
+        mo3.release_workspace();
+        vector<string> after = results_str(mo3);
+        BOOST_CHECK_EQUAL_COLLECTIONS(stored.begin(), stored.end(),
+            after.begin(), after.end());
+        
+        // both objects can still detect overlaps
+        BOOST_CHECK_EQUAL(mo3.find_overlaps(1, 2, 0), regcnt);
+        BOOST_CHECK_EQUAL(mocopy.find_overlaps(1, 2, 0), regcnt);
+        vector<string> again = results_str(mo3), copied = results_str(mocopy);
+        BOOST_CHECK_EQUAL_COLLECTIONS(stored.begin(), stored.end(),
+            again.begin(), again.end());
+        BOOST_CHECK_EQUAL_COLLECTIONS(stored.begin(), stored.end(),
+            copied.begin(), copied.end());
+    }
+}
+
+// counting sinks get the same coordinates and multiplicities as MultiRegion sinks
+BOOST_AUTO_TEST_CASE(counting_sink_test)
+{
+    std::mt19937 rng(4242);
+    std::uniform_int_distribution<unsigned int> posdistr(100, 2000), lendistr(0, 150), 
+        trackdistr(1, 3);
+    MultiOverlap morand;
+    for (unsigned int i = 0; i < 300; ++i) {
+        unsigned int first = posdistr(rng) / 10 * 10, 
+            last = first + lendistr(rng) / 10 * 10;
+        morand.add(Region(first, last, '+', "R" + std::to_string(i % 3)), trackdistr(rng));
+    }
+    
+    typedef std::vector<std::array<unsigned int, 3>> fmlvec_t;
+    auto fullsink = [](fmlvec_t& fmls) {
+        return [&fmls](MultiRegion&& mr) { 
+            fmls.push_back({mr.first(), mr.last(), mr.multiplicity()});
+        };
+    };
+    auto countsink = [](fmlvec_t& fmls) {
+        return [&fmls](unsigned int first, unsigned int last, unsigned int mult) { 
+            fmls.push_back({first, last, mult});
+        };
+    };
+    for (auto eng : {MultiOverlap::TREESWEEP, MultiOverlap::FLATSWEEP}) {
+        morand.engine(eng);
+        for (unsigned int ext : {0u, 15u}) {
+            for (unsigned int minmult = 1; minmult <= 3; ++minmult) {
+                for (bool intrack : {true, false}) {
+                    fmlvec_t full, counted;
+                    unsigned int fullcnt = morand.find_overlaps(1, minmult, 0, ext, intrack, 
+                        fullsink(full));
+                    unsigned int countcnt = morand.find_overlaps(1, minmult, 0, ext, intrack, 
+                        countsink(counted));
+                    BOOST_CHECK_EQUAL(fullcnt, countcnt);
+                    BOOST_CHECK(full == counted);
+                }
+                fmlvec_t full, counted;
+                unsigned int fullcnt = morand.find_unionoverlaps(1, minmult+1, 0, ext, 
+                    fullsink(full));
+                unsigned int countcnt = morand.find_unionoverlaps(1, minmult+1, 0, ext, 
+                    countsink(counted));
+                BOOST_CHECK_EQUAL(fullcnt, countcnt);
+                BOOST_CHECK(full == counted);
+            }
+        }
+    }
+}
+
 // now relax... simple test for the MultiOverlap::Counter utility class
 BOOST_AUTO_TEST_CASE(counter_test)
 {
@@ -389,4 +632,30 @@ BOOST_AUTO_TEST_CASE(counter_test)
     BOOST_CHECK_EQUAL(counter.to_string(), "1,2:4 1,2,3:4 2:1");
 }
 
+// track IDs beyond 64 go to the wide track combination table
+BOOST_AUTO_TEST_CASE(widecounter_test)
+{
+    MultiOverlap mo;
+    mo.add(Region(100, 200, '+', "REGa"), 2);
+    mo.add(Region(150, 250, '+', "REGb"), 10);
+    mo.add(Region(300, 400, '+', "REGc"), 2);
+    mo.add(Region(350, 450, '+', "REGd"), 65);
+    mo.add(Region(500, 600, '+', "REGe"), 10);
+    mo.add(Region(550, 650, '+', "REGf"), 130);
+    mo.add(Region(700, 800, '+', "REGg"), 63);
+    mo.add(Region(750, 850, '+', "REGh"), 64);
+    unsigned int regcnt = mo.find_overlaps(1, 2, 0);
+    BOOST_CHECK_EQUAL(regcnt, 4);
+    
+    MultiOverlap::Counter counter;
+    mo.overlap_stats(counter);
+    BOOST_CHECK_EQUAL(counter.total(), 4);
+    BOOST_CHECK_EQUAL(counter.to_string(), "10,130:1 2,10:1 2,65:1 63,64:1");
+    
+    // merging adds up the counts of the same combinations in both tables
+    counter += counter;
+    BOOST_CHECK_EQUAL(counter.total(), 8);
+    BOOST_CHECK_EQUAL(counter.to_string(), "10,130:2 2,10:2 2,65:2 63,64:2");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
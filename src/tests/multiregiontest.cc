@@ -116,6 +116,50 @@ BOOST_AUTO_TEST_CASE(multiregion_test)
     BOOST_CHECK(std::equal(ancids, ancids+3, ais3.begin())); // compare to {0,9,9}
 }
 
+BOOST_AUTO_TEST_CASE(shared_pool_test)
+{
+    // pool of ancestors, not sorted
+    auto pool = std::make_shared<ancregvec_t>();
+    pool->push_back(a2);
+    pool->push_back(a1);
+    pool->push_back(a2);
+    
+    // the indices must list the ancestors in ascending order
+    MultiRegion::ancidxvec_t idx1{1, 0}, idx2{0, 2};
+    MultiRegion mr1(4, 5, pool, idx1, 0), mr2(4, 6, pool, idx2, 1);
+    BOOST_CHECK_EQUAL(mr1.multiplicity(), 2);
+    BOOST_CHECK_EQUAL(mr1.ancestor_count(), 2);
+    BOOST_CHECK_EQUAL(mr1.anc_str(), "0:a15:+:1-5|9:a46:-:4-6");
+    BOOST_CHECK_EQUAL(mr2.multiplicity(), 1);
+    BOOST_CHECK_EQUAL(mr2.anc_str(), "2*9:a46:-:4-6");
+    BOOST_CHECK(!mr2.solitary());
+    BOOST_CHECK_EQUAL(mr1.name(), "overlap");
+    
+    // adding an ancestor must not change the shared pool
+    mr1.add_ancestor(a1);
+    BOOST_CHECK_EQUAL(mr1.anc_str(), "2*0:a15:+:1-5|9:a46:-:4-6");
+    BOOST_CHECK_EQUAL(pool->size(), 3);
+    BOOST_CHECK_EQUAL(mr2.anc_str(), "2*9:a46:-:4-6");
+    
+    // the shared pool is saved only once
+    Tempfile tempfile;
+    {
+        std::ofstream ofs(tempfile.name());
+        boost::archive::text_oarchive oa(ofs);
+        MultiRegion mr3(2, 5, pool, idx1, 0);
+        oa << mr2 << mr3;
+    }
+    {
+        std::ifstream ifs(tempfile.name());
+        boost::archive::text_iarchive ia(ifs);
+        MultiRegion inmr2, inmr3;
+        ia >> inmr2 >> inmr3;
+        BOOST_CHECK_EQUAL(inmr2.anc_str(), "2*9:a46:-:4-6");
+        BOOST_CHECK_EQUAL(inmr3.anc_str(), "0:a15:+:1-5|9:a46:-:4-6");
+        BOOST_CHECK(inmr2.ancestor_pool() == inmr3.ancestor_pool());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(multiregion_serialization_test)
 {
     mr.add_ancestor(a2);    // 2 ancestors
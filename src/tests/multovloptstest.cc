@@ -48,6 +48,7 @@ using namespace std;
 // -- Own header --
 
 #include "multovl/multovlopts.hh"
+#include "multovl/classicopts.hh"
 using namespace multovl;
 
 // gets rid of annoying "deprecated conversion from string constant blah blah" warning
@@ -128,4 +129,50 @@ BOOST_AUTO_TEST_CASE(bad_mM_test)
     );
 }
 
+// --sorted cannot run on several threads
+BOOST_AUTO_TEST_CASE(sorted_threads_test)
+{
+    const int ARGC = 5;
+    char *ARGV[] = { "multovloptstest", "--sorted", "-T", "8", "in.bed" };
+    
+    ClassicOpts opt;
+    bool ok = opt.parse_check(ARGC, ARGV);
+    BOOST_CHECK(!ok);
+    BOOST_CHECK_EQUAL(
+        opt.error_messages(),
+        "ERROR: The --sorted switch cannot be combined with -T\n"
+    );
+    
+    ClassicOpts opt1;
+    ARGV[3] = "1";
+    BOOST_CHECK(opt1.parse_check(ARGC, ARGV));
+}
+
+// --membudget cannot run on several threads either
+BOOST_AUTO_TEST_CASE(membudget_threads_test)
+{
+    const int ARGC = 6;
+    char *ARGV[] = { "multovloptstest", "--membudget", "100", "-T", "0", "in.bed" };
+    
+    ClassicOpts opt;
+    bool ok = opt.parse_check(ARGC, ARGV);
+    BOOST_CHECK(!ok);
+    BOOST_CHECK_EQUAL(
+        opt.error_messages(),
+        "ERROR: The --membudget option cannot be combined with -T\n"
+    );
+}
+
+// the new options are echoed in the parameter string
+BOOST_AUTO_TEST_CASE(param_str_test)
+{
+    const int ARGC = 7;
+    char *ARGV[] = { "multovloptstest", "--cache", "/tmp/cachedir", "--sorted", "-o", "out.gff", "in.bed" };
+    
+    ClassicOpts opt;
+    BOOST_CHECK(opt.parse_check(ARGC, ARGV));
+    BOOST_CHECK_EQUAL(opt.param_str(), 
+        " -L 1 --cache /tmp/cachedir -m 2 -M 0 -s multovl -f GFF -o out.gff --sorted");
+}
+
 #pragma GCC diagnostic pop
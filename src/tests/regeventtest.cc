@@ -0,0 +1,89 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE regeventtest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/regevent.hh"
+using namespace multovl;
+
+// -- Standard headers --
+
+#include <vector>
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(regeventsuite)
+
+BOOST_AUTO_TEST_CASE(regevent_test)
+{
+    RegEvent rf(4, true, 9), rl(6, false, 9);
+    
+    BOOST_CHECK_EQUAL(rf.pos(), 4);
+    BOOST_CHECK(rf.is_first());
+    BOOST_CHECK_EQUAL(rf.index(), 9);
+    
+    BOOST_CHECK_EQUAL(rl.pos(), 6);
+    BOOST_CHECK(!rl.is_first());
+    BOOST_CHECK_EQUAL(rl.index(), 9);
+    
+    BOOST_CHECK(rf < rl);
+    
+    // extreme values must survive packing
+    RegEvent rmax(0xFFFFFFFFu, false, RegEvent::MAX_INDEX);
+    BOOST_CHECK_EQUAL(rmax.pos(), 0xFFFFFFFFu);
+    BOOST_CHECK(!rmax.is_first());
+    BOOST_CHECK_EQUAL(rmax.index(), RegEvent::MAX_INDEX);
+    
+    BOOST_CHECK_NO_THROW(RegEvent::check_size(RegEvent::MAX_INDEX));
+    BOOST_CHECK_THROW(RegEvent::check_size(std::size_t(RegEvent::MAX_INDEX) + 2), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(regevent_order_test)
+{
+    // position first, then "first" before "last", then ancestor index
+    std::vector<RegEvent> evs{
+        RegEvent(10, false, 0), RegEvent(10, true, 3),
+        RegEvent(5, false, 1), RegEvent(10, true, 2)
+    };
+    std::sort(evs.begin(), evs.end());
+    
+    BOOST_CHECK_EQUAL(evs[0].pos(), 5);
+    BOOST_CHECK(evs[1].is_first() && evs[1].index() == 2);
+    BOOST_CHECK(evs[2].is_first() && evs[2].index() == 3);
+    BOOST_CHECK(!evs[3].is_first() && evs[3].index() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
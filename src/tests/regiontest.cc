@@ -97,24 +97,26 @@ BOOST_AUTO_TEST_CASE(length_test)
 
 BOOST_AUTO_TEST_CASE(extension_test)
 {
-    // by default the extension is 0
-    BOOST_CHECK_EQUAL(Region::extension(), 0);
-    // change it
-    Region::set_extension(3);
-    BOOST_CHECK_EQUAL(r15.first(), 0); // because extension > first
-    BOOST_CHECK_EQUAL(r15.last(), 8);
-    BOOST_CHECK_EQUAL(r15.length(), 9);
-    BOOST_CHECK_EQUAL(r46.first(), 1); // here `extension` could be subtracted
-    BOOST_CHECK_EQUAL(r46.last(), 9);
-    BOOST_CHECK_EQUAL(r46.length(), 9);
+    // extension 0 leaves everything as it is
+    BOOST_CHECK_EQUAL(r15.extended_first(0), r15.first());
+    BOOST_CHECK_EQUAL(r15.extended_last(0), r15.last());
+    BOOST_CHECK_EQUAL(r_empty.extended_length(0), 0);
+    // extend by 3
+    BOOST_CHECK_EQUAL(r15.extended_first(3), 0); // because extension > first
+    BOOST_CHECK_EQUAL(r15.extended_last(3), 8);
+    BOOST_CHECK_EQUAL(r15.extended_length(3), 9);
+    BOOST_CHECK_EQUAL(r46.extended_first(3), 1); // here `extension` could be subtracted
+    BOOST_CHECK_EQUAL(r46.extended_last(3), 9);
+    BOOST_CHECK_EQUAL(r46.extended_length(3), 9);
+    // the true coordinates are not affected
+    BOOST_CHECK_EQUAL(r46.first(), 4);
+    BOOST_CHECK_EQUAL(r46.last(), 6);
     // change the extended coordinates
     // 5 -- 8 ======= 16 -- 19
-    r46.set_coords(5, 19);
-    BOOST_CHECK_EQUAL(r46.first(), 5);
-    BOOST_CHECK_EQUAL(r46.last(), 19);
-    // set extension back to 0
-    Region::set_extension(0);
-    BOOST_CHECK_EQUAL(r46.first(), 8);  // `set_coords` stored the non-extended "true" coordinates
+    r46.set_extended_coords(5, 19, 3);
+    BOOST_CHECK_EQUAL(r46.extended_first(3), 5);
+    BOOST_CHECK_EQUAL(r46.extended_last(3), 19);
+    BOOST_CHECK_EQUAL(r46.first(), 8);  // the non-extended "true" coordinates are stored
     BOOST_CHECK_EQUAL(r46.last(), 16);
 }
 
@@ -233,18 +233,50 @@ BOOST_AUTO_TEST_CASE(ext_shuffle_test)
     regcnt = so3.shuffle_overlaps(rng, 1, 2, 0, EXT, false);
 
     // check if the fixed tracks remained fixed (ID=1,2)
+    // the region limits store the extended positions
     const MultiOverlap::reglimset_t& reglims = so3.reglims();
-    BOOST_CHECK(is_present(reglims, 100, 600, 1));
-    BOOST_CHECK(is_present(reglims, 200, 500, 2));
-    BOOST_CHECK(is_present(reglims, 700, 800, 1));
-    BOOST_CHECK(is_present(reglims, 700, 800, 2));
+    BOOST_CHECK(is_present(reglims, 100-EXT, 600+EXT, 1));
+    BOOST_CHECK(is_present(reglims, 200-EXT, 500+EXT, 2));
+    BOOST_CHECK(is_present(reglims, 700-EXT, 800+EXT, 1));
+    BOOST_CHECK(is_present(reglims, 700-EXT, 800+EXT, 2));
 
     // chances are _very_ slim that the reshuffled track 3 regions stayed in place
-    BOOST_CHECK(!is_present(reglims, 300, 400, 3));
-    BOOST_CHECK(!is_present(reglims, 700, 800, 3));
+    BOOST_CHECK(!is_present(reglims, 300-EXT, 400+EXT, 3));
+    BOOST_CHECK(!is_present(reglims, 700-EXT, 800+EXT, 3));
     
     std::cout << "Reglims after reshuffling:" << std::endl;
     so3.print_reglims();
 }
 
+// the flat sweep engine must reshuffle and overlap exactly like the RegLimit-based engine
+BOOST_AUTO_TEST_CASE(flatsweep_shuffle_test)
+{
+    ShuffleOvl flat3(so3);  // copy before any overlap detection
+    flat3.engine(MultiOverlap::FLATSWEEP);
+    UniformGen flatrng(42);
+    
+    for (unsigned int ext : {0u, 20u}) {
+        unsigned int regcnt = so3.find_overlaps(1, 2, 0, ext, false),
+            flatcnt = flat3.find_overlaps(1, 2, 0, ext, false);
+        BOOST_CHECK_EQUAL(regcnt, flatcnt);
+        for (unsigned int i = 0; i < 10; ++i) {
+            regcnt = so3.shuffle_overlaps(rng, 1, 2, 0, ext, false);
+            flatcnt = flat3.shuffle_overlaps(flatrng, 1, 2, 0, ext, false);
+            BOOST_CHECK_EQUAL(regcnt, flatcnt);
+            ExpectedResult treeres, flatres;
+            for (const auto& mr : so3.overlaps()) {
+                treeres.add(mr.first(), mr.last(), mr.multiplicity(), mr.anc_str());
+            }
+            check_results(flatcnt, treeres, flat3.overlaps());
+            
+            regcnt = so3.shuffle_unionoverlaps(rng, 1, 2, 0, ext);
+            flatcnt = flat3.shuffle_unionoverlaps(flatrng, 1, 2, 0, ext);
+            for (const auto& mr : so3.overlaps()) {
+                flatres.add(mr.first(), mr.last(), mr.multiplicity(), mr.anc_str());
+            }
+            check_results(flatcnt, flatres, flat3.overlaps());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
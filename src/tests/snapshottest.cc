@@ -0,0 +1,165 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE snapshottest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/snapshot.hh"
+#include "multovl/multioverlap.hh"
+#include "multovl/multiregion.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Standard headers --
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// converts the overlaps found in /mo/ to strings
+static std::vector<std::string> overlaps_tostr(const MultiOverlap& mo)
+{
+    std::vector<std::string> strs;
+    for (const auto& mr : mo.overlaps())
+    {
+        strs.push_back(std::to_string(mr.first()) + '-' + std::to_string(mr.last()) + 
+            ':' + std::to_string(mr.multiplicity()) + ':' + mr.anc_str());
+    }
+    return strs;
+}
+
+struct SnapshotFixture
+{
+    SnapshotFixture(): tempfile(), fname(std::filesystem::path(tempfile.name()).string())
+    {
+        mo1.add(Region(100, 200, '+', "REGa"), 1);
+        mo1.add(Region(150, 250, '-', "REGb"), 2);
+        mo1.add(Region(180, 190, '.', "REGa"), 3);
+        mo1.add(Region(300, 400, '+', ""), 1);
+        mo2.add(Region(4000000000u, 4000000010u, '-', "far"), 2);
+    }
+    
+    // writes the inputs and /mo1/, /mo2/ to /fname/
+    void write_snapshot()
+    {
+        io::SnapshotWriter writer;
+        writer.add_input("a.bed", 1, 2);
+        writer.add_input("b.gff", 2, 2);
+        writer.add_input("c.bam", 3, 1);
+        writer.add_chrom("chr1", mo1.regions());
+        writer.add_chrom("chrX", mo2.regions());
+        writer.add_chrom("empty", MultiOverlap().regions());
+        BOOST_REQUIRE(writer.write(fname));
+    }
+    
+    MultiOverlap mo1, mo2;
+    Tempfile tempfile;
+    std::string fname;
+};
+
+BOOST_FIXTURE_TEST_SUITE(snapshotsuite, SnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(roundtrip_test)
+{
+    write_snapshot();
+    
+    io::SnapshotReader reader(fname);
+    BOOST_REQUIRE_EQUAL(reader.error(), "");
+    BOOST_REQUIRE_EQUAL(reader.input_count(), 3);
+    io::SnapshotReader::Input inp = reader.input(1);
+    BOOST_CHECK_EQUAL(inp.name, "b.gff");
+    BOOST_CHECK_EQUAL(inp.trackid, 2);
+    BOOST_CHECK_EQUAL(inp.regcnt, 2);
+    BOOST_REQUIRE_EQUAL(reader.chrom_count(), 3);
+    BOOST_CHECK_EQUAL(reader.chrom(0), "chr1");
+    BOOST_CHECK_EQUAL(reader.chrom(2), "empty");
+    BOOST_CHECK(reader.regions(2).empty());
+    
+    AncestorTable regions = reader.regions(1);
+    BOOST_REQUIRE_EQUAL(regions.size(), 1);
+    BOOST_CHECK_EQUAL(regions.to_attrstring(0), "2:far:-:4000000000-4000000010");
+    
+    // the overlaps of the loaded regions are the same as those of the originals
+    mo1.find_overlaps(1, 1, 0);
+    MultiOverlap inmo1(reader.regions(0));
+    BOOST_CHECK_EQUAL(inmo1.region_count(), 4);
+    inmo1.find_overlaps(1, 1, 0);
+    std::vector<std::string> exp = overlaps_tostr(mo1), strs = overlaps_tostr(inmo1);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+}
+
+BOOST_AUTO_TEST_CASE(inplace_test)
+{
+    write_snapshot();
+    AncestorTable regions;
+    {
+        // the regions stay usable after the reader is gone
+        io::SnapshotReader reader(fname);
+        regions = reader.regions(0);
+    }
+    const AncestorTable& cregions = regions;
+    const RegRecord* mapped = cregions.records();
+    BOOST_CHECK_EQUAL(regions.name(1), "REGb");
+    
+    // adding a region copies the records
+    regions.push_back(Region(1, 2, '+', "REGc"), 4);
+    BOOST_CHECK(cregions.records() != mapped);
+    BOOST_CHECK_EQUAL(regions.size(), 5);
+    BOOST_CHECK_EQUAL(regions.to_attrstring(2), "3:REGa:.:180-190");
+    BOOST_CHECK_EQUAL(regions.to_attrstring(4), "4:REGc:+:1-2");
+}
+
+BOOST_AUTO_TEST_CASE(bad_test)
+{
+    {
+        std::ofstream out(fname);
+        out << "track name=notasnapshot\n";
+    }
+    io::SnapshotReader reader(fname);
+    BOOST_CHECK_EQUAL(reader.error(), "Not a snapshot file: " + fname);
+    BOOST_CHECK_EQUAL(reader.chrom_count(), 0);
+    
+    // truncated
+    write_snapshot();
+    auto size = std::filesystem::file_size(fname);
+    std::filesystem::resize_file(fname, size - 1);
+    io::SnapshotReader truncated(fname);
+    BOOST_CHECK_EQUAL(truncated.error(), "Corrupt snapshot file: " + fname);
+    BOOST_CHECK_EQUAL(truncated.input_count(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
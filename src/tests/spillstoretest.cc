@@ -0,0 +1,209 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE spillstoretest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/spillstore.hh"
+#include "multovl/streamoverlap.hh"
+using namespace multovl;
+
+// -- Standard headers --
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// a region read back from the store
+struct Spilled
+{
+    unsigned int first, last, trackid;
+    char strand;
+    std::string name;
+};
+
+struct SpillStoreFixture
+{
+    SpillStoreFixture(): store(1 << 20), tmpdir(std::filesystem::temp_directory_path().string())
+    {
+        BOOST_REQUIRE_EQUAL(store.error(), "");
+    }
+    
+    // reads back /chrom/ from /store/
+    std::vector<Spilled> read_back(const std::string& chrom, bool sorted)
+    {
+        std::vector<Spilled> regs;
+        auto sink = [&regs](const BaseRegion& reg, unsigned int trackid) {
+            regs.push_back(Spilled{ reg.first(), reg.last(), trackid, reg.strand(), reg.name() });
+        };
+        bool ok = sorted? store.read_sorted(chrom, sink): store.read(chrom, sink);
+        BOOST_CHECK(ok);
+        return regs;
+    }
+    
+    io::SpillStore store;   // the smallest budget, 1 MB
+    std::string tmpdir;
+};
+
+BOOST_FIXTURE_TEST_SUITE(spillstoresuite, SpillStoreFixture)
+
+BOOST_AUTO_TEST_CASE(small_test)
+{
+    BOOST_CHECK(store.add("chr2", BaseRegion(30, 40, '-', "b"), 1));
+    BOOST_CHECK(store.add("chr1", BaseRegion(100, 200, '+', "a"), 1));
+    BOOST_CHECK(store.add("chr1", BaseRegion(50, 60, '.', ""), 2));
+    BOOST_CHECK(store.add("chr1", BaseRegion(100, 150, '+', "c"), 2));
+    BOOST_REQUIRE(store.flush());
+    
+    std::vector<std::string> chroms = store.chroms();
+    BOOST_REQUIRE_EQUAL(chroms.size(), 2);
+    BOOST_CHECK_EQUAL(chroms[0], "chr1");
+    BOOST_CHECK_EQUAL(store.region_count("chr1"), 3);
+    BOOST_CHECK_EQUAL(store.region_count("chrX"), 0);
+    
+    std::vector<Spilled> regs = read_back("chr1", false);
+    BOOST_REQUIRE_EQUAL(regs.size(), 3);
+    BOOST_CHECK_EQUAL(regs[0].first, 100);
+    BOOST_CHECK_EQUAL(regs[1].name, "");
+    BOOST_CHECK_EQUAL(regs[1].strand, '.');
+    BOOST_CHECK_EQUAL(regs[2].trackid, 2);
+    
+    // equal first positions keep the order of addition
+    regs = read_back("chr1", true);
+    BOOST_REQUIRE_EQUAL(regs.size(), 3);
+    BOOST_CHECK_EQUAL(regs[0].first, 50);
+    BOOST_CHECK_EQUAL(regs[1].name, "a");
+    BOOST_CHECK_EQUAL(regs[2].name, "c");
+    BOOST_CHECK_EQUAL(regs[2].last, 150);
+    
+    store.release("chr1");
+    BOOST_CHECK_EQUAL(store.chroms().size(), 1);
+    BOOST_CHECK(read_back("chr1", true).empty());
+    BOOST_CHECK_EQUAL(read_back("chr2", true).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(external_sort_test)
+{
+    // several MB of regions, i.e. several sorted runs
+    const unsigned int N = 200000;
+    std::mt19937 rng(42);
+    std::vector<unsigned int> firsts;
+    for (unsigned int i = 0; i < N; ++i)
+    {
+        unsigned int first = rng() % 100000;
+        firsts.push_back(first);
+        BOOST_REQUIRE(store.add("chr1", 
+            BaseRegion(first, first + 10, '+', "region" + std::to_string(i)), 1 + i % 3));
+    }
+    BOOST_REQUIRE(store.flush());
+    BOOST_CHECK_GT(store.byte_count("chr1"), 2u << 20);
+    
+    std::vector<Spilled> regs = read_back("chr1", true);
+    BOOST_REQUIRE_EQUAL(regs.size(), N);
+    for (unsigned int i = 1; i < N; ++i)
+    {
+        unsigned int previdx = std::stoul(regs[i - 1].name.substr(6)),
+            idx = std::stoul(regs[i].name.substr(6));
+        BOOST_REQUIRE(regs[i - 1].first < regs[i].first || 
+            (regs[i - 1].first == regs[i].first && previdx < idx));
+        BOOST_REQUIRE_EQUAL(regs[i].first, firsts[idx]);
+        BOOST_REQUIRE_EQUAL(regs[i].trackid, 1 + idx % 3);
+    }
+    
+    // the order of addition
+    regs = read_back("chr1", false);
+    BOOST_REQUIRE_EQUAL(regs.size(), N);
+    BOOST_CHECK_EQUAL(regs[N - 1].name, "region" + std::to_string(N - 1));
+}
+
+// the oversized chromosomes of the memory budget mode are streamed
+// through StreamOverlap, its memory use must not grow with the chromosome
+BOOST_AUTO_TEST_CASE(bounded_stream_test)
+{
+    // distinct names in shuffled order, pairs of overlapping regions
+    const unsigned int N = 200000;
+    std::vector<unsigned int> idxs(N);
+    for (unsigned int i = 0; i < N; ++i)
+        idxs[i] = i;
+    std::shuffle(idxs.begin(), idxs.end(), std::mt19937(42));
+    for (unsigned int i : idxs)
+    {
+        BOOST_REQUIRE(store.add("chr1", 
+            BaseRegion(100 * i, 100 * i + ((i % 2)? 50: 120), '+', "region" + std::to_string(i)), 1 + i % 2));
+    }
+    BOOST_REQUIRE(store.flush());
+    BOOST_CHECK_GT(store.byte_count("chr1"), 2u << 20);
+    
+    for (bool uniregion : { false, true })
+    {
+        StreamOverlap sovl(1, 2, 0, 0, true, uniregion);
+        unsigned int maxslots = 0, maxnames = 0, ovlcnt = 0;
+        BOOST_CHECK(store.read_sorted("chr1", [&](const BaseRegion& reg, unsigned int trackid) {
+            BOOST_CHECK(sovl.add(reg, trackid));
+            ovlcnt += sovl.overlaps().size();
+            maxslots = std::max(maxslots, sovl.slot_count());
+            maxnames = std::max(maxnames, sovl.name_count());
+        }));
+        sovl.finish();
+        ovlcnt += sovl.overlaps().size();
+        BOOST_CHECK_EQUAL(ovlcnt, N / 2);
+        BOOST_CHECK_EQUAL(sovl.max_depth(), 2);
+        BOOST_CHECK_LE(maxslots, 4);
+        BOOST_CHECK_LE(maxnames, 2 * maxslots + 1024 + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cleanup_test)
+{
+    // the temporary files are removed with the store
+    std::filesystem::path dir;
+    {
+        io::SpillStore other(1 << 20, tmpdir);
+        other.add("chr1", BaseRegion(1, 2, '+', "x"), 1);
+        BOOST_REQUIRE(other.flush());
+        for (const auto& entry : std::filesystem::directory_iterator(tmpdir)) {
+            if (entry.path().filename().string().rfind("multovl-spill-", 0) == 0 &&
+                !std::filesystem::is_empty(entry.path()))
+                dir = entry.path();
+        }
+        BOOST_REQUIRE(!dir.empty());
+    }
+    BOOST_CHECK(!std::filesystem::exists(dir));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
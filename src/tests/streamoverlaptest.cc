@@ -0,0 +1,236 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE streamoverlaptest
+#include "boost/test/unit_test.hpp"
+
+// -- Standard headers --
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+using namespace std;
+
+// -- Own headers --
+
+#include "multovl/streamoverlap.hh"
+#include "multovl/multioverlap.hh"
+
+using namespace multovl;
+
+// -- Utilities --
+
+// a region with its track ID
+struct TrackRegion
+{
+    Region reg;
+    unsigned int trackid;
+};
+
+// converts a multiregion to a string for comparisons
+static
+string mr_str(const MultiRegion& mr)
+{
+    return to_string(mr.first()) + ',' + to_string(mr.last()) + ',' 
+        + to_string(mr.multiplicity()) + ',' + mr.anc_str();
+}
+
+// random regions on 3 tracks with lots of duplicates and shared limits,
+// sorted by first position
+static
+vector<TrackRegion> random_regions(unsigned int seed, unsigned int n)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned int> posdistr(0, 3000), lendistr(0, 150), 
+        trackdistr(1, 3);
+    vector<TrackRegion> regs;
+    for (unsigned int i = 0; i < n; ++i) {
+        unsigned int first = posdistr(rng) / 10 * 10, 
+            last = first + lendistr(rng) / 10 * 10;
+        regs.push_back(TrackRegion{
+            Region(first, last, (i % 2)? '+': '-', "R" + std::to_string(i % 7)), trackdistr(rng)});
+    }
+    std::stable_sort(regs.begin(), regs.end(), 
+        [](const TrackRegion& r1, const TrackRegion& r2) { return r1.reg.first() < r2.reg.first(); });
+    return regs;
+}
+
+// runs a StreamOverlap and a MultiOverlap on the same regions with the same parameters
+// and checks that they find the same overlaps
+static
+void compare_stream(const vector<TrackRegion>& regs, unsigned int ovlen, 
+    unsigned int minmult, unsigned int maxmult, unsigned int ext, bool intrack, bool uniregion)
+{
+    MultiOverlap mo;
+    for (const auto& tr : regs) {
+        mo.add(tr.reg, tr.trackid);
+    }
+    if (uniregion)
+        mo.find_unionoverlaps(ovlen, minmult, maxmult, ext);
+    else
+        mo.find_overlaps(ovlen, minmult, maxmult, ext, intrack);
+    vector<string> expected;
+    for (const auto& mr : mo.overlaps()) {
+        expected.push_back(mr_str(mr));
+    }
+    
+    // the overlaps must be converted before the next call
+    StreamOverlap so(ovlen, minmult, maxmult, ext, intrack, uniregion);
+    vector<string> streamed;
+    for (const auto& tr : regs) {
+        BOOST_CHECK(so.add(tr.reg, tr.trackid));
+        for (const auto& mr : so.overlaps()) {
+            streamed.push_back(mr_str(mr));
+        }
+    }
+    so.finish();
+    for (const auto& mr : so.overlaps()) {
+        streamed.push_back(mr_str(mr));
+    }
+    BOOST_CHECK(streamed == expected);
+    BOOST_CHECK(so.max_depth() <= regs.size());
+}
+
+// -- Tests --
+
+BOOST_AUTO_TEST_CASE(triple_test)
+{
+    // src/test/data/triple[a-c].bed
+    StreamOverlap so(1, 2, 0, 0, true, false);
+    vector<string> ovls;
+    auto collect = [&so, &ovls]() {
+        for (const auto& mr : so.overlaps()) {
+            ovls.push_back(mr_str(mr));
+        }
+    };
+    so.add(Region(100, 600, '+', "REGa"), 1);
+    collect();
+    so.add(Region(200, 500, '+', "REGb"), 2);
+    collect();
+    BOOST_CHECK(ovls.empty());
+    so.add(Region(300, 400, '+', "REGc"), 3);
+    collect();
+    
+    // overlaps are emitted as soon as the sweep has passed them
+    so.add(Region(700, 800, '+', "REGa"), 1);
+    collect();
+    vector<string> expected{
+        "200,299,2,1:REGa:+:100-600|2:REGb:+:200-500",
+        "300,400,3,1:REGa:+:100-600|2:REGb:+:200-500|3:REGc:+:300-400",
+        "401,500,2,1:REGa:+:100-600|2:REGb:+:200-500"
+    };
+    BOOST_CHECK(ovls == expected);
+    BOOST_CHECK_EQUAL(so.max_depth(), 3);
+    
+    // out of order
+    BOOST_CHECK(!so.add(Region(650, 800, '+', "REGx"), 2));
+    
+    so.add(Region(700, 800, '+', "REGb"), 2);
+    so.finish();
+    BOOST_CHECK_EQUAL(so.overlaps().size(), 1);
+    BOOST_CHECK_EQUAL(mr_str(so.overlaps()[0]), 
+        "700,800,2,1:REGa:+:700-800|2:REGb:+:700-800");
+    
+    // may be reused for another chromosome, starting from the beginning
+    BOOST_CHECK(so.add(Region(100, 200, '+', "REGa"), 1));
+    BOOST_CHECK(so.add(Region(150, 250, '+', "REGb"), 2));
+    so.finish();
+    BOOST_CHECK_EQUAL(so.overlaps().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(random_test)
+{
+    vector<TrackRegion> regs = random_regions(42, 500);
+    for (unsigned int ext : {0u, 15u}) {
+        compare_stream(regs, 1, 1, 0, ext, true, false);   // solitaries, too
+        compare_stream(regs, 1, 2, 0, ext, true, false);
+        compare_stream(regs, 1, 2, 0, ext, false, false);  // no intra-track overlaps
+        compare_stream(regs, 20, 3, 4, ext, true, false);
+        compare_stream(regs, 1, 2, 0, ext, true, true);    // unions
+        compare_stream(regs, 50, 3, 0, ext, true, true);
+    }
+}
+
+// the memory use depends on the pileup depth, not on the number of regions,
+// even if every region has a different name
+BOOST_AUTO_TEST_CASE(bounded_names_test)
+{
+    const unsigned int N = 50000;
+    StreamOverlap so(1, 2, 0, 0, true, false);
+    unsigned int maxslots = 0, maxnames = 0, ovlcnt = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+        // each region overlaps with the previous one only
+        BOOST_CHECK(so.add(Region(100 * i, 100 * i + 120, '+', "name" + to_string(i)), 1 + i % 2));
+        ovlcnt += so.overlaps().size();
+        maxslots = std::max(maxslots, so.slot_count());
+        maxnames = std::max(maxnames, so.name_count());
+    }
+    so.finish();
+    ovlcnt += so.overlaps().size();
+    BOOST_CHECK_EQUAL(ovlcnt, N - 1);
+    BOOST_CHECK_EQUAL(so.max_depth(), 2);
+    BOOST_CHECK(maxslots <= 4);
+    BOOST_CHECK(maxnames <= 2 * maxslots + 1024 + 1);
+}
+
+// the union mode reuses the slots of the completed union regions
+BOOST_AUTO_TEST_CASE(union_slots_test)
+{
+    const unsigned int N = 10000;
+    StreamOverlap so(1, 2, 0, 0, true, true);
+    unsigned int maxslots = 0, ovlcnt = 0;
+    auto check = [&so, &ovlcnt]() {
+        for (const auto& mr : so.overlaps()) {
+            // the ancestors must not be overwritten before the union region is seen
+            string k = to_string(ovlcnt), f = to_string(100 * ovlcnt);
+            BOOST_CHECK_EQUAL(mr_str(mr), f + ',' + to_string(100 * ovlcnt + 40) + ",2,"
+                + "1:A" + k + ":+:" + f + '-' + to_string(100 * ovlcnt + 30) + '|'
+                + "2:B" + k + ":+:" + to_string(100 * ovlcnt + 10) + '-' + to_string(100 * ovlcnt + 40));
+            ++ovlcnt;
+        }
+    };
+    for (unsigned int i = 0; i < N; ++i) {
+        // pairs of overlapping regions, far from each other
+        BOOST_CHECK(so.add(Region(100 * i, 100 * i + 30, '+', "A" + to_string(i)), 1));
+        check();
+        BOOST_CHECK(so.add(Region(100 * i + 10, 100 * i + 40, '+', "B" + to_string(i)), 2));
+        check();
+        maxslots = std::max(maxslots, so.slot_count());
+    }
+    so.finish();
+    check();
+    BOOST_CHECK_EQUAL(ovlcnt, N);
+    BOOST_CHECK(maxslots <= 4);
+}
@@ -0,0 +1,143 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE strpooltest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/strpool.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Boost headers --
+
+#include "boost/archive/text_iarchive.hpp"
+#include "boost/archive/text_oarchive.hpp"
+
+// -- Standard headers --
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+struct StrPoolFixture
+{
+    StrPoolFixture()
+    {
+        pool.intern("chr1");
+        pool.intern("bam");
+        pool.intern("chr1");
+        pool.intern("chrX");
+    }
+    
+    StringPool pool;
+};
+
+BOOST_FIXTURE_TEST_SUITE(strpoolsuite, StrPoolFixture)
+
+BOOST_AUTO_TEST_CASE(intern_test)
+{
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+    BOOST_CHECK_EQUAL(pool.intern("bam"), 1);
+    BOOST_CHECK_EQUAL(pool.intern("chrX"), 2);
+    BOOST_CHECK_EQUAL(pool.intern(""), 3);
+    BOOST_CHECK_EQUAL(pool[0], "chr1");
+    BOOST_CHECK_EQUAL(pool[3], "");
+    
+    // long strings get a block of their own
+    std::string longstr(100000, 'x');
+    unsigned int longid = pool.intern(longstr);
+    BOOST_CHECK_EQUAL(pool[longid], longstr);
+    BOOST_CHECK_EQUAL(pool.intern("chr2"), longid + 1);
+    BOOST_CHECK_EQUAL(pool.intern(longstr), longid);
+}
+
+BOOST_AUTO_TEST_CASE(copy_clear_test)
+{
+    StringPool other(pool);
+    pool.clear();
+    BOOST_CHECK(pool.empty());
+    BOOST_CHECK_EQUAL(pool.intern("chrX"), 0);
+    BOOST_CHECK_EQUAL(other.size(), 3);
+    BOOST_CHECK_EQUAL(other[2], "chrX");
+    BOOST_CHECK_EQUAL(other.intern("chr1"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(strpoolser_test)
+{
+    Tempfile tempfile;
+    {
+        std::ofstream ofs(tempfile.name());
+        boost::archive::text_oarchive oa(ofs);
+        oa << pool;
+    }
+    
+    {
+        std::ifstream ifs(tempfile.name());
+        boost::archive::text_iarchive ia(ifs);
+        StringPool inpool;
+        ia >> inpool;
+        BOOST_CHECK_EQUAL(inpool.size(), 3);
+        BOOST_CHECK_EQUAL(inpool[1], "bam");
+        BOOST_CHECK_EQUAL(inpool.intern("chrX"), 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(external_test)
+{
+    // "chr1", "bam", "chrX" stored elsewhere
+    auto storage = std::make_shared<std::string>("chr1bamchrX");
+    std::uint64_t offsets[] = { 0, 4, 7, 11 };
+    StringPool extpool(storage, storage->data(), offsets, 3);
+    BOOST_CHECK_EQUAL(extpool.size(), 3);
+    BOOST_CHECK_EQUAL(extpool[1], "bam");
+    BOOST_CHECK_EQUAL(extpool[2].data(), storage->data() + 7);
+    
+    // interning looks up the external strings, which are not moved
+    BOOST_CHECK_EQUAL(extpool.intern("chrX"), 2);
+    BOOST_CHECK_EQUAL(extpool.intern("chr2"), 3);
+    BOOST_CHECK_EQUAL(extpool[0].data(), storage->data());
+    BOOST_CHECK_EQUAL(extpool[3], "chr2");
+    
+    // copies own their strings
+    const StringPool unindexed(storage, storage->data(), offsets, 3);
+    StringPool other(unindexed);
+    BOOST_CHECK_EQUAL(other.size(), 3);
+    BOOST_CHECK_EQUAL(other[0], "chr1");
+    BOOST_CHECK(other[0].data() != storage->data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
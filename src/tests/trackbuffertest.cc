@@ -0,0 +1,141 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE trackbuffertest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/trackbuffer.hh"
+#include "multovl/io/textio.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Standard headers --
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// converts the contents of /track/ to strings, one per region
+static std::vector<std::string> track_tostr(const io::TrackBuffer& track)
+{
+    std::vector<std::string> strs;
+    track.for_each([&strs](std::string_view chrom, const BaseRegion& reg) {
+        std::ostringstream oss;
+        oss << chrom << ':' << reg.first() << '-' << reg.last() << reg.strand() << reg.name();
+        strs.push_back(oss.str());
+    });
+    return strs;
+}
+
+BOOST_AUTO_TEST_CASE(add_test)
+{
+    io::TrackBuffer track;
+    BOOST_CHECK(track.empty());
+    track.add("chr1", BaseRegion(10, 20, '+', "a"));
+    track.add("chr2", BaseRegion(30, 40, '-', ""));
+    track.add("chr1", BaseRegion(5, 8, '.', "a long region name that does not fit"));
+    BOOST_CHECK_EQUAL(track.size(), 3);
+    
+    std::vector<std::string> exp{"chr1:10-20+a", "chr2:30-40-", 
+        "chr1:5-8.a long region name that does not fit"};
+    std::vector<std::string> strs = track_tostr(track);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+    
+    track.clear();
+    BOOST_CHECK(track.empty());
+}
+
+BOOST_AUTO_TEST_CASE(append_test)
+{
+    io::TrackBuffer track, other, empty;
+    track.add("chr1", BaseRegion(10, 20, '+', "a"));
+    other.add("chr2", BaseRegion(30, 40, '-', "b"));
+    other.add("chr1", BaseRegion(50, 60, '+', "c"));
+    track.append(std::move(other));
+    BOOST_CHECK(other.empty());
+    track.append(std::move(empty));
+    track.add("chr3", BaseRegion(70, 80, '+', "d"));   // goes to the end
+    
+    std::vector<std::string> exp{"chr1:10-20+a", "chr2:30-40-b", "chr1:50-60+c", "chr3:70-80+d"};
+    std::vector<std::string> strs = track_tostr(track);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+}
+
+// Large enough input to be split into chunks, with bad lines here and there
+BOOST_AUTO_TEST_CASE(chunked_read_test)
+{
+    const unsigned int LINECNT = 600000;
+    Tempfile tempfile;
+    {
+        std::ofstream outf(tempfile.name());
+        outf << "# a comment\n";
+        for (unsigned int i = 2; i <= LINECNT; ++i)
+        {
+            if (i % 100000 == 0)
+                outf << "chr1\tbad\t" << i << '\n';
+            else
+                outf << "chr" << (i % 3 + 1) << '\t' << i << '\t' << i + 100 
+                    << "\tname" << i << "\t0\t+\n";
+        }
+        outf << "chrX\t1\t2";   // no newline at the end
+    }
+    std::string fname = std::filesystem::path(tempfile.name()).string();
+    
+    io::TrackBuffer serial, parallel;
+    io::TextReader serialreader(fname, io::Fileformat::BED);
+    unsigned int serialproblems = serialreader.read_all(serial, 1);
+    io::TextReader parallelreader(fname, io::Fileformat::BED);
+    unsigned int parallelproblems = parallelreader.read_all(parallel, 4);
+    
+    BOOST_CHECK_EQUAL(serialproblems, LINECNT / 100000);
+    BOOST_CHECK_EQUAL(parallelproblems, serialproblems);
+    BOOST_CHECK_EQUAL(serial.size(), LINECNT - 1 - serialproblems + 1);
+    std::vector<std::string> serialstrs = track_tostr(serial), parallelstrs = track_tostr(parallel);
+    BOOST_CHECK(serialstrs == parallelstrs);
+    
+    // same errors with the same line numbers
+    std::ostringstream serialerrs, parallelerrs;
+    serialreader.errors().print(serialerrs);
+    parallelreader.errors().print(parallelerrs);
+    BOOST_CHECK_EQUAL(serialerrs.str(), parallelerrs.str());
+    BOOST_CHECK(serialerrs.str().find("At line 500000:") != std::string::npos);
+    
+    // nothing left to read
+    std::string chrom;
+    BaseRegion reg;
+    BOOST_CHECK_EQUAL(parallelreader.read_into(chrom, reg), "EOF");
+}
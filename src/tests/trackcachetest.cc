@@ -0,0 +1,196 @@
+/* <LICENSE>
+License for the MULTOVL multiple genomic overlap tools
+
+Copyright (c) 2007-2012, Dr Andras Aszodi, 
+Campus Science Support Facilities GmbH (CSF),
+Dr-Bohr-Gasse 3, A-1030 Vienna, Austria, Europe.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of the Campus Science Support Facilities GmbH
+      nor the names of its contributors may be used to endorse
+      or promote products derived from this software without specific prior
+      written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS
+AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+</LICENSE> */
+#define BOOST_TEST_MODULE trackcachetest
+#include "boost/test/unit_test.hpp"
+
+// -- Own headers --
+
+#include "multovl/io/trackcache.hh"
+#include "multovl/io/binio.hh"
+#include "multovl/io/fileio.hh"
+using namespace multovl;
+#include "tempfile.hh"  // temporary file utility
+
+// -- Standard headers --
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// converts the contents of /track/ to strings, one per region
+static std::vector<std::string> track_tostr(const io::TrackBuffer& track)
+{
+    std::vector<std::string> strs;
+    track.for_each([&strs](std::string_view chrom, const BaseRegion& reg) {
+        std::ostringstream oss;
+        oss << chrom << ':' << reg.first() << '-' << reg.last() << reg.strand() << reg.name();
+        strs.push_back(oss.str());
+    });
+    return strs;
+}
+
+struct TrackCacheFixture
+{
+    TrackCacheFixture(): 
+        tempfile(), fname(fs::path(tempfile.name()).string()),
+        cachedir((fs::temp_directory_path() / 
+            ("multovlcache" + std::to_string(std::random_device()()))).string())
+    {
+        write_bed("chr1\t100\t200\ta\t0\t+\nchr2\t10\t20\tb\t0\t-\nchr1\t50\t60\tc\t0\t+\n");
+    }
+    
+    ~TrackCacheFixture()
+    {
+        std::error_code ec;
+        fs::remove_all(cachedir, ec);
+    }
+    
+    void write_bed(const std::string& contents)
+    {
+        std::ofstream out(fname);
+        out << contents;
+    }
+    
+    // reads /fname/ through the cache
+    std::vector<std::string> read_cached(bool readall)
+    {
+        io::FileReader reader(fname, io::Fileformat::BED, cachedir);
+        BOOST_CHECK(reader.errors().ok());
+        io::TrackBuffer track;
+        if (readall)
+        {
+            reader.read_all(track, 2);
+        }
+        else
+        {
+            std::string chrom;
+            BaseRegion reg;
+            while (reader.read_into(chrom, reg) && !reader.finished())
+                track.add(chrom, reg);
+        }
+        return track_tostr(track);
+    }
+    
+    Tempfile tempfile;
+    std::string fname, cachedir;
+    
+    // grouped by chromosome as they come from the cache
+    const std::vector<std::string> exp{
+        "chr1:100-200+a", "chr1:50-60+c", "chr2:10-20-b"
+    };
+};
+
+BOOST_FIXTURE_TEST_SUITE(trackcachesuite, TrackCacheFixture)
+
+BOOST_AUTO_TEST_CASE(entry_test)
+{
+    std::string entry = io::cache_entry(cachedir, fname);
+    BOOST_CHECK_EQUAL(fs::path(entry).parent_path().string(), cachedir);
+    BOOST_CHECK_EQUAL(fs::path(entry).extension().string(), ".mtb");
+    BOOST_CHECK_EQUAL(io::cache_entry(cachedir, fname), entry);
+    BOOST_CHECK_EQUAL(io::cache_entry(cachedir, fname + ".nonexistent"), "");
+    
+    // any change of the contents changes the entry
+    std::uint64_t hash = io::content_hash(fname);
+    write_bed("chr1\t100\t200\ta\t0\t+\nchr2\t10\t20\tb\t0\t-\nchr1\t50\t60\td\t0\t+\n");
+    BOOST_CHECK(io::content_hash(fname) != hash);
+    BOOST_CHECK(io::cache_entry(cachedir, fname) != entry);
+}
+
+BOOST_AUTO_TEST_CASE(store_reuse_test)
+{
+    for (bool readall : { false, true })
+    {
+        std::error_code ec;
+        fs::remove_all(cachedir, ec);
+        std::string entry = io::cache_entry(cachedir, fname);
+        
+        // the first read stores the entry, the order of the regions is kept
+        std::vector<std::string> strs = read_cached(readall);
+        BOOST_CHECK_EQUAL(strs.size(), 3);
+        BOOST_CHECK_EQUAL(strs[1], "chr2:10-20-b");
+        BOOST_REQUIRE(fs::exists(entry));
+        
+        // the second read comes from the entry: replace it to make sure
+        io::BinaryWriter writer;
+        writer.add("chrX", BaseRegion(1, 2, '+', "cached"));
+        BOOST_REQUIRE(io::store_cache_entry(writer, entry));
+        strs = read_cached(readall);
+        BOOST_REQUIRE_EQUAL(strs.size(), 1);
+        BOOST_CHECK_EQUAL(strs[0], "chrX:1-2+cached");
+    }
+    
+    // the regions of a proper entry are grouped by chromosome
+    std::error_code ec;
+    fs::remove_all(cachedir, ec);
+    read_cached(true);
+    std::vector<std::string> strs = read_cached(false);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.end());
+}
+
+BOOST_AUTO_TEST_CASE(restrict_test)
+{
+    // the entry holds all chromosomes even if only some of them were wanted
+    {
+        io::FileReader reader(fname, io::Fileformat::BED, cachedir);
+        reader.restrict_chroms({"chr2"});
+        io::TrackBuffer track;
+        reader.read_all(track);
+        BOOST_CHECK_EQUAL(track.size(), 1);
+    }
+    io::FileReader reader(fname, io::Fileformat::BED, cachedir);
+    reader.restrict_chroms({"chr1"});
+    io::TrackBuffer track;
+    reader.read_all(track);
+    std::vector<std::string> strs = track_tostr(track);
+    BOOST_CHECK_EQUAL_COLLECTIONS(strs.begin(), strs.end(), exp.begin(), exp.begin() + 2);
+}
+
+BOOST_AUTO_TEST_CASE(problem_test)
+{
+    // files with problems are not cached
+    write_bed("chr1\t100\t200\ta\t0\t+\nchr2\tbad\t20\tb\t0\t-\n");
+    io::FileReader reader(fname, io::Fileformat::BED, cachedir);
+    io::TrackBuffer track;
+    BOOST_CHECK_EQUAL(reader.read_all(track), 1);
+    BOOST_CHECK(!fs::exists(io::cache_entry(cachedir, fname)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
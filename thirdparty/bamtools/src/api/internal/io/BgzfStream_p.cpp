@@ -31,7 +31,7 @@ using namespace std;
 //
 unsigned short unpack_ushort(const char* buffer) {
     char buf[2];
-    strncpy(buf, buffer, 2);
+    memcpy(buf, buffer, 2);   // FIX: strncpy stopped at a zero low byte
     if (BamTools::SystemIsBigEndian()) {
         BamTools::SwapEndian_16p(buf);
     }